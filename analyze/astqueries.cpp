@@ -1,6 +1,7 @@
 #include "astqueries.hpp"
 #include "ast/ast.hpp"
 #include <algorithm>
+#include <unordered_set>
 
 bool isExternalIdentifier(Identifier& node)
 {
@@ -83,6 +84,152 @@ bool isFunctionNode(AstNode &node)
             || type == AstNodeType::ObjectMethod;
 }
 
+std::vector<AstNode*> findFunctionNodes(AstRoot& root)
+{
+    return root.getNodesOfTypes({AstNodeType::ArrowFunctionExpression, AstNodeType::FunctionExpression, AstNodeType::FunctionDeclaration,
+                                 AstNodeType::ClassMethod, AstNodeType::ClassPrivateMethod, AstNodeType::ObjectMethod});
+}
+
+std::vector<std::string> findModuleRequests(AstRoot& root)
+{
+    std::vector<std::string> requests;
+    for (AstNode* node : root.getNodesOfTypes({AstNodeType::ImportDeclaration, AstNodeType::ExportNamedDeclaration, AstNodeType::ExportAllDeclaration})) {
+        if (node->getType() == AstNodeType::ImportDeclaration) {
+            auto import = (ImportDeclaration*)node;
+            if (import->getKind() == ImportDeclaration::Kind::Value)
+                requests.push_back(import->getSource());
+        } else if (node->getType() == AstNodeType::ExportNamedDeclaration) {
+            auto exportNode = (ExportNamedDeclaration*)node;
+            if (exportNode->getKind() == ExportNamedDeclaration::Kind::Value && exportNode->getSource())
+                requests.push_back(((StringLiteral*)exportNode->getSource())->getValue());
+        } else {
+            requests.push_back(((ExportAllDeclaration*)node)->getSource());
+        }
+    }
+    return requests;
+}
+
+static bool isIdentifierNamed(AstNode* node, const char* name)
+{
+    return node->getType() == AstNodeType::Identifier && ((Identifier*)node)->getName() == name;
+}
+
+// Works for obj.name and obj["name"]
+static bool getStaticPropertyName(MemberExpression& member, std::string& name)
+{
+    AstNode* property = member.getProperty();
+    if (!member.isComputed() && property->getType() == AstNodeType::Identifier)
+        name = ((Identifier*)property)->getName();
+    else if (member.isComputed() && property->getType() == AstNodeType::StringLiteral)
+        name = ((StringLiteral*)property)->getValue();
+    else
+        return false;
+    return true;
+}
+
+static bool isModuleExports(AstNode* node)
+{
+    if (node->getType() != AstNodeType::MemberExpression)
+        return false;
+    auto& member = (MemberExpression&)*node;
+    std::string name;
+    return isIdentifierNamed(member.getObject(), "module") && getStaticPropertyName(member, name) && name == "exports";
+}
+
+// True if the identifier only names a property, so it can't be a reference to module or exports
+static bool isPropertyName(Identifier& node)
+{
+    auto parent = node.getParent();
+    if (parent->getType() == AstNodeType::MemberExpression)
+        return !((MemberExpression*)parent)->isComputed() && ((MemberExpression*)parent)->getProperty() == &node;
+    if (parent->getType() == AstNodeType::ObjectProperty && ((ObjectProperty*)parent)->isShorthand())
+        return false;
+    if (parent->getType() == AstNodeType::ObjectMethod)
+        return !((ObjectMethod*)parent)->isComputed() && ((ObjectMethod*)parent)->getKey() == &node;
+    return isUnscopedPropertyOrMethodIdentifier(node);
+}
+
+static bool findCommonJsExportsInto(AstRoot& root, std::vector<std::string>& names)
+{
+    std::unordered_set<AstNode*> understoodUses; //< Identifiers of the assignments we understand
+    bool exportsIsModuleExports = true; //< Assigning module.exports leaves exports pointing to the old object
+
+    auto addName = [&](const std::string& name) {
+        if (find(names.begin(), names.end(), name) == names.end())
+            names.push_back(name);
+    };
+
+    for (AstNode* statement : root.getBody()) {
+        if (statement->getType() != AstNodeType::ExpressionStatement)
+            continue;
+        AstNode* expression = ((ExpressionStatement*)statement)->getExpression();
+        if (expression->getType() != AstNodeType::AssignmentExpression)
+            continue;
+        auto& assignment = (AssignmentExpression&)*expression;
+        if (assignment.getOperator() != AssignmentExpression::Operator::Equal)
+            continue;
+        AstNode* left = assignment.getLeft();
+
+        if (isModuleExports(left)) {
+            // Anything but an object literal with plain keys could have any properties
+            AstNode* right = assignment.getRight();
+            if (right->getType() != AstNodeType::ObjectExpression)
+                return false;
+            names.clear();
+            for (AstNode* prop : ((ObjectExpression*)right)->getProperties()) {
+                AstNode* key;
+                if (prop->getType() == AstNodeType::ObjectProperty && !((ObjectProperty*)prop)->isComputed())
+                    key = ((ObjectProperty*)prop)->getKey();
+                else if (prop->getType() == AstNodeType::ObjectMethod && !((ObjectMethod*)prop)->isComputed())
+                    key = ((ObjectMethod*)prop)->getKey();
+                else
+                    return false;
+
+                if (key->getType() == AstNodeType::Identifier)
+                    addName(((Identifier*)key)->getName());
+                else if (key->getType() == AstNodeType::StringLiteral)
+                    addName(((StringLiteral*)key)->getValue());
+                else
+                    return false;
+            }
+            understoodUses.insert(((MemberExpression*)left)->getObject());
+            exportsIsModuleExports = false;
+        } else if (left->getType() == AstNodeType::MemberExpression) {
+            auto& member = (MemberExpression&)*left;
+            std::string name;
+            if (!getStaticPropertyName(member, name))
+                continue;
+            AstNode* object = member.getObject();
+            if (isModuleExports(object)) {
+                addName(name);
+                understoodUses.insert(((MemberExpression*)object)->getObject());
+            } else if (isIdentifierNamed(object, "exports")) {
+                if (exportsIsModuleExports)
+                    addName(name);
+                understoodUses.insert(object);
+            }
+        }
+    }
+
+    // Any other use, like passing exports to a function or assigning it in a branch, could export names we don't know
+    for (AstNode* node : root.getNodesOfType(AstNodeType::Identifier)) {
+        auto& identifier = (Identifier&)*node;
+        if ((identifier.getName() == "module" || identifier.getName() == "exports")
+                && !understoodUses.count(node) && !isPropertyName(identifier))
+            return false;
+    }
+    return true;
+}
+
+bool findCommonJsExports(AstRoot& root, std::vector<std::string>& names)
+{
+    names.clear();
+    if (findCommonJsExportsInto(root, names))
+        return true;
+    names.clear();
+    return false;
+}
+
 bool isLexicalScopeNode(AstNode &node)
 {
     if (isFunctionNode(node))
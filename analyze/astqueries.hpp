@@ -1,7 +1,11 @@
 #ifndef ASTQUERIES_HPP
 #define ASTQUERIES_HPP
 
+#include <vector>
+#include <string>
+
 class AstNode;
+class AstRoot;
 class Identifier;
 
 // True if this identifier is not a local declaration, but refers to an exported or imported name
@@ -23,6 +27,16 @@ bool isFunctionParameterIdentifier(Identifier& node);
 // True if the node is a Function&
 bool isFunctionNode(AstNode& node);
 
+// Every Function node of the tree, in source order
+std::vector<AstNode*> findFunctionNodes(AstRoot& root);
+
+// Sources of the imports and re-exports that V8 would report as module requests (so not Flow type imports), in source order
+std::vector<std::string> findModuleRequests(AstRoot& root);
+
+// Names a CommonJS module exports through top-level module.exports = {...}, module.exports.x = and exports.x = assignments.
+// Returns false with no names if the AST uses module or exports in any other way, then only running the module can tell.
+bool findCommonJsExports(AstRoot& root, std::vector<std::string>& names);
+
 // True if the node introduces a new lexical scope
 bool isLexicalScopeNode(AstNode& node);
 
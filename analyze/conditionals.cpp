@@ -1,7 +1,6 @@
 #include "conditionals.hpp"
 #include "module/module.hpp"
 #include "ast/ast.hpp"
-#include "ast/walk.hpp"
 #include "utils/reporting.hpp"
 #include <unordered_map>
 #include <string>
@@ -17,60 +16,47 @@ void analyzeConditionals(Module &module)
 void findEmptyBodyConditionals(Module &module)
 {
     AstRoot& ast = module.getAst();
-    walkAst(ast, [&](AstNode& node){
-        if (node.getType() == AstNodeType::IfStatement) {
-            auto& conditional = (IfStatement&)node;
-            if (conditional.getConsequent()->getType() != AstNodeType::EmptyStatement)
-                return;
-        } else if (node.getType() == AstNodeType::WhileStatement) {
-            auto& conditional = (WhileStatement&)node;
-            if (conditional.getBody()->getType() != AstNodeType::EmptyStatement)
-                return;
-        } else if (node.getType() == AstNodeType::DoWhileStatement) {
-            auto& conditional = (DoWhileStatement&)node;
-            if (conditional.getBody()->getType() != AstNodeType::EmptyStatement)
-                return;
-        } else if (node.getType() == AstNodeType::ForStatement) {
-            auto& conditional = (ForStatement&)node;
-            if (conditional.getBody()->getType() != AstNodeType::EmptyStatement)
-                return;
-        } else if (node.getType() == AstNodeType::ForInStatement) {
-            auto& conditional = (ForInStatement&)node;
-            if (conditional.getBody()->getType() != AstNodeType::EmptyStatement)
-                return;
-        } else if (node.getType() == AstNodeType::ForOfStatement) {
-            auto& conditional = (ForOfStatement&)node;
-            if (conditional.getBody()->getType() != AstNodeType::EmptyStatement)
-                return;
-        } else {
-            return;
-        }
+    auto conditionals = ast.getNodesOfTypes({AstNodeType::IfStatement, AstNodeType::WhileStatement, AstNodeType::DoWhileStatement,
+                                             AstNodeType::ForStatement, AstNodeType::ForInStatement, AstNodeType::ForOfStatement});
+    for (AstNode* node : conditionals) {
+        AstNode* body;
+        if (node->getType() == AstNodeType::IfStatement)
+            body = ((IfStatement*)node)->getConsequent();
+        else if (node->getType() == AstNodeType::WhileStatement)
+            body = ((WhileStatement*)node)->getBody();
+        else if (node->getType() == AstNodeType::DoWhileStatement)
+            body = ((DoWhileStatement*)node)->getBody();
+        else if (node->getType() == AstNodeType::ForStatement)
+            body = ((ForStatement*)node)->getBody();
+        else if (node->getType() == AstNodeType::ForInStatement)
+            body = ((ForInStatement*)node)->getBody();
+        else
+            body = ((ForOfStatement*)node)->getBody();
 
-        warn(node, "Suspicious semicolon after conditional"s);
-    });
+        if (body->getType() == AstNodeType::EmptyStatement)
+            warn(*node, "Suspicious semicolon after conditional"s);
+    }
 }
 
 void findDuplicateIfTests(Module &module)
 {
     AstRoot& ast = module.getAst();
     const std::string &source = module.getOriginalSource();
-    walkAst(ast, [&](AstNode& node){
-        if (node.getType() != AstNodeType::IfStatement)
-            return;
+    for (AstNode* node : ast.getNodesOfType(AstNodeType::IfStatement)) {
         // We do all the children once from the parent, so don't process them again
-        if (node.getParent()->getType() == AstNodeType::IfStatement && ((IfStatement*)node.getParent())->getAlternate() == &node)
-            return;
+        if (node->getParent()->getType() == AstNodeType::IfStatement && ((IfStatement*)node->getParent())->getAlternate() == node)
+            continue;
 
         // We're trying to catch copy-paste errors, so it's probably fine (and faster!) to compare the source text directly!
         unordered_map<string, AstNode*> tests;
-        AstNode* cur = &node;
+        AstNode* cur = node;
         while (cur && cur->getType() == AstNodeType::IfStatement) {
             auto* conditional = (IfStatement*)cur;
             string testSource =  conditional->getTest()->getLocation().toString(source);
             auto result = tests.insert({testSource, conditional});
             if (!result.second)
-                error(*conditional, "Duplicate if condition, previously appears on line "+to_string(tests[testSource]->getLocation().start.line));
+                error(*conditional, "Duplicate if condition, previously appears on line "+to_string(tests[testSource]->getStartPosition().line));
             cur = conditional->getAlternate();
         }
-    });
+    }
 }
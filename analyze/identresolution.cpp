@@ -67,7 +67,7 @@ static bool isExportedTypeIdentifier(Identifier& id)
     return exportDecl->getKind() == ExportNamedDeclaration::Kind::Type;
 }
 
-static void walkImportDeclarations(vector<Identifier*>& lexicalDeclarations, unordered_map<string, Identifier*>& typeDeclarations, ImportDeclaration& node)
+static void walkImportDeclarations(vector<Identifier*>& lexicalDeclarations, unordered_map<Atom, Identifier*>& typeDeclarations, ImportDeclaration& node)
 {
     bool isDeclTypeImport = node.getKind() == ImportDeclaration::Kind::Type;
     for (auto specifier : node.getSpecifiers()) {
@@ -76,19 +76,19 @@ static void walkImportDeclarations(vector<Identifier*>& lexicalDeclarations, uno
                || specifier->getType() == AstNodeType::ImportNamespaceSpecifier);
         auto spec = (ImportBaseSpecifier*)specifier;
         if (spec->isTypeImport() || isDeclTypeImport)
-            typeDeclarations[spec->getLocal()->getName()] = spec->getLocal();
+            typeDeclarations[spec->getLocal()->getAtom()] = spec->getLocal();
         else
             lexicalDeclarations.push_back(spec->getLocal());
     }
 }
 
-static void walkTypeParameterDeclarations(unordered_map<string, Identifier*>& typeDeclarations, TypeParameterDeclaration* node)
+static void walkTypeParameterDeclarations(unordered_map<Atom, Identifier*>& typeDeclarations, TypeParameterDeclaration* node)
 {
     if (!node)
         return;
     const auto& params = node->getParams();
     for (auto param : params)
-        typeDeclarations[param->getName()->getName()] = param->getName();
+        typeDeclarations[param->getName()->getAtom()] = param->getName();
 }
 
 static void walkComplexDeclaration(vector<Identifier*>& declarationsFound, AstNode& node)
@@ -143,10 +143,10 @@ static void walkComplexDeclaration(vector<Identifier*>& varDeclarations, vector<
 }
 
 static void walkChildrenForDeclarations(unordered_map<Identifier*, Identifier*>& identifierTargets,
-                                        unordered_map<string, Identifier*>& typeDeclarations,
+                                        unordered_map<Atom, Identifier*>& typeDeclarations,
                                         vector<Identifier*>& varDeclarations,
                                         vector<Identifier*>& lexicalDeclarations,
-                                        unordered_map<string, Identifier*>& functionDeclarations,
+                                        unordered_map<Atom, Identifier*>& functionDeclarations,
                                         LexicalBindings& bindings, AstNode& parent)
 {
     parent.applyChildren([&](AstNode* node) {
@@ -154,7 +154,7 @@ static void walkChildrenForDeclarations(unordered_map<Identifier*, Identifier*>&
         if (type == AstNodeType::FunctionDeclaration) {
             auto fun = (Function*)node;
             if (auto id = fun->getId())
-                functionDeclarations[id->getName()] = id;
+                functionDeclarations[id->getAtom()] = id;
         } else if (type == AstNodeType::ClassDeclaration) {
             auto decl = (ClassDeclaration*)node;
             lexicalDeclarations.push_back(decl->getId());
@@ -162,10 +162,10 @@ static void walkChildrenForDeclarations(unordered_map<Identifier*, Identifier*>&
             walkComplexDeclaration(varDeclarations, lexicalDeclarations, node);
         } else if (type == AstNodeType::TypeAlias) {
             auto decl = (TypeAlias*)node;
-            typeDeclarations[decl->getId()->getName()] = decl->getId();
+            typeDeclarations[decl->getId()->getAtom()] = decl->getId();
         } else if (type == AstNodeType::InterfaceDeclaration) {
             auto decl = (InterfaceDeclaration*)node;
-            typeDeclarations[decl->getId()->getName()] = decl->getId();
+            typeDeclarations[decl->getId()->getAtom()] = decl->getId();
         } else if (type == AstNodeType::ImportDeclaration) {
             walkImportDeclarations(lexicalDeclarations, typeDeclarations, *(ImportDeclaration*)node);
         }
@@ -225,7 +225,7 @@ static void instantiateScopeDeclarations(unordered_map<Identifier*, Identifier*>
                                          const vector<Identifier*>& mergeVarsWithParentFunParams)
 {
     vector<Identifier*> varDeclarations, lexicalDeclarations;
-    unordered_map<string, Identifier*> functionDeclarations;
+    unordered_map<Atom, Identifier*> functionDeclarations;
 
     instantiateScopeNodeInnerDeclaration(varDeclarations, lexicalDeclarations, bindings);
 
@@ -268,16 +268,16 @@ static void instantiateScopeDeclarations(unordered_map<Identifier*, Identifier*>
     }
 
     for (Identifier* id : varDeclarations) {
-        bindings.varDeclarations[id->getName()] = id;
+        bindings.varDeclarations[id->getAtom()] = id;
         identifierTargets[id] = id;
     }
     // Note that if we are an actual full scope (e.g. an ArrowFunction in an ArrowFunction), this doesn't apply (we don't share anything with our parent fun)
     if (isPartialScopeNodeType(bindings.code->getType())) {
         for (auto paramId : mergeVarsWithParentFunParams)
-            bindings.varDeclarations.erase(paramId->getName()); // Don't re-declare, share the parent's bindings
+            bindings.varDeclarations.erase(paramId->getAtom()); // Don't re-declare, share the parent's bindings
     }
     for (Identifier* id : lexicalDeclarations) {
-        bindings.localDeclarations[id->getName()] = id;
+        bindings.localDeclarations[id->getAtom()] = id;
         identifierTargets[id] = id;
     }
     for (auto& [name, id] : functionDeclarations) {
@@ -289,7 +289,7 @@ static void instantiateScopeDeclarations(unordered_map<Identifier*, Identifier*>
     }
 }
 
-static Identifier* findDeclarationBinding(const LexicalBindings& bindings, const std::string& name, bool isType = false)
+static Identifier* findDeclarationBinding(const LexicalBindings& bindings, Atom name, bool isType = false)
 {
     for (const LexicalBindings* scope = &bindings; scope; scope = scope->parent) {
         if (isType) {
@@ -304,7 +304,7 @@ static Identifier* findDeclarationBinding(const LexicalBindings& bindings, const
 }
 
 static void walkScopeIdentifiers(unordered_map<Identifier*, Identifier*>& identifierTargets,
-                                    unordered_map<string, Identifier*>& unresolvedTopLevelIdentifiers,
+                                    unordered_map<Atom, Identifier*>& unresolvedTopLevelIdentifiers,
                                     const LexicalBindings& bindings, AstNode* node)
 {
     auto type = node->getType();
@@ -320,7 +320,7 @@ static void walkScopeIdentifiers(unordered_map<Identifier*, Identifier*>& identi
                 || identifier->getParent()->getType() == AstNodeType::ClassImplements;
         if (auto it = identifierTargets.find(identifier); it != identifierTargets.end())
             return;
-        const auto& name = identifier->getName();
+        Atom name = identifier->getAtom();
         if (auto decl = findDeclarationBinding(bindings, name, isType))
             identifierTargets[identifier] = decl;
         else if (!bindings.parent)
@@ -349,7 +349,7 @@ static void walkScopeIdentifiers(unordered_map<Identifier*, Identifier*>& identi
 }
 
 static void resolveScopeIdentifiers(unordered_map<Identifier*, Identifier*>& identifierTargets,
-                                    unordered_map<string, Identifier*>& unresolvedTopLevelIdentifiers,
+                                    unordered_map<Atom, Identifier*>& unresolvedTopLevelIdentifiers,
                                     const LexicalBindings& bindings)
 {
     for (auto const& childScope : bindings.children)
@@ -380,7 +380,7 @@ IdentifierResolutionResult resolveModuleIdentifiers(v8::Local<v8::Context> conte
 {
     auto rootBindings = make_unique<LexicalBindings>(nullptr, &ast, true);
     unordered_map<Identifier*, Identifier*> identifierTargets;
-    unordered_map<string, Identifier*> unresolvedTopLevelIdentifiers;
+    unordered_map<Atom, Identifier*> unresolvedTopLevelIdentifiers;
 
     instantiateScopeDeclarations(identifierTargets, *rootBindings);
     resolveScopeIdentifiers(identifierTargets, unresolvedTopLevelIdentifiers, *rootBindings);
@@ -394,13 +394,13 @@ IdentifierResolutionResult resolveModuleIdentifiers(v8::Local<v8::Context> conte
     Local<Object> global = context->Global();
     std::vector<std::string> missingGlobalIdentifiers;
     for (auto elem : unresolvedTopLevelIdentifiers) {
-        auto name = elem.first;
+        const string& name = elem.first.str();
         Local<String> nameStr = String::NewFromUtf8(isolate, name.c_str());
 
         if (global->Has(context, nameStr).FromJust())
             continue;
 
-        missingGlobalIdentifiers.push_back(std::move(name));
+        missingGlobalIdentifiers.push_back(name);
     }
 
     return {move(identifierTargets), move(missingGlobalIdentifiers), move(rootBindings)};
@@ -441,7 +441,8 @@ AstNode *resolveImportedIdentifierDeclaration(AstNode &importSpec)
     // TODO: Make some attempt at resolving exported identifiers of non-ES6 modules (maybe fill the root scope dynamically at import time)
 
     Module& sourceMod = importSpec.getParentModule();
-    string source, importSpecName;
+    string source;
+    Atom importSpecName;
     bool isType = false;
 
     if (importSpec.getType() == AstNodeType::ExportSpecifier) {
@@ -449,13 +450,13 @@ AstNode *resolveImportedIdentifierDeclaration(AstNode &importSpec)
         auto sourceLiteral = (StringLiteral*)exportDeclNode->getSource();
         assert(sourceLiteral);
         source = sourceLiteral->getValue();
-        importSpecName = ((ExportSpecifier&)importSpec).getLocal()->getName();
+        importSpecName = ((ExportSpecifier&)importSpec).getLocal()->getAtom();
     } else {
         assert(importSpec.getParent()->getType() == AstNodeType::ImportDeclaration);
         auto importDeclNode = (ImportDeclaration*)importSpec.getParent();
         source = importDeclNode->getSource();
         if (importSpec.getType() == AstNodeType::ImportSpecifier) {
-            importSpecName = ((ImportSpecifier&)importSpec).getImported()->getName();
+            importSpecName = ((ImportSpecifier&)importSpec).getImported()->getAtom();
             if (((ImportSpecifier&)importSpec).isTypeImport())
                 isType = true;
             else if (((ImportDeclaration*)importSpec.getParent())->getKind() == ImportDeclaration::Kind::Type)
@@ -485,7 +486,7 @@ AstNode *resolveImportedIdentifierDeclaration(AstNode &importSpec)
 
     walkAst(importedMod.getAst(), [&](AstNode& node) {
         auto& specifier = (ExportSpecifier&)node;
-        if (specifier.getExported()->getName() == importSpecName)
+        if (specifier.getExported()->getAtom() == importSpecName)
             exported = specifier.getLocal();
     }, [&](AstNode& node) {
         if (node.getType() == AstNodeType::ExportSpecifier)
@@ -556,7 +557,7 @@ AstNode *resolveMemberExpression(MemberExpression &expr)
     if (expr.getProperty()->getType() != AstNodeType::Identifier)
         return nullptr;
 
-    auto propName = ((Identifier*)expr.getProperty())->getName();
+    Atom propName = ((Identifier*)expr.getProperty())->getAtom();
     AstNode* targetScope = resolveThisExpression((ThisExpression&)*expr.getObject());
     if (!targetScope)
         return nullptr;
@@ -568,11 +569,11 @@ AstNode *resolveMemberExpression(MemberExpression &expr)
         for (auto node : body) {
             if (node->getType() == AstNodeType::ClassMethod || node->getType() == AstNodeType::ClassPrivateMethod) {
                 auto member = (ClassBaseMethod*)node;
-                if (!member->isComputed() && ((Identifier*)member->getKey())->getName() == propName)
+                if (!member->isComputed() && ((Identifier*)member->getKey())->getAtom() == propName)
                     return member;
             } else if (node->getType() == AstNodeType::ClassProperty || node->getType() == AstNodeType::ClassPrivateProperty) {
                 auto member = (ClassBaseProperty*)node;
-                if (!member->isComputed() && ((Identifier*)member->getKey())->getName() == propName)
+                if (!member->isComputed() && ((Identifier*)member->getKey())->getAtom() == propName)
                     return member;
             }
         }
@@ -1,6 +1,7 @@
 #ifndef IDENTRESOLUTION_HPP
 #define IDENTRESOLUTION_HPP
 
+#include "utils/atom.hpp"
 #include <unordered_map>
 #include <vector>
 #include <string>
@@ -22,9 +23,9 @@ struct LexicalBindings {
     // If this node introduces one of our children scope we return that scope, otherwise keeps the current scope
     const LexicalBindings& scopeForChildNode(AstNode* node) const;
 
-    std::unordered_map<std::string, Identifier*> typeDeclarations;
-    std::unordered_map<std::string, Identifier*> localDeclarations;
-    std::unordered_map<std::string, Identifier*>& varDeclarations;
+    std::unordered_map<Atom, Identifier*> typeDeclarations;
+    std::unordered_map<Atom, Identifier*> localDeclarations;
+    std::unordered_map<Atom, Identifier*>& varDeclarations;
     std::vector<std::unique_ptr<LexicalBindings>> children;
     LexicalBindings* parent;
     AstNode* code;
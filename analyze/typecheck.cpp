@@ -1,6 +1,5 @@
 #include "typecheck.hpp"
 #include "ast/ast.hpp"
-#include "ast/walk.hpp"
 #include "analyze/astqueries.hpp"
 #include "analyze/identresolution.hpp"
 #include "analyze/typerefinement.hpp"
@@ -79,7 +78,7 @@ static void checkCallNode(Graph& graph, GraphNode* node, ScopedTypes const& scop
     size_t args = std::min(calleeArgCount, nodeInputArgs);
     if (nodeInputArgs > calleeArgCount && !calleeType->variadic)
         warn(callAstNode, "Function only takes "+to_string(calleeArgCount)+" arguments, but "+to_string(nodeInputArgs)+" were provided");
-    for (uint16_t i=0; i<args; ++i) {
+    for (size_t i=0; i<args; ++i) {
         GraphNode* argNode = &graph.getNode(node->getInput(i+1));
         TypeInfo argBaseType = resolveScopedNodeType(graph, argNode, scope);
         checkTypesCompatibility(*callAstNode.getArguments()[i], argBaseType, calleeType->argumentTypes[i]);
@@ -216,7 +215,7 @@ static void runTypechecksInBranch(Graph& graph, unordered_map<GraphNode*, Scoped
             }
         } else {
             unordered_set<GraphNode*> nextScopesToVisit;
-            for (uint16_t i=0; i<node->nextCount(); ++i)
+            for (size_t i=0; i<node->nextCount(); ++i)
                 nextScopesToVisit.insert(&graph.getNode(node->getNext(i)));
             for (auto scopeNode : nextScopesToVisit) {
                 scopes[scopeNode].prevs.insert(&scope);
@@ -231,14 +230,11 @@ void runTypechecks(Module &module)
 {
     AstRoot& ast = module.getAst();
 
-    walkAst(ast, [&](AstNode& node){
-        if (!isFunctionNode(node))
-            return;
-
-        auto& fun = (Function&)node;
+    for (AstNode* node : findFunctionNodes(ast)) {
+        auto& fun = (Function&)*node;
         auto graph = module.getFunctionGraph(fun);
         if (!graph)
-            return;
+            continue;
         trace("Graph data:\n"+graphToDOT(*graph));
 
         unordered_map<GraphNode*, ScopedTypes> scopes;
@@ -256,5 +252,5 @@ void runTypechecks(Module &module)
             scopesToVisit.pop();
             runTypechecksInBranch(*graph, scopes, scopesToVisit, next);
         }
-    });
+    }
 }
@@ -0,0 +1,99 @@
+#include "ast/arena.hpp"
+#include "ast/ast.hpp"
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+static thread_local AstArena* currentArena = nullptr;
+
+AstArena::Scope::Scope(AstArena& arena)
+    : previous{currentArena}
+{
+    currentArena = &arena;
+}
+
+AstArena::Scope::~Scope()
+{
+    currentArena = previous;
+}
+
+AstArena::~AstArena()
+{
+    destroyNodes(0, nodes.size());
+}
+
+AstArena* AstArena::current()
+{
+    return currentArena;
+}
+
+void* AstArena::allocate(size_t size)
+{
+    size = (size + alignment - 1) & ~(alignment - 1);
+    if (chunks.empty() || chunkUsed + size > chunks[chunkIndex].size) {
+        if (!chunks.empty())
+            chunkIndex++;
+        // Chunks kept from before a rewind are reused, unless too small for this node
+        while (chunkIndex < chunks.size() && chunks[chunkIndex].size < size)
+            chunks.erase(chunks.begin() + chunkIndex);
+        if (chunkIndex == chunks.size()) {
+            size_t chunkSize = chunks.empty() ? firstChunkSize : min(chunks.back().size * 2, maxChunkSize);
+            chunkSize = max(chunkSize, size);
+            chunks.push_back({make_unique<uint8_t[]>(chunkSize), chunkSize});
+        }
+        chunkUsed = 0;
+    }
+
+    auto ptr = chunks[chunkIndex].data.get() + chunkUsed;
+    chunkUsed += size;
+    nodes.push_back(reinterpret_cast<AstNode*>(ptr));
+    return ptr;
+}
+
+bool AstArena::release(void* ptr)
+{
+    // This is the node that just failed to construct, or very close to the end
+    for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+        if (*it == ptr) {
+            *it = nullptr;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t AstArena::nodeCount() const
+{
+    return nodes.size();
+}
+
+size_t AstArena::allocatedBytes() const
+{
+    size_t total = 0;
+    for (const auto& chunk : chunks)
+        total += chunk.size;
+    return total;
+}
+
+AstArena::Mark AstArena::mark() const
+{
+    return {nodes.size(), chunkIndex, chunkUsed};
+}
+
+void AstArena::rewind(const Mark& mark)
+{
+    assert(mark.nodeCount <= nodes.size());
+    destroyNodes(mark.nodeCount, nodes.size());
+    chunkIndex = mark.chunkIndex;
+    chunkUsed = mark.chunkUsed;
+}
+
+void AstArena::destroyNodes(size_t begin, size_t end)
+{
+    // Destructors don't touch other nodes, so the order only matters for locality
+    for (size_t i = end; i > begin; --i)
+        if (AstNode* node = nodes[i-1])
+            node->~AstNode();
+    nodes.erase(nodes.begin() + begin, nodes.begin() + end);
+}
@@ -0,0 +1,63 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+#include <cstdint>
+
+class AstNode;
+
+// Bump allocator owning all the nodes of one AST. While a Scope is alive, every AstNode created on that thread
+// is allocated in its arena, and the nodes are all destroyed at once with the arena (so never delete them yourself).
+class AstArena
+{
+public:
+    // Position to rewind to, when the nodes allocated after it turn out to be unused
+    struct Mark {
+        size_t nodeCount;
+        size_t chunkIndex;
+        size_t chunkUsed;
+    };
+
+    class Scope
+    {
+    public:
+        explicit Scope(AstArena& arena);
+        Scope(const Scope& other) = delete;
+        ~Scope();
+
+    private:
+        AstArena* previous;
+    };
+
+    AstArena() = default;
+    AstArena(const AstArena& other) = delete;
+    ~AstArena();
+
+    static AstArena* current(); //< Arena of the innermost Scope on this thread, if any
+    void* allocate(size_t size);
+    bool release(void* ptr); //< Only for memory whose node failed to construct, returns false if it's not ours
+    size_t nodeCount() const;
+    size_t allocatedBytes() const;
+    Mark mark() const;
+    void rewind(const Mark& mark); //< Destroys the nodes allocated since the mark and reuses their memory
+    void destroyNodes(size_t begin, size_t end); //< Destroys a range of nodes, their memory is only reclaimed with the arena
+
+private:
+    struct Chunk {
+        std::unique_ptr<uint8_t[]> data;
+        size_t size;
+    };
+
+    static constexpr size_t alignment = alignof(std::max_align_t);
+    static constexpr size_t firstChunkSize = 64 * 1024;
+    static constexpr size_t maxChunkSize = 4 * 1024 * 1024;
+
+    std::vector<Chunk> chunks;
+    size_t chunkIndex = 0; //< Chunk we're allocating from, those after it are kept around after a rewind
+    size_t chunkUsed = 0;
+    std::vector<AstNode*> nodes; //< In allocation order, nullptr for released slots
+};
+
+#endif // ARENA_HPP
@@ -1,6 +1,7 @@
 #include "ast.hpp"
+#include "walk.hpp"
 #include "module/module.hpp"
-#include "utf8/utf8.h"
+#include <algorithm>
 #include <cassert>
 
 using namespace std;
@@ -13,6 +14,21 @@ AstNode::AstNode(AstSourceSpan location, AstNodeType type)
     assert(type < AstNodeType::Invalid);
 }
 
+void* AstNode::operator new(size_t size)
+{
+    if (AstArena* arena = AstArena::current())
+        return arena->allocate(size);
+    return ::operator new(size);
+}
+
+void AstNode::operator delete(void* ptr)
+{
+    // Arena memory is freed in bulk, an arena only sees this for nodes whose constructor threw
+    AstArena* arena = AstArena::current();
+    if (!arena || !arena->release(ptr))
+        ::operator delete(ptr);
+}
+
 AstNode* AstNode::getParent()
 {
     return parent;
@@ -60,22 +76,24 @@ void AstNode::setParentOfChildren() {
     });
 }
 
-string AstNode::getSourceString()
+AstSourcePosition AstNode::getStartPosition() const
 {
-    const string& source = getParentModule().getOriginalSource();
+    return getParentModule().getLineTable().position(location.start);
+}
 
-    const char* beg_ptr = source.data();
-    utf8::unchecked::advance(beg_ptr, location.start.offset);
-    const char* end_ptr = beg_ptr;
-    utf8::unchecked::advance(end_ptr, location.end.offset - location.start.offset);
+AstSourcePosition AstNode::getEndPosition() const
+{
+    return getParentModule().getLineTable().position(location.end);
+}
 
-    return string(beg_ptr, end_ptr - beg_ptr);
+string AstNode::getSourceString()
+{
+    return location.toString(getParentModule().getOriginalSource());
 }
 
 AstComment::AstComment(AstSourceSpan location, AstComment::Type type, string text)
     : AstNode(location, type == Type::Line ? AstNodeType::CommentLine : AstNodeType::CommentBlock)
     , text{text},
-      location{location},
       type{type}
 {
 }
@@ -90,13 +108,59 @@ AstComment::Type AstComment::getType() const
     return type;
 }
 
-AstRoot::AstRoot(AstSourceSpan location, Module &parentModule, vector<AstNode*> body, std::vector<AstComment*> comments)
+AstRoot::AstRoot(AstSourceSpan location, Module &parentModule, vector<AstNode*> body, std::vector<AstComment*> comments, unique_ptr<AstArena> arena)
     : AstNode(location, AstNodeType::Root)
     , parentModule{ parentModule }
     , body{ move(body) }
     , comments{ move(comments) }
+    , arena{ move(arena) }
 {
     setParentOfChildren();
+    indexNodesByType();
+}
+
+// A parent starts no later and ends no sooner than its children
+static bool isBeforeInSource(AstNode* a, AstNode* b)
+{
+    AstSourceSpan locA = a->getLocation(), locB = b->getLocation();
+    return locA.start != locB.start ? locA.start < locB.start : locA.end > locB.end;
+}
+
+void AstRoot::indexNodesByType()
+{
+    constexpr size_t typesCount = static_cast<size_t>(AstNodeType::Invalid);
+    vector<AstNode*> nodes;
+    if (arena)
+        nodes.reserve(arena->nodeCount() + 1);
+    walkAst(*this, [&](AstNode& node) {
+        nodes.push_back(&node);
+    });
+
+    // Counting sort, which keeps each group in walk order
+    vector<uint32_t> groupOffsets(typesCount + 1, 0);
+    for (AstNode* node : nodes)
+        groupOffsets[static_cast<size_t>(node->getType()) + 1]++;
+    for (size_t i = 1; i <= typesCount; ++i)
+        groupOffsets[i] += groupOffsets[i - 1];
+    vector<uint32_t> cursors(groupOffsets.begin(), groupOffsets.end() - 1);
+    nodesByType.resize(nodes.size());
+    for (AstNode* node : nodes)
+        nodesByType[cursors[static_cast<size_t>(node->getType())]++] = node;
+
+    // Walk order is almost always source order, but a few nodes walk their children out of order, or walk some twice
+    typeOffsets.assign(typesCount + 1, 0);
+    size_t kept = 0;
+    for (size_t i = 0; i < typesCount; ++i) {
+        auto first = nodesByType.begin() + groupOffsets[i], last = nodesByType.begin() + groupOffsets[i + 1];
+        if (!is_sorted(first, last, isBeforeInSource))
+            stable_sort(first, last, isBeforeInSource);
+        last = unique(first, last);
+        typeOffsets[i] = kept;
+        move(first, last, nodesByType.begin() + kept);
+        kept += last - first;
+    }
+    typeOffsets[typesCount] = kept;
+    nodesByType.resize(kept);
 }
 
 const std::vector<AstNode*>& AstRoot::getBody()
@@ -114,9 +178,27 @@ Module &AstRoot::getParentModule() const
     return parentModule;
 }
 
-Identifier::Identifier(AstSourceSpan location, string name, TypeAnnotation* typeAnnotation, bool optional)
+AstNodeRange AstRoot::getNodesOfType(AstNodeType type) const
+{
+    auto index = static_cast<size_t>(type);
+    assert(index + 1 < typeOffsets.size());
+    return {nodesByType.data() + typeOffsets[index], nodesByType.data() + typeOffsets[index + 1]};
+}
+
+vector<AstNode*> AstRoot::getNodesOfTypes(initializer_list<AstNodeType> types) const
+{
+    vector<AstNode*> result;
+    for (AstNodeType type : types) {
+        AstNodeRange nodes = getNodesOfType(type);
+        result.insert(result.end(), nodes.begin(), nodes.end());
+    }
+    stable_sort(result.begin(), result.end(), isBeforeInSource);
+    return result;
+}
+
+Identifier::Identifier(AstSourceSpan location, Atom name, TypeAnnotation* typeAnnotation, bool optional)
     : AstNode(location, AstNodeType::Identifier)
-    , name{ move(name) }
+    , name{ name }
     , typeAnnotation{ typeAnnotation }
     , optional{ optional }
 {
@@ -124,6 +206,11 @@ Identifier::Identifier(AstSourceSpan location, string name, TypeAnnotation* type
 }
 
 const std::string& Identifier::getName()
+{
+    return name.str();
+}
+
+Atom Identifier::getAtom()
 {
     return name;
 }
@@ -157,14 +244,19 @@ NullLiteral::NullLiteral(AstSourceSpan location)
     setParentOfChildren();
 }
 
-StringLiteral::StringLiteral(AstSourceSpan location, string value)
+StringLiteral::StringLiteral(AstSourceSpan location, Atom value)
     : AstNode(location, AstNodeType::StringLiteral)
-    , value{ move(value) }
+    , value{ value }
 {
     setParentOfChildren();
 }
 
 const string &StringLiteral::getValue()
+{
+    return value.str();
+}
+
+Atom StringLiteral::getAtom()
 {
     return value;
 }
@@ -1334,6 +1426,12 @@ ExportAllDeclaration::ExportAllDeclaration(AstSourceSpan location, AstNode* sour
     setParentOfChildren();
 }
 
+string ExportAllDeclaration::getSource()
+{
+    assert(source->getType() == AstNodeType::StringLiteral);
+    return ((StringLiteral*)source)->getValue();
+}
+
 ExportSpecifier::ExportSpecifier(AstSourceSpan location, AstNode* local, AstNode* exported)
     : AstNode(location, AstNodeType::ExportSpecifier)
     , local{ local }
@@ -1674,9 +1772,9 @@ const std::vector<TypeParameter *> &TypeParameterDeclaration::getParams()
     return params;
 }
 
-TypeParameter::TypeParameter(AstSourceSpan location, std::string name, AstNode *bound)
+TypeParameter::TypeParameter(AstSourceSpan location, Atom name, AstNode *bound)
     : AstNode(location, AstNodeType::TypeParameter)
-    , name{ new Identifier(location, move(name), nullptr, false) }
+    , name{ new Identifier(location, name, nullptr, false) }
     , bound{ bound }
 {
     setParentOfChildren();
@@ -3,9 +3,14 @@
 
 #include "import.hpp"
 #include "location.hpp"
+#include "arena.hpp"
+#include "utils/atom.hpp"
 #include <string>
 #include <vector>
-#include <functional>
+#include <memory>
+#include <initializer_list>
+
+class Module;
 
 #define X(IMPORTED_NODE_TYPE) IMPORTED_NODE_TYPE,
 enum class AstNodeType {
@@ -24,15 +29,21 @@ public:
     AstNode(AstSourceSpan location, AstNodeType type);
     AstNode(const AstNode& other) = delete;
     virtual ~AstNode() = default;
+    // Nodes go in the current thread's AstArena when there is one, see ast/arena.hpp
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
     AstNode* getParent();
     const AstNode* getParent() const;
     Module& getParentModule() const;
     AstNodeType getType() const;
     const char* getTypeName() const;
-    AstSourceSpan getLocation() const; //< Location of the AST node. Don't forget this is UTF8, not bytes!
+    AstSourceSpan getLocation() const; //< Byte offsets of the AST node in the module's original source
+    AstSourcePosition getStartPosition() const; //< Line and column, for humans
+    AstSourcePosition getEndPosition() const;
     std::string getSourceString();
-    std::vector<AstNode*> getChildren();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&); // Return false to stop iterating
+    // Calls cb(AstNode*) on each non-null child in source order, cb returns false to stop iterating
+    template <class F> void applyChildren(F&& cb);
+    template <class F> bool visitChildren(F&) { return true; } //< Overridden by node types with children, see ast/children.hpp
 
 protected:
     void setParentOfChildren();
@@ -56,39 +67,69 @@ public:
 
 private:
     std::string text;
-    AstSourceSpan location;
     Type type;
 };
 
+// Contiguous list of nodes, valid as long as the AstRoot it comes from
+class AstNodeRange {
+public:
+    AstNodeRange(AstNode* const* first, AstNode* const* last) : first{first}, last{last} {}
+    AstNode* const* begin() const { return first; }
+    AstNode* const* end() const { return last; }
+    size_t size() const { return static_cast<size_t>(last - first); }
+    bool empty() const { return first == last; }
+
+private:
+    AstNode* const* first;
+    AstNode* const* last;
+};
+
 class AstRoot : public AstNode {
 public:
-    AstRoot(AstSourceSpan location, Module& parentModule, std::vector<AstNode*> body = {}, std::vector<AstComment*> comments = {});
+    AstRoot(AstSourceSpan location, Module& parentModule, std::vector<AstNode*> body = {}, std::vector<AstComment*> comments = {},
+            std::unique_ptr<AstArena> arena = nullptr);
+    // The root owns the arena holding the rest of the tree, so it lives on the normal heap
+    static void* operator new(size_t size) { return ::operator new(size); }
+    static void operator delete(void* ptr) { ::operator delete(ptr); }
     const std::vector<AstNode*>& getBody();
     const std::vector<AstComment*>& getComments();
     Module& getParentModule() const;
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    // Every node of that type in the tree (comments excluded), in source order
+    AstNodeRange getNodesOfType(AstNodeType type) const;
+    // Every node of those types, in source order. Parents come before their children.
+    std::vector<AstNode*> getNodesOfTypes(std::initializer_list<AstNodeType> types) const;
+    template <class F> bool visitChildren(F& cb);
+
+private:
+    void indexNodesByType();
 
 private:
     Module& parentModule;
     std::vector<AstNode*> body;
     std::vector<AstComment*> comments;
+    std::unique_ptr<AstArena> arena;
+    std::vector<AstNode*> nodesByType; //< Grouped by type, each group in source order
+    std::vector<uint32_t> typeOffsets; //< Start of each type's group in nodesByType, indexed by AstNodeType
 };
 
 class Identifier : public AstNode {
+    friend class AstSerializer;
 public:
-    Identifier(AstSourceSpan location, std::string name, TypeAnnotation* typeAnnotation, bool optional);
+    Identifier(AstSourceSpan location, Atom name, TypeAnnotation* typeAnnotation, bool optional);
     const std::string& getName();
+    Atom getAtom();
     TypeAnnotation* getTypeAnnotation();
     bool isOptional();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
-    std::string name;
+    Atom name;
     TypeAnnotation* typeAnnotation;
     bool optional; // Flow syntax, e.g. for optional parameters
 };
 
 class RegExpLiteral : public AstNode {
+    friend class AstSerializer;
 public:
     RegExpLiteral(AstSourceSpan location, std::string pattern, std::string flags);
     const std::string& getPattern();
@@ -103,15 +144,18 @@ public:
 };
 
 class StringLiteral : public AstNode {
+    friend class AstSerializer;
 public:
-    StringLiteral(AstSourceSpan location, std::string value);
+    StringLiteral(AstSourceSpan location, Atom value);
     const std::string& getValue();
+    Atom getAtom();
 
 private:
-    std::string value;
+    Atom value;
 };
 
 class BooleanLiteral : public AstNode {
+    friend class AstSerializer;
 public:
     BooleanLiteral(AstSourceSpan location, bool value);
     bool getValue();
@@ -121,6 +165,7 @@ private:
 };
 
 class NumericLiteral : public AstNode {
+    friend class AstSerializer;
 public:
     NumericLiteral(AstSourceSpan location, double value);
     double getValue();
@@ -130,17 +175,19 @@ private:
 };
 
 class TemplateLiteral : public AstNode {
+    friend class AstSerializer;
 public:
     TemplateLiteral(AstSourceSpan location, std::vector<AstNode*> quasis, std::vector<AstNode*> expressions);
     const std::vector<AstNode*>& getQuasis();
     const std::vector<AstNode*>& getExpressions();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> quasis, expressions;
 };
 
 class TemplateElement : public AstNode {
+    friend class AstSerializer;
 public:
     TemplateElement(AstSourceSpan location, std::string rawValue, bool tail);
     bool isTail();
@@ -151,9 +198,10 @@ private:
 };
 
 class TaggedTemplateExpression : public AstNode {
+    friend class AstSerializer;
 public:
     TaggedTemplateExpression(AstSourceSpan location, AstNode* tag, AstNode* quasi);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *tag, *quasi;
@@ -161,19 +209,21 @@ private:
 
 
 class ExpressionStatement : public AstNode {
+    friend class AstSerializer;
 public:
     ExpressionStatement(AstSourceSpan location, AstNode* expression);
     AstNode* getExpression();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* expression;
 };
 
 class BlockStatement : public AstNode {
+    friend class AstSerializer;
 public:
     BlockStatement(AstSourceSpan location, std::vector<AstNode*> body);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> body;
@@ -185,9 +235,10 @@ public:
 };
 
 class WithStatement : public AstNode {
+    friend class AstSerializer;
 public:
     WithStatement(AstSourceSpan location, AstNode* object, AstNode* body);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *object, *body;
@@ -199,48 +250,53 @@ public:
 };
 
 class ReturnStatement : public AstNode {
+    friend class AstSerializer;
 public:
     ReturnStatement(AstSourceSpan location, AstNode* argument);
     AstNode* getArgument();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* argument;
 };
 
 class LabeledStatement : public AstNode {
+    friend class AstSerializer;
 public:
     LabeledStatement(AstSourceSpan location, AstNode* label, AstNode* body);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *label, *body;
 };
 
 class BreakStatement : public AstNode {
+    friend class AstSerializer;
 public:
     BreakStatement(AstSourceSpan location, AstNode* label);
     AstNode* getLabel();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* label;
 };
 
 class ContinueStatement : public AstNode {
+    friend class AstSerializer;
 public:
     ContinueStatement(AstSourceSpan location, AstNode* label);
     AstNode* getLabel();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* label;
 };
 
 class IfStatement : public AstNode {
+    friend class AstSerializer;
 public:
     IfStatement(AstSourceSpan location, AstNode* test, AstNode* consequent, AstNode* alternate);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
     AstNode* getTest();
     AstNode* getConsequent();
     AstNode* getAlternate();
@@ -250,11 +306,12 @@ private:
 };
 
 class SwitchStatement : public AstNode {
+    friend class AstSerializer;
 public:
     SwitchStatement(AstSourceSpan location, AstNode* discriminant, std::vector<SwitchCase*> cases);
     AstNode* getDiscriminant();
     const std::vector<SwitchCase*>& getCases();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* discriminant;
@@ -262,11 +319,12 @@ private:
 };
 
 class SwitchCase : public AstNode {
+    friend class AstSerializer;
 public:
     SwitchCase(AstSourceSpan location, AstNode* testOrDefault, std::vector<AstNode*> consequent);
     AstNode* getTest();
     const std::vector<AstNode*>& getConsequents();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* testOrDefault; // Is a nullptr for the default case
@@ -274,61 +332,67 @@ private:
 };
 
 class ThrowStatement : public AstNode {
+    friend class AstSerializer;
 public:
     ThrowStatement(AstSourceSpan location, AstNode* argument);
     AstNode* getArgument();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* argument;
 };
 
 class TryStatement : public AstNode {
+    friend class AstSerializer;
 public:
     TryStatement(AstSourceSpan location, AstNode* block, AstNode* handler, AstNode* finalizer);
     AstNode* getBlock();
     CatchClause* getHandler();
     AstNode* getFinalizer();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *block, *handler, *finalizer;
 };
 
 class CatchClause : public AstNode {
+    friend class AstSerializer;
 public:
     CatchClause(AstSourceSpan location, AstNode* param, AstNode* body);
     AstNode* getParam();
     AstNode* getBody();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *param, *body;
 };
 
 class WhileStatement : public AstNode {
+    friend class AstSerializer;
 public:
     WhileStatement(AstSourceSpan location, AstNode* test, AstNode* body);
     AstNode* getTest();
     AstNode* getBody();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *test, *body;
 };
 
 class DoWhileStatement : public AstNode {
+    friend class AstSerializer;
 public:
     DoWhileStatement(AstSourceSpan location, AstNode* test, AstNode* body);
     AstNode* getTest();
     AstNode* getBody();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *test, *body;
 };
 
 class Function : public AstNode {
+    friend class AstSerializer;
 public:
     Identifier* getId();
     AstNode* getBody();
@@ -338,11 +402,11 @@ public:
     const std::vector<AstNode*>& getParams();
     bool isGenerator();
     bool isAsync();
+    template <class F> bool visitChildren(F& cb);
 
 protected:
     Function(AstSourceSpan location, AstNodeType type, AstNode* id, std::vector<AstNode*> params, AstNode* body,
              TypeParameterDeclaration* typeParameters, TypeAnnotation* returnType, bool generator, bool async);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
 
 protected:
     AstNode* id;
@@ -354,13 +418,14 @@ protected:
 };
 
 class ObjectProperty : public AstNode {
+    friend class AstSerializer;
 public:
     ObjectProperty(AstSourceSpan location, AstNode* key, AstNode* value, bool shorthand, bool computed);
     AstNode* getKey();
     Identifier* getValue();
     bool isShorthand();
     bool isComputed();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *key, *value;
@@ -368,6 +433,7 @@ private:
 };
 
 class ObjectMethod : public Function {
+    friend class AstSerializer;
 public:
     enum class Kind {
         Constructor,
@@ -380,7 +446,7 @@ public:
                  TypeAnnotation* returnType, AstNode* key, Kind kind, bool isGenerator, bool isAsync, bool isComputed);
     AstNode* getKey();
     bool isComputed();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* key;
@@ -404,6 +470,7 @@ public:
 };
 
 class ArrowFunctionExpression : public Function {
+    friend class AstSerializer;
 public:
     ArrowFunctionExpression(AstSourceSpan location, AstNode* id, std::vector<AstNode*> params, AstNode* body, TypeParameterDeclaration* typeParameters,
                             TypeAnnotation* returnType, bool isGenerator, bool isAsync, bool expression);
@@ -415,9 +482,10 @@ private:
 };
 
 class YieldExpression : public AstNode {
+    friend class AstSerializer;
 public:
     YieldExpression(AstSourceSpan location, AstNode* argument, bool isDelegate);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* argument;
@@ -425,20 +493,22 @@ private:
 };
 
 class AwaitExpression : public AstNode {
+    friend class AstSerializer;
 public:
     AwaitExpression(AstSourceSpan location, AstNode* argument);
     AstNode* getArgument();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* argument;
 };
 
 class ArrayExpression : public AstNode {
+    friend class AstSerializer;
 public:
     ArrayExpression(AstSourceSpan location, std::vector<AstNode*> elements);
     const std::vector<AstNode*>& getElements();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     // NOTE: Some of the elements might be nullptrs! E.g. [1,,3] result in {NumericLiteral*,nullptr,NumericLiteral*}
@@ -446,10 +516,11 @@ private:
 };
 
 class ObjectExpression : public AstNode {
+    friend class AstSerializer;
 public:
     ObjectExpression(AstSourceSpan location, std::vector<AstNode*> properties);
     const std::vector<AstNode*>& getProperties();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> properties;
@@ -462,6 +533,7 @@ public:
 };
 
 class UnaryExpression : public AstNode {
+    friend class AstSerializer;
 public:
     enum class Operator {
         Minus,
@@ -475,7 +547,7 @@ public:
     UnaryExpression(AstSourceSpan location, AstNode* argument, Operator unaryOperator, bool isPrefix);
     AstNode* getArgument();
     Operator getOperator();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* argument;
@@ -484,6 +556,7 @@ private:
 };
 
 class UpdateExpression : public AstNode {
+    friend class AstSerializer;
 public:
     enum class Operator {
         Increment,
@@ -493,7 +566,7 @@ public:
     AstNode* getArgument();
     Operator getOperator();
     bool isPrefix();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* argument;
@@ -502,6 +575,7 @@ private:
 };
 
 class BinaryExpression : public AstNode {
+    friend class AstSerializer;
 public:
     enum class Operator {
         Equal,
@@ -531,7 +605,7 @@ public:
     AstNode* getLeft();
     AstNode* getRight();
     Operator getOperator();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *left, *right;
@@ -539,6 +613,7 @@ private:
 };
 
 class AssignmentExpression : public AstNode {
+    friend class AstSerializer;
 public:
     enum class Operator {
         Equal,
@@ -559,7 +634,7 @@ public:
     AstNode* getLeft();
     AstNode* getRight();
     Operator getOperator();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *left, *right;
@@ -567,6 +642,7 @@ private:
 };
 
 class LogicalExpression : public AstNode {
+    friend class AstSerializer;
 public:
     enum class Operator {
         Or,
@@ -576,7 +652,7 @@ public:
     AstNode* getLeft();
     AstNode* getRight();
     Operator getOperator();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *left, *right;
@@ -584,12 +660,13 @@ private:
 };
 
 class MemberExpression : public AstNode {
+    friend class AstSerializer;
 public:
     MemberExpression(AstSourceSpan location, AstNode* object, AstNode* property, bool computed);
     AstNode* getObject();
     AstNode* getProperty();
     bool isComputed();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *object, *property;
@@ -597,32 +674,35 @@ private:
 };
 
 class BindExpression : public AstNode {
+    friend class AstSerializer;
 public:
     BindExpression(AstSourceSpan location, AstNode* object, AstNode* callee);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *object, *callee;
 };
 
 class ConditionalExpression : public AstNode {
+    friend class AstSerializer;
 public:
     ConditionalExpression(AstSourceSpan location, AstNode* test, AstNode* alternate, AstNode* consequent);
     AstNode* getTest();
     AstNode* getAlternate();
     AstNode* getConsequent();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *test, *alternate, *consequent;
 };
 
 class CallExpression : public AstNode {
+    friend class AstSerializer;
 public:
     CallExpression(AstSourceSpan location, AstNode* callee, std::vector<AstNode*> arguments);
     const std::vector<AstNode*>& getArguments();
     AstNode* getCallee();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 protected:
     CallExpression(AstSourceSpan location, AstNodeType type, AstNode* callee, std::vector<AstNode*> arguments);
@@ -638,34 +718,37 @@ public:
 };
 
 class SequenceExpression : public AstNode {
+    friend class AstSerializer;
 public:
     SequenceExpression(AstSourceSpan location, std::vector<AstNode*> expressions);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> expressions;
 };
 
 class DoExpression : public AstNode {
+    friend class AstSerializer;
 public:
     DoExpression(AstSourceSpan location, AstNode* body);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* body;
 };
 
 class Class : public AstNode {
+    friend class AstSerializer;
 public:
     Identifier* getId();
     ClassBody* getBody();
     TypeParameterDeclaration* getTypeParameters();
     const std::vector<ClassImplements*>& getImplements();
+    template <class F> bool visitChildren(F& cb);
 
 protected:
     Class(AstSourceSpan location, AstNodeType type, AstNode* id, AstNode* superClass, AstNode* body,
           TypeParameterDeclaration* typeParameters, TypeParameterInstantiation* superTypeParameters, std::vector<ClassImplements*> implements);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
 
 protected:
     AstNode *id, *superClass;
@@ -688,23 +771,24 @@ public:
 };
 
 class ClassBody : public AstNode {
+    friend class AstSerializer;
 public:
     ClassBody(AstSourceSpan location, std::vector<AstNode*> body);
     const std::vector<AstNode*>& getBody();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> body;
 };
 
 class ClassBaseProperty : public AstNode {
+    friend class AstSerializer;
 public:
     AstNode* getKey();
     AstNode* getValue();
     TypeAnnotation* getTypeAnnotation();
     bool isStatic();
     bool isComputed();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) = 0;
 
 protected:
     ClassBaseProperty(AstNodeType type, AstSourceSpan location, AstNode* key, AstNode* value, TypeAnnotation* typeAnnotation, bool isStatic, bool isComputed);
@@ -718,21 +802,21 @@ protected:
 class ClassProperty : public ClassBaseProperty {
 public:
     ClassProperty(AstSourceSpan location, AstNode* key, AstNode* value, TypeAnnotation* typeAnnotation, bool isStatic, bool isComputed);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 };
 
 class ClassPrivateProperty : public ClassBaseProperty {
 public:
     ClassPrivateProperty(AstSourceSpan location, AstNode* key, AstNode* value, TypeAnnotation* typeAnnotation, bool isStatic);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 };
 
 class ClassBaseMethod : public Function {
+    friend class AstSerializer;
 public:
     AstNode* getKey();
     bool isComputed();
     bool isStatic();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) = 0;
 
 protected:
     ClassBaseMethod(AstNodeType type, AstSourceSpan location, AstNode* id, std::vector<AstNode*> params, AstNode* body, AstNode* key,
@@ -745,6 +829,7 @@ protected:
 };
 
 class ClassMethod : public ClassBaseMethod {
+    friend class AstSerializer;
 public:
     enum class Kind {
         Constructor,
@@ -757,13 +842,14 @@ public:
                 TypeParameterDeclaration* typeParameters, TypeAnnotation* returnType,
                 Kind kind, bool isGenerator, bool isAsync, bool isComputed, bool isStatic);
     Kind getKind();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Kind kind;
 };
 
 class ClassPrivateMethod : public ClassBaseMethod {
+    friend class AstSerializer;
 public:
     enum class Kind {
         Method,
@@ -775,7 +861,7 @@ public:
                        TypeParameterDeclaration* typeParameters, TypeAnnotation* returnType,
                        Kind kind, bool isGenerator, bool isAsync, bool isStatic);
     Kind getKind();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Kind kind;
@@ -788,6 +874,7 @@ public:
 };
 
 class VariableDeclaration : public AstNode {
+    friend class AstSerializer;
 public:
     enum class Kind {
         Var,
@@ -797,7 +884,7 @@ public:
     VariableDeclaration(AstSourceSpan location, std::vector<VariableDeclarator*> declarators, Kind kind);
     Kind getKind();
     const std::vector<VariableDeclarator*>& getDeclarators();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<VariableDeclarator*> declarators;
@@ -805,48 +892,52 @@ private:
 };
 
 class VariableDeclarator : public AstNode {
+    friend class AstSerializer;
 public:
     VariableDeclarator(AstSourceSpan location, AstNode* id, AstNode* init);
     AstNode *getId();
     AstNode* getInit();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *id, *init;
 };
 
 class ForStatement : public AstNode {
+    friend class AstSerializer;
 public:
     ForStatement(AstSourceSpan location, AstNode* init, AstNode* test, AstNode* update, AstNode* body);
     AstNode *getInit();
     AstNode* getTest();
     AstNode* getUpdate();
     AstNode* getBody();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *init, *test, *update, *body;
 };
 
 class ForInStatement : public AstNode {
+    friend class AstSerializer;
 public:
     ForInStatement(AstSourceSpan location, AstNode* left, AstNode* right, AstNode* body);
     AstNode* getLeft();
     AstNode* getRight();
     AstNode* getBody();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *left, *right, *body;
 };
 
 class ForOfStatement : public AstNode {
+    friend class AstSerializer;
 public:
     ForOfStatement(AstSourceSpan location, AstNode* left, AstNode* right, AstNode* body, bool isAwait);
     AstNode* getLeft();
     AstNode* getRight();
     AstNode* getBody();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *left, *right, *body;
@@ -854,20 +945,22 @@ private:
 };
 
 class SpreadElement : public AstNode {
+    friend class AstSerializer;
 public:
     SpreadElement(AstSourceSpan location, AstNode* argument);
     AstNode* getArgument();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* argument;
 };
 
 class ObjectPattern : public AstNode {
+    friend class AstSerializer;
 public:
     ObjectPattern(AstSourceSpan location, std::vector<AstNode*> properties, TypeAnnotation* typeAnnotation);
     const std::vector<AstNode*>& getProperties();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> properties;
@@ -875,10 +968,11 @@ private:
 };
 
 class ArrayPattern : public AstNode {
+    friend class AstSerializer;
 public:
     ArrayPattern(AstSourceSpan location, std::vector<AstNode*> elements);
     const std::vector<AstNode*>& getElements();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> elements;
@@ -886,21 +980,23 @@ private:
 
 // Typically appears in the parameter for a function
 class AssignmentPattern : public AstNode {
+    friend class AstSerializer;
 public:
     AssignmentPattern(AstSourceSpan location, AstNode* left, AstNode* right);
     AstNode* getLeft(); // Identifier, ObjectPattern or ArrayPattern
     AstNode* getRight();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *left, *right;
 };
 
 class RestElement : public AstNode {
+    friend class AstSerializer;
 public:
     RestElement(AstSourceSpan location, AstNode* argument, TypeAnnotation* typeAnnotation);
     Identifier* getArgument();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* argument;
@@ -908,15 +1004,17 @@ private:
 };
 
 class MetaProperty : public AstNode {
+    friend class AstSerializer;
 public:
     MetaProperty(AstSourceSpan location, AstNode* meta, AstNode* property);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *meta, *property;
 };
 
 class ImportDeclaration : public AstNode {
+    friend class AstSerializer;
 public:
     enum class Kind {
         Value,
@@ -929,7 +1027,7 @@ public:
     std::string getSource();
     Kind getKind();
     const std::vector<AstNode*>& getSpecifiers();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> specifiers;
@@ -938,11 +1036,11 @@ private:
 };
 
 class ImportBaseSpecifier : public AstNode {
+    friend class AstSerializer;
 public:
     ImportBaseSpecifier(AstNodeType type, AstSourceSpan location, AstNode* local, bool typeImport);
     Identifier* getLocal();
     bool isTypeImport();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) = 0;
 
 protected:
     Identifier *local;
@@ -950,10 +1048,11 @@ protected:
 };
 
 class ImportSpecifier : public ImportBaseSpecifier {
+    friend class AstSerializer;
 public:
     ImportSpecifier(AstSourceSpan location, AstNode* local, AstNode* imported, bool typeImport);
     Identifier* getImported();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier *imported;
@@ -963,16 +1062,17 @@ private:
 class ImportDefaultSpecifier : public ImportBaseSpecifier {
 public:
     ImportDefaultSpecifier(AstSourceSpan location, AstNode* local);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 };
 
 class ImportNamespaceSpecifier : public ImportBaseSpecifier {
 public:
     ImportNamespaceSpecifier(AstSourceSpan location, AstNode* local);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 };
 
 class ExportNamedDeclaration : public AstNode {
+    friend class AstSerializer;
 public:
     enum class Kind {
         Value,
@@ -983,7 +1083,7 @@ public:
     ExportNamedDeclaration(AstSourceSpan location, AstNode* declaration, AstNode* source, std::vector<AstNode*> specifiers, Kind kind);
     Kind getKind();
     AstNode* getSource();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *declaration, *source;
@@ -992,61 +1092,68 @@ private:
 };
 
 class ExportDefaultDeclaration : public AstNode {
+    friend class AstSerializer;
 public:
     ExportDefaultDeclaration(AstSourceSpan location, AstNode* declaration);
     AstNode* getDeclaration();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* declaration;
 };
 
 class ExportAllDeclaration : public AstNode {
+    friend class AstSerializer;
 public:
     ExportAllDeclaration(AstSourceSpan location, AstNode* source);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    std::string getSource();
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* source;
 };
 
 class ExportSpecifier : public AstNode {
+    friend class AstSerializer;
 public:
     ExportSpecifier(AstSourceSpan location, AstNode* local, AstNode* exported);
     Identifier* getLocal();
     Identifier* getExported();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *local, *exported;
 };
 
 class ExportDefaultSpecifier : public AstNode {
+    friend class AstSerializer;
 public:
     ExportDefaultSpecifier(AstSourceSpan location, AstNode* exported);
     Identifier* getExported();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *exported;
 };
 
 class TypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     TypeAnnotation(AstSourceSpan location, AstNode* typeAnnotation);
     AstNode* getTypeAnnotation();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *typeAnnotation;
 };
 
 class GenericTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     GenericTypeAnnotation(AstSourceSpan location, AstNode* id, AstNode* typeParameters);
     Identifier* getId();
     Identifier* getTypeParameters();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *id;
@@ -1089,46 +1196,51 @@ public:
 };
 
 class NullableTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     NullableTypeAnnotation(AstSourceSpan location, AstNode* typeAnnotation);
     AstNode* getTypeAnnotation();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* typeAnnotation;
 };
 
 class ArrayTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     ArrayTypeAnnotation(AstSourceSpan location, AstNode* elementType);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* elementType;
 };
 
 class TupleTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     TupleTypeAnnotation(AstSourceSpan location, std::vector<AstNode*> types);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> types;
 };
 
 class UnionTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     UnionTypeAnnotation(AstSourceSpan location, std::vector<AstNode*> types);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> types;
 };
 
 class IntersectionTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     IntersectionTypeAnnotation(AstSourceSpan location, std::vector<AstNode*> types);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> types;
@@ -1140,6 +1252,7 @@ public:
 };
 
 class NumberLiteralTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     NumberLiteralTypeAnnotation(AstSourceSpan location, double value);
     double getValue();
@@ -1149,6 +1262,7 @@ private:
 };
 
 class StringLiteralTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     StringLiteralTypeAnnotation(AstSourceSpan location, std::string value);
 
@@ -1157,6 +1271,7 @@ private:
 };
 
 class BooleanLiteralTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     BooleanLiteralTypeAnnotation(AstSourceSpan location, bool value);
     bool getValue();
@@ -1166,21 +1281,23 @@ private:
 };
 
 class TypeofTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     TypeofTypeAnnotation(AstSourceSpan location, AstNode* argument);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* argument;
 };
 
 class FunctionTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     FunctionTypeAnnotation(AstSourceSpan location, std::vector<FunctionTypeParam*> params, FunctionTypeParam* rest, AstNode* returnType);
     const std::vector<FunctionTypeParam*>& getParams();
     FunctionTypeParam* getRestParam();
     AstNode* getReturnType();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<FunctionTypeParam*> params;
@@ -1189,11 +1306,12 @@ private:
 };
 
 class FunctionTypeParam : public AstNode {
+    friend class AstSerializer;
 public:
     FunctionTypeParam(AstSourceSpan location, Identifier* name, AstNode* typeAnnotation);
     Identifier* getName();
     AstNode* getTypeAnnotation();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier* name;
@@ -1201,11 +1319,12 @@ private:
 };
 
 class ObjectTypeAnnotation : public AstNode {
+    friend class AstSerializer;
 public:
     ObjectTypeAnnotation(AstSourceSpan location, std::vector<AstNode*> properties, std::vector<ObjectTypeIndexer*> indexers, bool exact);
     const std::vector<AstNode*>& getProperties();
     bool isExact();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> properties;
@@ -1214,12 +1333,13 @@ private:
 };
 
 class ObjectTypeProperty : public AstNode {
+    friend class AstSerializer;
 public:
     ObjectTypeProperty(AstSourceSpan location, Identifier* key, AstNode* value, bool optional);
     Identifier* getKey();
     AstNode* getValue();
     bool isOptional();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier *key;
@@ -1228,22 +1348,24 @@ private:
 };
 
 class ObjectTypeSpreadProperty : public AstNode {
+    friend class AstSerializer;
 public:
     ObjectTypeSpreadProperty(AstSourceSpan location, AstNode* argument);
     AstNode* getArgument();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode *argument;
 };
 
 class ObjectTypeIndexer : public AstNode {
+    friend class AstSerializer;
 public:
     ObjectTypeIndexer(AstSourceSpan location, Identifier* id, AstNode* key, AstNode* value);
     Identifier* getId();
     AstNode* getKey();
     AstNode* getValue();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier *id;
@@ -1252,12 +1374,13 @@ private:
 };
 
 class TypeAlias : public AstNode {
+    friend class AstSerializer;
 public:
     TypeAlias(AstSourceSpan location, Identifier* id, AstNode* typeParameters, AstNode* right);
     Identifier* getId();
     AstNode* getTypeParameters();
     AstNode* getRight();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier *id;
@@ -1266,29 +1389,32 @@ private:
 };
 
 class TypeParameterInstantiation : public AstNode {
+    friend class AstSerializer;
 public:
     TypeParameterInstantiation(AstSourceSpan location, std::vector<AstNode*> params);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<AstNode*> params;
 };
 
 class TypeParameterDeclaration : public AstNode {
+    friend class AstSerializer;
 public:
     TypeParameterDeclaration(AstSourceSpan location, std::vector<TypeParameter*> params);
     const std::vector<TypeParameter*>& getParams();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     std::vector<TypeParameter*> params;
 };
 
 class TypeParameter : public AstNode {
+    friend class AstSerializer;
 public:
-    TypeParameter(AstSourceSpan location, std::string name, AstNode* bound);
+    TypeParameter(AstSourceSpan location, Atom name, AstNode* bound);
     Identifier* getName();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier* name; // We pretend our name is an identifier for consistency
@@ -1296,11 +1422,12 @@ private:
 };
 
 class TypeCastExpression : public AstNode {
+    friend class AstSerializer;
 public:
     TypeCastExpression(AstSourceSpan location, AstNode* expression, TypeAnnotation* typeAnnotation);
     AstNode* getExpression();
     TypeAnnotation* getTypeAnnotation();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* expression;
@@ -1308,9 +1435,10 @@ private:
 };
 
 class ClassImplements : public AstNode {
+    friend class AstSerializer;
 public:
     ClassImplements(AstSourceSpan location, Identifier* id, TypeParameterInstantiation* typeParameters);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier* id;
@@ -1318,9 +1446,10 @@ private:
 };
 
 class QualifiedTypeIdentifier : public AstNode {
+    friend class AstSerializer;
 public:
     QualifiedTypeIdentifier(AstSourceSpan location, Identifier* qualification, Identifier* id);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
     Identifier *getId();
     Identifier *getQualification();
 
@@ -1330,6 +1459,7 @@ private:
 };
 
 class InterfaceDeclaration : public AstNode {
+    friend class AstSerializer;
 public:
     InterfaceDeclaration(AstSourceSpan location, Identifier* id, TypeParameterDeclaration* typeParameters, AstNode* body,
                          std::vector<InterfaceExtends*> extends, std::vector<InterfaceExtends*> mixins);
@@ -1338,7 +1468,7 @@ public:
     AstNode* getBody();
     const std::vector<InterfaceExtends*>& getExtends();
     const std::vector<InterfaceExtends*>& getMixins();
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier* id;
@@ -1349,9 +1479,10 @@ private:
 };
 
 class InterfaceExtends : public AstNode {
+    friend class AstSerializer;
 public:
     InterfaceExtends(AstSourceSpan location, Identifier* id, TypeParameterInstantiation* typeParameters);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier* id;
@@ -1359,27 +1490,30 @@ private:
 };
 
 class DeclareVariable : public AstNode {
+    friend class AstSerializer;
 public:
     DeclareVariable(AstSourceSpan location, Identifier* id);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier* id;
 };
 
 class DeclareFunction : public AstNode {
+    friend class AstSerializer;
 public:
     DeclareFunction(AstSourceSpan location, Identifier* id);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier* id;
 };
 
 class DeclareTypeAlias : public AstNode {
+    friend class AstSerializer;
 public:
     DeclareTypeAlias(AstSourceSpan location, Identifier* id, AstNode* right);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier* id;
@@ -1387,10 +1521,11 @@ private:
 };
 
 class DeclareClass : public AstNode {
+    friend class AstSerializer;
 public:
     DeclareClass(AstSourceSpan location, Identifier* id, TypeParameterDeclaration* typeParameters, AstNode* body,
                  std::vector<InterfaceExtends*> extends, std::vector<InterfaceExtends*> mixins);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     Identifier* id;
@@ -1401,9 +1536,10 @@ private:
 };
 
 class DeclareModule : public AstNode {
+    friend class AstSerializer;
 public:
     DeclareModule(AstSourceSpan location, StringLiteral* id, AstNode* body);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     StringLiteral* id;
@@ -1411,12 +1547,15 @@ private:
 };
 
 class DeclareExportDeclaration : public AstNode {
+    friend class AstSerializer;
 public:
     DeclareExportDeclaration(AstSourceSpan location, AstNode* declaration);
-    virtual void applyChildren(const std::function<bool (AstNode*)>&) override;
+    template <class F> bool visitChildren(F& cb);
 
 private:
     AstNode* declaration;
 };
 
+#include "children.hpp"
+
 #endif // AST_HPP
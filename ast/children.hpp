@@ -0,0 +1,530 @@
+#ifndef CHILDREN_HPP
+#define CHILDREN_HPP
+
+// Child iteration of each node type, included at the end of ast.hpp.
+// This is all templates so that walking a tree doesn't go through a std::function or a virtual call for every node.
+
+template <class F, class T>
+bool visitChild(F& cb, T* node)
+{
+    if (!node)
+        return true;
+    return cb(static_cast<AstNode*>(node));
+}
+
+template <class F, class T>
+bool visitChildArray(F& cb, const std::vector<T*>& nodes)
+{
+    for (T* child : nodes)
+        if (child && !cb(static_cast<AstNode*>(child)))
+            return false;
+    return true;
+}
+
+template <class T>
+struct AstNodeChildren
+{
+    template <class F> static bool visit(AstNode& node, F& cb) { return static_cast<T&>(node).visitChildren(cb); }
+};
+
+// Comments are all AstComment nodes, they don't have children
+template <>
+struct AstNodeChildren<CommentLine>
+{
+    template <class F> static bool visit(AstNode&, F&) { return true; }
+};
+
+template <>
+struct AstNodeChildren<CommentBlock>
+{
+    template <class F> static bool visit(AstNode&, F&) { return true; }
+};
+
+template <class F>
+void AstNode::applyChildren(F&& cb)
+{
+    switch (type) {
+    case AstNodeType::Root:
+        static_cast<AstRoot&>(*this).visitChildren(cb);
+        break;
+#define X(IMPORTED_NODE_TYPE) \
+    case AstNodeType::IMPORTED_NODE_TYPE: \
+        AstNodeChildren<IMPORTED_NODE_TYPE>::visit(*this, cb); \
+        break;
+    IMPORTED_NODE_LIST(X)
+#undef X
+    case AstNodeType::Invalid:
+        break;
+    }
+}
+
+template <class F> bool AstRoot::visitChildren(F& cb)
+{
+    return visitChildArray(cb, body);
+}
+
+template <class F> bool Identifier::visitChildren(F& cb)
+{
+    return visitChild(cb, typeAnnotation);
+}
+
+template <class F> bool TemplateLiteral::visitChildren(F& cb)
+{
+    return visitChildArray(cb, quasis) && visitChildArray(cb, expressions);
+}
+
+template <class F> bool TaggedTemplateExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, tag) && visitChild(cb, quasi);
+}
+
+template <class F> bool Function::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChildArray(cb, params) && visitChild(cb, body) && visitChild(cb, typeParameters)
+        && visitChild(cb, returnType);
+}
+
+template <class F> bool ObjectProperty::visitChildren(F& cb)
+{
+    return visitChild(cb, key) && visitChild(cb, value);
+}
+
+template <class F> bool ObjectMethod::visitChildren(F& cb)
+{
+    return visitChild(cb, key) && Function::visitChildren(cb);
+}
+
+template <class F> bool ExpressionStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, expression);
+}
+
+template <class F> bool BlockStatement::visitChildren(F& cb)
+{
+    return visitChildArray(cb, body);
+}
+
+template <class F> bool WithStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, object) && visitChild(cb, body);
+}
+
+template <class F> bool ReturnStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, argument);
+}
+
+template <class F> bool LabeledStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, label) && visitChild(cb, body);
+}
+
+template <class F> bool BreakStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, label);
+}
+
+template <class F> bool ContinueStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, label);
+}
+
+template <class F> bool IfStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, test) && visitChild(cb, consequent) && visitChild(cb, alternate);
+}
+
+template <class F> bool SwitchStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, discriminant) && visitChildArray(cb, cases);
+}
+
+template <class F> bool SwitchCase::visitChildren(F& cb)
+{
+    return visitChild(cb, testOrDefault) && visitChildArray(cb, consequent);
+}
+
+template <class F> bool ThrowStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, argument);
+}
+
+template <class F> bool TryStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, block) && visitChild(cb, handler) && visitChild(cb, finalizer);
+}
+
+template <class F> bool CatchClause::visitChildren(F& cb)
+{
+    return visitChild(cb, param) && visitChild(cb, body);
+}
+
+template <class F> bool WhileStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, test) && visitChild(cb, body);
+}
+
+template <class F> bool DoWhileStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, test) && visitChild(cb, body);
+}
+
+template <class F> bool ForStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, init) && visitChild(cb, test) && visitChild(cb, update) && visitChild(cb, body);
+}
+
+template <class F> bool ForInStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, left) && visitChild(cb, right) && visitChild(cb, body);
+}
+
+template <class F> bool ForOfStatement::visitChildren(F& cb)
+{
+    return visitChild(cb, left) && visitChild(cb, right) && visitChild(cb, body);
+}
+
+template <class F> bool YieldExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, argument);
+}
+
+template <class F> bool AwaitExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, argument);
+}
+
+template <class F> bool ArrayExpression::visitChildren(F& cb)
+{
+    return visitChildArray(cb, elements);
+}
+
+template <class F> bool ObjectExpression::visitChildren(F& cb)
+{
+    return visitChildArray(cb, properties);
+}
+
+template <class F> bool UnaryExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, argument);
+}
+
+template <class F> bool UpdateExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, argument);
+}
+
+template <class F> bool BinaryExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, left) && visitChild(cb, right);
+}
+
+template <class F> bool AssignmentExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, left) && visitChild(cb, right);
+}
+
+template <class F> bool LogicalExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, left) && visitChild(cb, right);
+}
+
+template <class F> bool MemberExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, object) && visitChild(cb, property);
+}
+
+template <class F> bool BindExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, object) && visitChild(cb, callee);
+}
+
+template <class F> bool ConditionalExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, test) && visitChild(cb, alternate) && visitChild(cb, consequent);
+}
+
+template <class F> bool CallExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, callee) && visitChildArray(cb, arguments);
+}
+
+template <class F> bool SequenceExpression::visitChildren(F& cb)
+{
+    return visitChildArray(cb, expressions);
+}
+
+template <class F> bool DoExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, body);
+}
+
+template <class F> bool Class::visitChildren(F& cb)
+{
+    return visitChildArray(cb, implements) && visitChild(cb, id) && visitChild(cb, superClass) && visitChild(cb, body)
+        && visitChild(cb, typeParameters)
+        && visitChild(cb, superTypeParameters);
+}
+
+template <class F> bool ClassBody::visitChildren(F& cb)
+{
+    return visitChildArray(cb, body);
+}
+
+template <class F> bool ClassProperty::visitChildren(F& cb)
+{
+    return visitChild(cb, key) && visitChild(cb, value) && visitChild(cb, typeAnnotation);
+}
+
+template <class F> bool ClassPrivateProperty::visitChildren(F& cb)
+{
+    return visitChild(cb, key) && visitChild(cb, value) && visitChild(cb, typeAnnotation);
+}
+
+template <class F> bool ClassMethod::visitChildren(F& cb)
+{
+    return visitChild(cb, key) && visitChild(cb, returnType) && Function::visitChildren(cb);
+}
+
+template <class F> bool ClassPrivateMethod::visitChildren(F& cb)
+{
+    return visitChild(cb, key) && visitChild(cb, returnType) && Function::visitChildren(cb);
+}
+
+template <class F> bool VariableDeclaration::visitChildren(F& cb)
+{
+    return visitChildArray(cb, declarators);
+}
+
+template <class F> bool VariableDeclarator::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, init);
+}
+
+template <class F> bool SpreadElement::visitChildren(F& cb)
+{
+    return visitChild(cb, argument);
+}
+
+template <class F> bool ObjectPattern::visitChildren(F& cb)
+{
+    return visitChildArray(cb, properties) && visitChild(cb, typeAnnotation);
+}
+
+template <class F> bool ArrayPattern::visitChildren(F& cb)
+{
+    return visitChildArray(cb, elements);
+}
+
+template <class F> bool AssignmentPattern::visitChildren(F& cb)
+{
+    return visitChild(cb, left) && visitChild(cb, right);
+}
+
+template <class F> bool RestElement::visitChildren(F& cb)
+{
+    return visitChild(cb, argument) && visitChild(cb, typeAnnotation);
+}
+
+template <class F> bool MetaProperty::visitChildren(F& cb)
+{
+    return visitChild(cb, meta) && visitChild(cb, property);
+}
+
+template <class F> bool ImportDeclaration::visitChildren(F& cb)
+{
+    return visitChildArray(cb, specifiers) && visitChild(cb, source);
+}
+
+template <class F> bool ImportSpecifier::visitChildren(F& cb)
+{
+    // We don't want to walk through two identifiers when there's only one written down in the source code
+    // Having the imported available on demand is nice for consistency, but not when walking the AST
+    if (!visitChild(cb, local))
+        return false;
+    return localEqualsImported || visitChild(cb, imported);
+}
+
+template <class F> bool ImportDefaultSpecifier::visitChildren(F& cb)
+{
+    return visitChild(cb, local);
+}
+
+template <class F> bool ImportNamespaceSpecifier::visitChildren(F& cb)
+{
+    return visitChild(cb, local);
+}
+
+template <class F> bool ExportNamedDeclaration::visitChildren(F& cb)
+{
+    return visitChild(cb, declaration) && visitChild(cb, source) && visitChildArray(cb, specifiers);
+}
+
+template <class F> bool ExportDefaultDeclaration::visitChildren(F& cb)
+{
+    return visitChild(cb, declaration);
+}
+
+template <class F> bool ExportAllDeclaration::visitChildren(F& cb)
+{
+    return visitChild(cb, source);
+}
+
+template <class F> bool ExportSpecifier::visitChildren(F& cb)
+{
+    return visitChild(cb, local) && visitChild(cb, exported);
+}
+
+template <class F> bool ExportDefaultSpecifier::visitChildren(F& cb)
+{
+    return visitChild(cb, exported);
+}
+
+template <class F> bool TypeAnnotation::visitChildren(F& cb)
+{
+    return visitChild(cb, typeAnnotation);
+}
+
+template <class F> bool GenericTypeAnnotation::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, typeParameters);
+}
+
+template <class F> bool FunctionTypeAnnotation::visitChildren(F& cb)
+{
+    return visitChildArray(cb, params) && visitChild(cb, rest) && visitChild(cb, returnType);
+}
+
+template <class F> bool FunctionTypeParam::visitChildren(F& cb)
+{
+    return visitChild(cb, name) && visitChild(cb, typeAnnotation);
+}
+
+template <class F> bool ObjectTypeAnnotation::visitChildren(F& cb)
+{
+    return visitChildArray(cb, properties) && visitChildArray(cb, indexers);
+}
+
+template <class F> bool ObjectTypeProperty::visitChildren(F& cb)
+{
+    return visitChild(cb, key) && visitChild(cb, value);
+}
+
+template <class F> bool ObjectTypeSpreadProperty::visitChildren(F& cb)
+{
+    return visitChild(cb, argument);
+}
+
+template <class F> bool ObjectTypeIndexer::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, key) && visitChild(cb, value);
+}
+
+template <class F> bool TypeAlias::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, typeParameters) && visitChild(cb, right);
+}
+
+template <class F> bool TypeParameterInstantiation::visitChildren(F& cb)
+{
+    return visitChildArray(cb, params);
+}
+
+template <class F> bool TypeParameterDeclaration::visitChildren(F& cb)
+{
+    return visitChildArray(cb, params);
+}
+
+template <class F> bool TypeCastExpression::visitChildren(F& cb)
+{
+    return visitChild(cb, expression) && visitChild(cb, typeAnnotation);
+}
+
+template <class F> bool NullableTypeAnnotation::visitChildren(F& cb)
+{
+    return visitChild(cb, typeAnnotation);
+}
+
+template <class F> bool ArrayTypeAnnotation::visitChildren(F& cb)
+{
+    return visitChild(cb, elementType);
+}
+
+template <class F> bool TupleTypeAnnotation::visitChildren(F& cb)
+{
+    return visitChildArray(cb, types);
+}
+
+template <class F> bool UnionTypeAnnotation::visitChildren(F& cb)
+{
+    return visitChildArray(cb, types);
+}
+
+template <class F> bool IntersectionTypeAnnotation::visitChildren(F& cb)
+{
+    return visitChildArray(cb, types);
+}
+
+template <class F> bool ClassImplements::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, typeParameters);
+}
+
+template <class F> bool QualifiedTypeIdentifier::visitChildren(F& cb)
+{
+    return visitChild(cb, qualification) && visitChild(cb, id);
+}
+
+template <class F> bool TypeofTypeAnnotation::visitChildren(F& cb)
+{
+    return visitChild(cb, argument);
+}
+
+template <class F> bool InterfaceDeclaration::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, typeParameters) && visitChild(cb, body) && visitChildArray(cb, extends)
+        && visitChildArray(cb, mixins);
+}
+
+template <class F> bool InterfaceExtends::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, typeParameters);
+}
+
+template <class F> bool TypeParameter::visitChildren(F& cb)
+{
+    return visitChild(cb, name) && visitChild(cb, bound);
+}
+
+template <class F> bool DeclareVariable::visitChildren(F& cb)
+{
+    return visitChild(cb, id);
+}
+
+template <class F> bool DeclareFunction::visitChildren(F& cb)
+{
+    return visitChild(cb, id);
+}
+
+template <class F> bool DeclareTypeAlias::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, right);
+}
+
+template <class F> bool DeclareClass::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, typeParameters) && visitChild(cb, body) && visitChildArray(cb, extends)
+        && visitChildArray(cb, mixins);
+}
+
+template <class F> bool DeclareModule::visitChildren(F& cb)
+{
+    return visitChild(cb, id) && visitChild(cb, body);
+}
+
+template <class F> bool DeclareExportDeclaration::visitChildren(F& cb)
+{
+    return visitChild(cb, declaration);
+}
+
+#endif // CHILDREN_HPP
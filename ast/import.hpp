@@ -1,9 +1,6 @@
 #ifndef IMPORT_HPP
 #define IMPORT_HPP
 
-#include "ast/location.hpp"
-#include <v8.h>
-
 #define IMPORTED_NODE_LIST(X)       \
     X(CommentLine)                  \
     X(CommentBlock)                 \
@@ -125,13 +122,4 @@
     X(DeclareModule)                \
     X(DeclareExportDeclaration)
 
-class AstRoot;
-class AstNode;
-class Module;
-
-AstRoot* importBabylonAst(Module& parentModule, v8::Local<v8::Object> astObj, bool keepComments);
-AstNode* importNode(const v8::Local<v8::Object>& node);
-AstNode* importChildOrNullptr(const v8::Local<v8::Object>& node, const char* name);
-AstSourceSpan importLocation(const v8::Local<v8::Object>& node);
-
 #endif // IMPORT_HPP
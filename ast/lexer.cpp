@@ -0,0 +1,601 @@
+#include "ast/lexer.hpp"
+#include <stdexcept>
+#include <cstdlib>
+
+using namespace std;
+
+static bool isAsciiIdentifierStart(uint8_t c)
+{
+    return (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '$' || c == '_';
+}
+
+static bool isDigit(uint8_t c)
+{
+    return c >= '0' && c <= '9';
+}
+
+static bool isUnicodeSpace(uint32_t c)
+{
+    return c == 0xA0 || c == 0xFEFF || c == 0x1680 || (c >= 0x2000 && c <= 0x200A) || c == 0x202F || c == 0x205F || c == 0x3000;
+}
+
+// We don't have the Unicode ID_Start/ID_Continue tables, so any non-space non-ASCII code point is accepted in names
+static bool isIdentifierPart(uint32_t c)
+{
+    if (c < 0x80)
+        return isAsciiIdentifierStart(c) || isDigit(c);
+    return !isUnicodeSpace(c) && c != 0x2028 && c != 0x2029;
+}
+
+static int hexValue(char c)
+{
+    if (c >= '0' && c <= '9')
+        return c - '0';
+    if (c >= 'a' && c <= 'f')
+        return c - 'a' + 10;
+    if (c >= 'A' && c <= 'F')
+        return c - 'A' + 10;
+    return -1;
+}
+
+static void appendUtf8(string& out, uint32_t c)
+{
+    if (c >= 0xD800 && c <= 0xDFFF) // Lone surrogates can't be represented in UTF-8, V8 replaces them the same way
+        c = 0xFFFD;
+    if (c < 0x80) {
+        out += (char)c;
+    } else if (c < 0x800) {
+        out += (char)(0xC0 | (c >> 6));
+        out += (char)(0x80 | (c & 0x3F));
+    } else if (c < 0x10000) {
+        out += (char)(0xE0 | (c >> 12));
+        out += (char)(0x80 | ((c >> 6) & 0x3F));
+        out += (char)(0x80 | (c & 0x3F));
+    } else {
+        out += (char)(0xF0 | (c >> 18));
+        out += (char)(0x80 | ((c >> 12) & 0x3F));
+        out += (char)(0x80 | ((c >> 6) & 0x3F));
+        out += (char)(0x80 | (c & 0x3F));
+    }
+}
+
+Lexer::Lexer(const string& source, bool keepComments)
+    : source{source}
+    , keepComments{keepComments}
+{
+    if (source.compare(0, 2, "#!") == 0) {
+        pos = 2;
+        size_t len;
+        while (pos < source.size() && !isNewlineAt(pos, len))
+            pos += peekLen();
+    }
+}
+
+void Lexer::fail(const string& message) const
+{
+    // Only failing needs a line and column, so we don't track them while lexing
+    AstSourcePosition at = LineTable(source).position(token.start);
+    throw runtime_error("Native parser: "+message+" at line "+to_string(at.line)+", column "+to_string(at.column));
+}
+
+Lexer::State Lexer::save() const
+{
+    return {token, pos, comments.size()};
+}
+
+void Lexer::restore(const Lexer::State& state)
+{
+    token = state.token;
+    pos = state.pos;
+    comments.erase(comments.begin() + state.commentsCount, comments.end());
+}
+
+uint32_t Lexer::peekCodePoint(size_t& len) const
+{
+    auto c = (uint8_t)source[pos];
+    auto cont = [&](size_t i) {
+        if (pos + i >= source.size() || ((uint8_t)source[pos + i] & 0xC0) != 0x80)
+            fail("Invalid UTF-8 in source");
+        return (uint32_t)((uint8_t)source[pos + i] & 0x3F);
+    };
+
+    if (c < 0x80) {
+        len = 1;
+        return c;
+    } else if ((c & 0xE0) == 0xC0) {
+        len = 2;
+        return ((c & 0x1F) << 6) | cont(1);
+    } else if ((c & 0xF0) == 0xE0) {
+        len = 3;
+        return ((c & 0x0F) << 12) | (cont(1) << 6) | cont(2);
+    } else if ((c & 0xF8) == 0xF0) {
+        len = 4;
+        return ((c & 0x07) << 18) | (cont(1) << 12) | (cont(2) << 6) | cont(3);
+    }
+    fail("Invalid UTF-8 in source");
+}
+
+bool Lexer::isNewlineAt(size_t at, size_t& len) const
+{
+    char c = source[at];
+    if (c == '\n') {
+        len = 1;
+        return true;
+    } else if (c == '\r') {
+        len = (at + 1 < source.size() && source[at + 1] == '\n') ? 2 : 1;
+        return true;
+    } else if (c == '\xE2' && at + 2 < source.size() && source[at + 1] == '\x80'
+               && (source[at + 2] == '\xA8' || source[at + 2] == '\xA9')) {
+        len = 3;
+        return true;
+    }
+    return false;
+}
+
+bool Lexer::skipSpaceAndComments()
+{
+    bool sawNewline = false;
+    size_t len;
+    while (pos < source.size()) {
+        char c = source[pos];
+        if (c == ' ' || c == '\t' || c == '\v' || c == '\f') {
+            pos++;
+        } else if (isNewlineAt(pos, len)) {
+            pos += len;
+            sawNewline = true;
+        } else if (c == '/' && pos + 1 < source.size() && source[pos + 1] == '/') {
+            skipLineComment();
+        } else if (c == '/' && pos + 1 < source.size() && source[pos + 1] == '*') {
+            sawNewline |= skipBlockComment();
+        } else if ((uint8_t)c >= 0x80 && isUnicodeSpace(peekCodePoint(len))) {
+            pos += len;
+        } else {
+            break;
+        }
+    }
+    return sawNewline;
+}
+
+void Lexer::skipLineComment()
+{
+    AstSourceOffset start = position();
+    size_t textStart = pos + 2;
+    pos += 2;
+    size_t len;
+    while (pos < source.size() && !isNewlineAt(pos, len)) {
+        if ((uint8_t)source[pos] < 0x80) {
+            pos++;
+        } else {
+            pos += peekLen();
+        }
+    }
+    if (keepComments)
+        comments.push_back({false, string_view(source).substr(textStart, pos - textStart), start, position()});
+}
+
+bool Lexer::skipBlockComment()
+{
+    AstSourceOffset start = position();
+    size_t textStart = pos + 2;
+    pos += 2;
+    bool sawNewline = false;
+    size_t len;
+    for (;;) {
+        if (pos >= source.size()) {
+            token.start = start;
+            fail("Unterminated comment");
+        }
+        char c = source[pos];
+        if (c == '*' && pos + 1 < source.size() && source[pos + 1] == '/') {
+            break;
+        } else if (isNewlineAt(pos, len)) {
+            pos += len;
+            sawNewline = true;
+        } else if ((uint8_t)c < 0x80) {
+            pos++;
+        } else {
+            pos += peekLen();
+        }
+    }
+    size_t textEnd = pos;
+    pos += 2;
+    if (keepComments)
+        comments.push_back({true, string_view(source).substr(textStart, textEnd - textStart), start, position()});
+    return sawNewline;
+}
+
+size_t Lexer::peekLen() const
+{
+    size_t len;
+    peekCodePoint(len);
+    return len;
+}
+
+void Lexer::next()
+{
+    token.newlineBefore = skipSpaceAndComments();
+    token.value.clear();
+    token.number = 0;
+    token.start = pos;
+
+    if (pos >= source.size()) {
+        token.type = TokenType::EndOfFile;
+    } else {
+        auto c = (uint8_t)source[pos];
+        if (isAsciiIdentifierStart(c) || c == '\\' || c >= 0x80)
+            readName();
+        else if (isDigit(c) || (c == '.' && pos + 1 < source.size() && isDigit(source[pos + 1])))
+            readNumber();
+        else if (c == '"' || c == '\'')
+            readString(c);
+        else
+            readPunctuator();
+    }
+
+    token.end = pos;
+    token.raw = string_view(source).substr(token.start, pos - token.start);
+}
+
+uint32_t Lexer::readEscapedCodePoint()
+{
+    // Reads the part after a '\u'
+    uint32_t value = 0;
+    if (pos < source.size() && source[pos] == '{') {
+        pos++;
+        int digits = 0;
+        while (pos < source.size() && source[pos] != '}') {
+            int v = hexValue(source[pos]);
+            if (v < 0 || value > 0x10FFFF)
+                fail("Invalid Unicode escape");
+            value = value * 16 + v;
+            pos++;
+            digits++;
+        }
+        if (pos >= source.size() || !digits || value > 0x10FFFF)
+            fail("Invalid Unicode escape");
+        pos++;
+        return value;
+    }
+
+    for (int i = 0; i < 4; ++i) {
+        int v = pos < source.size() ? hexValue(source[pos]) : -1;
+        if (v < 0)
+            fail("Invalid Unicode escape");
+        value = value * 16 + v;
+        pos++;
+    }
+    return value;
+}
+
+void Lexer::readName()
+{
+    token.type = TokenType::Name;
+    bool escaped = false;
+    size_t len;
+    while (pos < source.size()) {
+        auto c = (uint8_t)source[pos];
+        if (c == '\\') {
+            if (!escaped)
+                token.value.assign(source, token.start, pos - token.start);
+            escaped = true;
+            if (pos + 1 >= source.size() || source[pos + 1] != 'u')
+                fail("Invalid escape in identifier");
+            pos += 2;
+            appendUtf8(token.value, readEscapedCodePoint());
+            continue;
+        }
+
+        uint32_t codePoint = c < 0x80 ? (len = 1, c) : peekCodePoint(len);
+        if (!isIdentifierPart(codePoint))
+            break;
+        if (escaped)
+            token.value.append(source, pos, len);
+        pos += len;
+    }
+}
+
+void Lexer::readNumber()
+{
+    token.type = TokenType::Number;
+    size_t start = pos;
+    auto at = [&](size_t i) -> char { return i < source.size() ? source[i] : '\0'; };
+
+    char prefix = at(pos + 1) | 0x20;
+    if (source[pos] == '0' && (prefix == 'x' || prefix == 'o' || prefix == 'b')) {
+        int base = prefix == 'x' ? 16 : prefix == 'o' ? 8 : 2;
+        pos += 2;
+        double value = 0;
+        size_t digitsStart = pos;
+        for (int v; (v = hexValue(at(pos))) >= 0 && v < base; pos++)
+            value = value * base + v;
+        if (pos == digitsStart)
+            fail("Expected number in radix "+to_string(base));
+        token.number = value;
+    } else if (source[pos] == '0' && isDigit(at(pos + 1))) {
+        // Legacy octal literal, unless it has an 8 or 9 in it
+        bool isOctal = true;
+        while (isDigit(at(pos))) {
+            if (source[pos] >= '8')
+                isOctal = false;
+            pos++;
+        }
+        if (isOctal) {
+            double value = 0;
+            for (size_t i = start; i < pos; ++i)
+                value = value * 8 + (source[i] - '0');
+            token.number = value;
+        } else {
+            token.number = strtod(string(source, start, pos - start).c_str(), nullptr);
+        }
+    } else {
+        while (isDigit(at(pos)))
+            pos++;
+        if (at(pos) == '.') {
+            pos++;
+            while (isDigit(at(pos)))
+                pos++;
+        }
+        if ((at(pos) | 0x20) == 'e') {
+            size_t expStart = pos++;
+            if (at(pos) == '+' || at(pos) == '-')
+                pos++;
+            if (!isDigit(at(pos))) {
+                pos = expStart;
+                fail("Invalid number");
+            }
+            while (isDigit(at(pos)))
+                pos++;
+        }
+        token.number = strtod(string(source, start, pos - start).c_str(), nullptr);
+    }
+
+    auto c = (uint8_t)at(pos);
+    if (isAsciiIdentifierStart(c) || isDigit(c) || c == '\\' || c >= 0x80)
+        fail("Identifier directly after number"); // Also catches BigInt and numeric separators, which we don't support
+}
+
+void Lexer::readString(char quote)
+{
+    token.type = TokenType::String;
+    string& value = token.value;
+    pos++;
+
+    size_t len;
+    for (;;) {
+        if (pos >= source.size())
+            fail("Unterminated string constant");
+        auto c = (uint8_t)source[pos];
+        if (c == (uint8_t)quote) {
+            pos++;
+            return;
+        } else if (c == '\\') {
+            pos++;
+            if (pos >= source.size())
+                fail("Unterminated string constant");
+            char e = source[pos];
+            if (isNewlineAt(pos, len)) { // Line continuation
+                pos += len;
+                continue;
+            }
+            if ((uint8_t)e >= 0x80) {
+                value.append(source, pos, peekLen());
+                pos += peekLen();
+                continue;
+            }
+            pos++;
+            switch (e) {
+            case 'n': value += '\n'; break;
+            case 't': value += '\t'; break;
+            case 'r': value += '\r'; break;
+            case 'b': value += '\b'; break;
+            case 'f': value += '\f'; break;
+            case 'v': value += '\v'; break;
+            case 'x': {
+                int hi = pos < source.size() ? hexValue(source[pos]) : -1;
+                int lo = pos + 1 < source.size() ? hexValue(source[pos + 1]) : -1;
+                if (hi < 0 || lo < 0)
+                    fail("Bad character escape sequence");
+                pos += 2;
+                appendUtf8(value, hi * 16 + lo);
+                break;
+            }
+            case 'u': {
+                uint32_t codePoint = readEscapedCodePoint();
+                if (codePoint >= 0xD800 && codePoint <= 0xDBFF && source.compare(pos, 2, "\\u") == 0) {
+                    State beforeLow = save();
+                    pos += 2;
+                    uint32_t low = readEscapedCodePoint();
+                    if (low >= 0xDC00 && low <= 0xDFFF) {
+                        codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (low - 0xDC00);
+                    } else {
+                        pos = beforeLow.pos;
+                    }
+                }
+                appendUtf8(value, codePoint);
+                break;
+            }
+            default:
+                if (e >= '0' && e <= '7') { // Legacy octal escapes
+                    unsigned octal = e - '0';
+                    int maxDigits = e <= '3' ? 2 : 1;
+                    for (int i = 0; i < maxDigits && pos < source.size() && source[pos] >= '0' && source[pos] <= '7'; ++i) {
+                        octal = octal * 8 + (source[pos] - '0');
+                        pos++;
+                    }
+                    appendUtf8(value, octal);
+                } else {
+                    value += e;
+                }
+            }
+        } else if (c == '\n' || c == '\r') {
+            fail("Unterminated string constant");
+        } else if (c < 0x80) {
+            size_t runStart = pos;
+            while (pos < source.size() && (uint8_t)source[pos] < 0x80 && source[pos] != quote
+                   && source[pos] != '\\' && source[pos] != '\n' && source[pos] != '\r')
+                pos++;
+            value.append(source, runStart, pos - runStart);
+        } else {
+            if (isNewlineAt(pos, len)) { // U+2028 and U+2029 are allowed in strings, but still count as line breaks
+                value.append(source, pos, len);
+                pos += len;
+                continue;
+            }
+            value.append(source, pos, peekLen());
+            pos += peekLen();
+        }
+    }
+}
+
+void Lexer::readPunctuator()
+{
+    token.type = TokenType::Punctuator;
+    auto at = [&](size_t i) -> char { return pos + i < source.size() ? source[pos + i] : '\0'; };
+
+    size_t len = 1;
+    char c = source[pos];
+    switch (c) {
+    case '{':
+        if (at(1) == '|') // Flow exact object types
+            len = 2;
+        break;
+    case '}': case '(': case ')': case '[': case ']':
+    case ';': case ',': case '~': case '?': case ':': case '@': case '#': case '`':
+        break;
+    case '.':
+        if (at(1) == '.' && at(2) == '.')
+            len = 3;
+        break;
+    case '=':
+        if (at(1) == '>')
+            len = 2;
+        else if (at(1) == '=')
+            len = at(2) == '=' ? 3 : 2;
+        break;
+    case '!':
+        if (at(1) == '=')
+            len = at(2) == '=' ? 3 : 2;
+        break;
+    case '+': case '-':
+        if (at(1) == c || at(1) == '=')
+            len = 2;
+        break;
+    case '*':
+        if (at(1) == '*')
+            len = at(2) == '=' ? 3 : 2;
+        else if (at(1) == '=')
+            len = 2;
+        break;
+    case '/': case '%': case '^':
+        if (at(1) == '=')
+            len = 2;
+        break;
+    case '&': case '|':
+        if (at(1) == c || at(1) == '=' || (c == '|' && at(1) == '}'))
+            len = 2;
+        break;
+    case '<':
+        if (at(1) == '<')
+            len = at(2) == '=' ? 3 : 2;
+        else if (at(1) == '=')
+            len = 2;
+        break;
+    case '>':
+        if (at(1) == '>') {
+            if (at(2) == '>')
+                len = at(3) == '=' ? 4 : 3;
+            else
+                len = at(2) == '=' ? 3 : 2;
+        } else if (at(1) == '=') {
+            len = 2;
+        }
+        break;
+    default:
+        fail("Unexpected character '"+string(1, c)+"'");
+    }
+    pos += len;
+}
+
+void Lexer::rescanAsRegExp()
+{
+    pos = token.start + 1;
+
+    bool inClass = false;
+    size_t len;
+    for (;;) {
+        if (pos >= source.size() || isNewlineAt(pos, len))
+            fail("Unterminated regular expression");
+        char c = source[pos];
+        if (c == '\\') {
+            pos++;
+            if (pos >= source.size() || isNewlineAt(pos, len))
+                fail("Unterminated regular expression");
+        } else if (c == '[') {
+            inClass = true;
+        } else if (c == ']') {
+            inClass = false;
+        } else if (c == '/' && !inClass) {
+            break;
+        }
+        pos += peekLen();
+    }
+    size_t patternStart = token.start + 1;
+    token.raw = string_view(source).substr(patternStart, pos - patternStart);
+    pos++;
+
+    size_t flagsStart = pos;
+    while (pos < source.size() && isAsciiIdentifierStart(source[pos])) {
+        pos++;
+    }
+    token.type = TokenType::RegExp;
+    token.value.assign(source, flagsStart, pos - flagsStart);
+    token.end = pos;
+}
+
+void Lexer::rescanAsSingleChar()
+{
+    pos = token.start + 1;
+    token.raw = token.raw.substr(0, 1);
+    token.end = pos;
+}
+
+bool Lexer::readTemplateChunk()
+{
+    token.type = TokenType::Template;
+    token.newlineBefore = false;
+    token.value.clear();
+    token.start = pos;
+
+    bool tail;
+    size_t len;
+    for (;;) {
+        if (pos >= source.size())
+            fail("Unterminated template");
+        char c = source[pos];
+        if (c == '`') {
+            tail = true;
+            break;
+        } else if (c == '$' && pos + 1 < source.size() && source[pos + 1] == '{') {
+            tail = false;
+            break;
+        } else if (c == '\\') {
+            pos++;
+            if (pos >= source.size())
+                fail("Unterminated template");
+            if (isNewlineAt(pos, len))
+                pos += len;
+            else
+                pos += peekLen();
+        } else if (isNewlineAt(pos, len)) {
+            pos += len;
+        } else {
+            pos += peekLen();
+        }
+    }
+
+    token.raw = string_view(source).substr(token.start, pos - token.start);
+    token.end = pos;
+    len = tail ? 1 : 2;
+    pos += len;
+    return tail;
+}
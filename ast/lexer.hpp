@@ -0,0 +1,87 @@
+#ifndef LEXER_HPP
+#define LEXER_HPP
+
+#include "ast/location.hpp"
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+
+enum class TokenType : uint8_t {
+    EndOfFile,
+    Name,       //< Identifiers and keywords
+    Punctuator,
+    Number,
+    String,
+    Template,   //< Only produced by Lexer::readTemplateChunk
+    RegExp,     //< Only produced by Lexer::rescanAsRegExp
+};
+
+struct Token
+{
+    TokenType type = TokenType::EndOfFile;
+    bool newlineBefore = false;
+    std::string_view raw; //< Source text of the token. For templates and regexps, this excludes the delimiters.
+    std::string value; //< Cooked value of strings and escaped names, flags of regexps
+    double number = 0;
+    AstSourceOffset start = 0, end = 0;
+
+    bool is(std::string_view punct) const { return type == TokenType::Punctuator && raw == punct; }
+    bool isName(std::string_view name) const { return type == TokenType::Name && raw == name && value.empty(); }
+    std::string_view name() const { return value.empty() ? raw : std::string_view(value); }
+};
+
+struct LexedComment
+{
+    bool isBlock;
+    std::string_view text;
+    AstSourceOffset start, end;
+};
+
+// Tokenizes JS source on demand, locations are byte offsets in the source.
+// The lexer never looks past the current token, so the parser can rescan it in a different goal (regexp, template, type).
+class Lexer {
+public:
+    struct State {
+        Token token;
+        size_t pos;
+        size_t commentsCount;
+    };
+
+    Lexer(const std::string& source, bool keepComments);
+    const Token& current() const { return token; }
+    void next();
+    State save() const;
+    void restore(const State& state);
+
+    void rescanAsRegExp(); //< Current token must be '/' or '/='
+    void rescanAsSingleChar(); //< Splits the current punctuator, e.g. '>>' into '>' (for closing nested type parameters)
+    bool readTemplateChunk(); //< Reads a template chunk starting right after the current token, returns true if it's the tail
+    AstSourceOffset templateChunkTerminatorEnd() const { return position(); } //< End of the '${' or '`' after the last chunk
+    AstSourceOffset position() const { return static_cast<AstSourceOffset>(pos); }
+
+    const std::vector<LexedComment>& getComments() const { return comments; }
+    [[noreturn]] void fail(const std::string& message) const;
+
+private:
+    bool skipSpaceAndComments(); //< Returns whether a line break was skipped
+    void skipLineComment();
+    bool skipBlockComment();
+    void readName();
+    void readNumber();
+    void readString(char quote);
+    void readPunctuator();
+    uint32_t readEscapedCodePoint();
+    uint32_t peekCodePoint(size_t& len) const;
+    size_t peekLen() const;
+    bool isNewlineAt(size_t at, size_t& len) const;
+
+private:
+    const std::string& source;
+    bool keepComments;
+    Token token;
+    size_t pos = 0;
+    std::vector<LexedComment> comments;
+};
+
+#endif // LEXER_HPP
@@ -1,44 +1,53 @@
 #include "location.hpp"
 #include "utf8/utf8.h"
+#include <algorithm>
 #include <cassert>
 
-AstSourcePosition::AstSourcePosition(unsigned offset, unsigned line, unsigned column)
-    : offset{offset}, line{line}, column{column}
-{
-}
-
-bool AstSourcePosition::operator>(const AstSourcePosition &other)
-{
-    return offset > other.offset;
-}
+using namespace std;
 
-bool AstSourcePosition::operator<(const AstSourcePosition &other)
+AstSourceSpan::AstSourceSpan(AstSourceOffset start, AstSourceOffset end)
+    : start{start}, end{end}
 {
-    return offset < other.offset;
+    assert(end >= start);
 }
 
-bool AstSourcePosition::operator>=(const AstSourcePosition &other)
+string_view AstSourceSpan::toStringView(const string& source) const
 {
-    return offset >= other.offset;
+    assert(end <= source.size());
+    return string_view(source).substr(start, end - start);
 }
 
-bool AstSourcePosition::operator<=(const AstSourcePosition &other)
+string AstSourceSpan::toString(const string& source) const
 {
-    return offset <= other.offset;
+    return string(toStringView(source));
 }
 
-AstSourceSpan::AstSourceSpan(AstSourcePosition start, AstSourcePosition end)
-    : start{start}, end{end}
+LineTable::LineTable(const string& source)
+    : source{source}
 {
-    assert(end >= start);
+    // Same line terminators as JS: LF, CRLF, CR, and the Unicode line and paragraph separators
+    lineStarts.push_back(0);
+    for (size_t i = 0; i < source.size(); ++i) {
+        char c = source[i];
+        if (c == '\n') {
+            lineStarts.push_back(i + 1);
+        } else if (c == '\r') {
+            if (i + 1 < source.size() && source[i + 1] == '\n')
+                ++i;
+            lineStarts.push_back(i + 1);
+        } else if (c == '\xE2' && i + 2 < source.size() && source[i + 1] == '\x80'
+                   && (source[i + 2] == '\xA8' || source[i + 2] == '\xA9')) {
+            i += 2;
+            lineStarts.push_back(i + 1);
+        }
+    }
 }
 
-std::string AstSourceSpan::toString(const std::string &source)
+AstSourcePosition LineTable::position(AstSourceOffset offset) const
 {
-    const char* beg_ptr = source.data();
-    utf8::unchecked::advance(beg_ptr, start.offset);
-    const char* end_ptr = beg_ptr;
-    utf8::unchecked::advance(end_ptr, end.offset-start.offset);
-
-    return std::string(beg_ptr, end_ptr);
+    assert(offset <= source.size());
+    auto lineIt = upper_bound(lineStarts.begin(), lineStarts.end(), offset) - 1;
+    const char* lineStart = source.data() + *lineIt;
+    auto column = utf8::unchecked::distance(lineStart, source.data() + offset);
+    return {static_cast<unsigned>(lineIt - lineStarts.begin() + 1), static_cast<unsigned>(column)};
 }
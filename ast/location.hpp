@@ -2,28 +2,39 @@
 #define LOCATION_HPP
 
 #include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
 
+// Byte offset in a module's original source
+using AstSourceOffset = uint32_t;
+
+// Human readable position, computed on demand with a LineTable
 struct AstSourcePosition
 {
-    AstSourcePosition(unsigned offset, unsigned line, unsigned column);
+    unsigned line; //< From 1
+    unsigned column; //< From 0, in characters
+};
 
-    /// Note that those are character counts, ant NOT byte counts!
-    unsigned offset;
-    unsigned line;
-    unsigned column;
+struct AstSourceSpan
+{
+    AstSourceSpan(AstSourceOffset start, AstSourceOffset end);
+    std::string_view toStringView(const std::string& source) const;
+    std::string toString(const std::string& source) const;
 
-    bool operator>(const AstSourcePosition& other);
-    bool operator<(const AstSourcePosition& other);
-    bool operator>=(const AstSourcePosition& other);
-    bool operator<=(const AstSourcePosition& other);
+    AstSourceOffset start, end;
 };
 
-struct AstSourceSpan
+// Offsets of the start of each line, so a position only costs a binary search and counting characters in one line
+class LineTable
 {
-    AstSourceSpan(AstSourcePosition start, AstSourcePosition end);
-    std::string toString(const std::string& source); // NOTE: This is slow, due to UTF8 processing
+public:
+    explicit LineTable(const std::string& source);
+    AstSourcePosition position(AstSourceOffset offset) const;
 
-    AstSourcePosition start, end;
+private:
+    const std::string& source;
+    std::vector<AstSourceOffset> lineStarts;
 };
 
 #endif // LOCATION_HPP
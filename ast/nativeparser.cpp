@@ -0,0 +1,2337 @@
+#include "ast/nativeparser.hpp"
+#include "ast/lexer.hpp"
+#include "ast/ast.hpp"
+#include <stdexcept>
+#include <unordered_set>
+#include <optional>
+
+using namespace std;
+
+static const unordered_set<string_view> reservedWords = {
+    "break", "case", "catch", "class", "const", "continue", "debugger", "default", "delete", "do", "else", "enum",
+    "export", "extends", "false", "finally", "for", "function", "if", "import", "in", "instanceof", "new", "null",
+    "return", "super", "switch", "this", "throw", "true", "try", "typeof", "var", "void", "while", "with",
+};
+
+static bool isReserved(const Token& token)
+{
+    return token.type == TokenType::Name && reservedWords.count(token.name());
+}
+
+static int binaryPrecedence(const Token& token, bool noIn)
+{
+    if (token.type == TokenType::Name) {
+        if (token.isName("instanceof") || (token.isName("in") && !noIn))
+            return 7;
+        return -1;
+    } else if (token.type != TokenType::Punctuator) {
+        return -1;
+    }
+
+    string_view op = token.raw;
+    if (op == "||")
+        return 1;
+    else if (op == "&&")
+        return 2;
+    else if (op == "|")
+        return 3;
+    else if (op == "^")
+        return 4;
+    else if (op == "&")
+        return 5;
+    else if (op == "==" || op == "!=" || op == "===" || op == "!==")
+        return 6;
+    else if (op == "<" || op == ">" || op == "<=" || op == ">=")
+        return 7;
+    else if (op == "<<" || op == ">>" || op == ">>>")
+        return 8;
+    else if (op == "+" || op == "-")
+        return 9;
+    else if (op == "*" || op == "/" || op == "%")
+        return 10;
+    else if (op == "**")
+        return 11;
+    return -1;
+}
+
+static BinaryExpression::Operator toBinaryOperator(string_view op)
+{
+    using Operator = BinaryExpression::Operator;
+    if (op == "==")
+        return Operator::Equal;
+    else if (op == "!=")
+        return Operator::NotEqual;
+    else if (op == "===")
+        return Operator::StrictEqual;
+    else if (op == "!==")
+        return Operator::StrictNotEqual;
+    else if (op == "<")
+        return Operator::Lesser;
+    else if (op == "<=")
+        return Operator::LesserOrEqual;
+    else if (op == ">")
+        return Operator::Greater;
+    else if (op == ">=")
+        return Operator::GreaterOrEqual;
+    else if (op == "<<")
+        return Operator::ShiftLeft;
+    else if (op == ">>")
+        return Operator::SignShiftRight;
+    else if (op == ">>>")
+        return Operator::ZeroingShiftRight;
+    else if (op == "+")
+        return Operator::Plus;
+    else if (op == "-")
+        return Operator::Minus;
+    else if (op == "*")
+        return Operator::Times;
+    else if (op == "/")
+        return Operator::Division;
+    else if (op == "%")
+        return Operator::Modulo;
+    else if (op == "**")
+        return Operator::Exponentiation;
+    else if (op == "|")
+        return Operator::BitwiseOr;
+    else if (op == "^")
+        return Operator::BitwiseXor;
+    else if (op == "&")
+        return Operator::BitwiseAnd;
+    else if (op == "in")
+        return Operator::In;
+    else if (op == "instanceof")
+        return Operator::Instanceof;
+    throw runtime_error("Unknown binary operator "s + string(op));
+}
+
+static optional<AssignmentExpression::Operator> toAssignmentOperator(const Token& token)
+{
+    using Operator = AssignmentExpression::Operator;
+    if (token.type != TokenType::Punctuator || token.raw.back() != '=')
+        return nullopt;
+
+    string_view op = token.raw;
+    if (op == "=")
+        return Operator::Equal;
+    else if (op == "+=")
+        return Operator::PlusEqual;
+    else if (op == "-=")
+        return Operator::MinusEqual;
+    else if (op == "*=")
+        return Operator::TimesEqual;
+    else if (op == "/=")
+        return Operator::SlashEqual;
+    else if (op == "%=")
+        return Operator::ModuloEqual;
+    else if (op == "**=")
+        return Operator::ExponentiationEqual;
+    else if (op == "<<=")
+        return Operator::LeftShiftEqual;
+    else if (op == ">>=")
+        return Operator::SignRightShiftEqual;
+    else if (op == ">>>=")
+        return Operator::ZeroingRightShiftEqual;
+    else if (op == "|=")
+        return Operator::OrEqual;
+    else if (op == "^=")
+        return Operator::XorEqual;
+    else if (op == "&=")
+        return Operator::AndEqual;
+    return nullopt;
+}
+
+static optional<UnaryExpression::Operator> toUnaryOperator(const Token& token)
+{
+    using Operator = UnaryExpression::Operator;
+    if (token.is("-"))
+        return Operator::Minus;
+    else if (token.is("+"))
+        return Operator::Plus;
+    else if (token.is("!"))
+        return Operator::LogicalNot;
+    else if (token.is("~"))
+        return Operator::BitwiseNot;
+    else if (token.isName("typeof"))
+        return Operator::Typeof;
+    else if (token.isName("void"))
+        return Operator::Void;
+    else if (token.isName("delete"))
+        return Operator::Delete;
+    return nullopt;
+}
+
+// Template raw values have their line endings normalized, like Babel does
+static string normalizeTemplateRaw(string_view raw)
+{
+    string result;
+    result.reserve(raw.size());
+    for (size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] == '\r') {
+            result += '\n';
+            if (i + 1 < raw.size() && raw[i + 1] == '\n')
+                ++i;
+        } else {
+            result += raw[i];
+        }
+    }
+    return result;
+}
+
+class NativeParser {
+public:
+    NativeParser(Module& parentModule, const string& source, bool keepComments);
+    AstRoot* parseProgram();
+
+private:
+    struct Flags {
+        bool inAsync = false;
+        bool inGenerator = false;
+        bool noAnonFunctionType = false; //< In arrow return types, 'A => B' is not a function type
+    };
+
+    struct Checkpoint {
+        Lexer::State lexerState;
+        AstArena::Mark arenaMark;
+        AstSourceOffset lastEnd;
+        Flags flags;
+    };
+
+    // Nodes can only be created once their children are parsed, so never call a parse function in the arguments of make!
+    template <class T, class... Args> T* make(AstSourceOffset start, Args&&... args);
+    template <class T, class... Args> T* makeAt(AstSourceSpan location, Args&&... args);
+    Identifier* cloneIdentifier(Identifier* id);
+    Checkpoint checkpoint() const;
+    void rewind(const Checkpoint& checkpoint);
+    void discardNodes(size_t begin, size_t end);
+
+    const Token& tok() const { return lexer.current(); }
+    Token peek();
+    void next();
+    bool eat(string_view punct);
+    bool eatName(string_view name);
+    void expect(string_view punct);
+    void expectName(string_view name);
+    void semicolon();
+    bool canInsertSemicolon() const;
+    [[noreturn]] void unexpected() const;
+    [[noreturn]] void unsupported(const string& what) const;
+
+    // Statements
+    vector<AstNode*> parseStatementList(bool allowDirectives);
+    AstNode* parseStatement();
+    AstNode* parseBlock(bool allowDirectives = false);
+    AstNode* parseFunctionBody(bool isAsync, bool isGenerator);
+    bool isLetDeclaration();
+    VariableDeclaration* parseVar(AstSourceOffset start, bool isFor);
+    AstNode* parseIf(AstSourceOffset start);
+    AstNode* parseFor(AstSourceOffset start);
+    AstNode* parseSwitch(AstSourceOffset start);
+    AstNode* parseTry(AstSourceOffset start);
+    AstNode* parseImport(AstSourceOffset start);
+    AstNode* parseExport(AstSourceOffset start);
+    vector<AstNode*> parseExportSpecifiers();
+
+    // Functions and classes
+    AstNode* parseFunction(AstSourceOffset start, bool isStatement, bool isAsync, bool allowAnonymous = false);
+    vector<AstNode*> parseFunctionParams();
+    struct ArrowHead {
+        TypeParameterDeclaration* typeParameters;
+        vector<AstNode*> params;
+        TypeAnnotation* returnType;
+    };
+    ArrowHead parseArrowHead(); //< Everything up to and including the '=>'
+    AstNode* finishArrow(AstSourceOffset start, ArrowHead head, bool isAsync);
+    AstNode* parseArrowFromParens(AstSourceOffset start, bool isAsync);
+    AstNode* parseArrowFromIdentifier(AstSourceOffset start, Identifier* param, bool isAsync);
+    AstNode* parseArrowBody(bool isAsync, bool& isExpression);
+    AstNode* parseClass(AstSourceOffset start, bool isStatement, bool allowAnonymous = false);
+    AstNode* parseClassMember();
+    AstNode* parsePropertyKey(bool& computed);
+    bool isPropertyKeyEnd();
+
+    // Patterns
+    Identifier* parseBindingIdentifier(bool allowTypes, bool allowOptional);
+    AstNode* parseBindingAtom(bool isBinding, bool allowTypes);
+    AstNode* parseBindingElement(bool isBinding);
+    AstNode* parseRestElement(bool isBinding, bool allowTypes);
+
+    // Expressions
+    AstNode* parseExpression(bool noIn = false);
+    AstNode* parseMaybeAssign(bool noIn = false);
+    AstNode* parseYield(bool noIn);
+    AstNode* parseMaybeConditional(bool noIn);
+    AstNode* parseExprOps(bool noIn);
+    AstNode* parseMaybeUnary();
+    AstNode* parseExprSubscripts();
+    AstNode* parseSubscripts(AstNode* base, AstSourceOffset start, bool noCalls);
+    AstNode* parseNew();
+    vector<AstNode*> parseCallArguments();
+    AstNode* parseExprAtom();
+    AstNode* parseLiteral();
+    AstNode* parseParenExpression();
+    AstNode* parseParenContents();
+    AstNode* parseArrayLiteral();
+    AstNode* parseObjectLiteral();
+    AstNode* parseTemplate();
+    Identifier* parseIdentifier(bool allowReserved = false);
+    bool startsExpression(const Token& token) const;
+
+    // Flow
+    TypeAnnotation* parseTypeAnnotation();
+    AstNode* parseType();
+    AstNode* parseIntersectionType();
+    AstNode* parseAnonFunctionWithoutParens();
+    AstNode* parsePrefixType();
+    AstNode* parsePostfixType();
+    AstNode* parsePrimaryType();
+    AstNode* parseGenericType();
+    AstNode* parseParenType(AstSourceOffset start);
+    FunctionTypeParam* parseFunctionTypeParam();
+    void parseFunctionTypeParams(vector<FunctionTypeParam*>& params, FunctionTypeParam*& rest);
+    AstNode* parseObjectType(bool allowStatic, bool allowSpread);
+    AstNode* parseObjectTypeMethodish(AstSourceOffset start);
+    TypeParameterDeclaration* parseTypeParameterDeclaration();
+    TypeParameterInstantiation* parseTypeParameterInstantiation();
+    void expectTypeClose();
+    AstNode* parseTypeAlias(AstSourceOffset start);
+    AstNode* parseInterface(AstSourceOffset start);
+    InterfaceExtends* parseInterfaceExtends();
+    AstNode* parseDeclare(AstSourceOffset start);
+    AstNode* parseDeclareBody(AstSourceOffset start, bool insideModule);
+
+private:
+    Module& parentModule;
+    Lexer lexer;
+    AstSourceOffset lastEnd = 0; //< End of the last consumed token, where nodes finish
+    Flags flags;
+    unique_ptr<AstArena> arena; //< Handed to the root once parsed, so everything is freed if we fail
+    AstArena::Scope arenaScope;
+};
+
+NativeParser::NativeParser(Module& parentModule, const string& source, bool keepComments)
+    : parentModule{parentModule}
+    , lexer{source, keepComments}
+    , arena{make_unique<AstArena>()}
+    , arenaScope{*arena}
+{
+}
+
+template <class T, class... Args>
+T* NativeParser::make(AstSourceOffset start, Args&&... args)
+{
+    return makeAt<T>({start, lastEnd}, forward<Args>(args)...);
+}
+
+template <class T, class... Args>
+T* NativeParser::makeAt(AstSourceSpan location, Args&&... args)
+{
+    return new T(location, forward<Args>(args)...);
+}
+
+Identifier* NativeParser::cloneIdentifier(Identifier* id)
+{
+    // Babel clones shorthand keys into a separate value node with the same location
+    return makeAt<Identifier>(id->getLocation(), id->getName(), nullptr, false);
+}
+
+NativeParser::Checkpoint NativeParser::checkpoint() const
+{
+    return {lexer.save(), arena->mark(), lastEnd, flags};
+}
+
+void NativeParser::rewind(const Checkpoint& checkpoint)
+{
+    lexer.restore(checkpoint.lexerState);
+    arena->rewind(checkpoint.arenaMark);
+    lastEnd = checkpoint.lastEnd;
+    flags = checkpoint.flags;
+}
+
+void NativeParser::discardNodes(size_t begin, size_t end)
+{
+    arena->destroyNodes(begin, end);
+}
+
+Token NativeParser::peek()
+{
+    Lexer::State state = lexer.save();
+    lexer.next();
+    Token result = lexer.current();
+    lexer.restore(state);
+    return result;
+}
+
+void NativeParser::next()
+{
+    lastEnd = tok().end;
+    lexer.next();
+}
+
+bool NativeParser::eat(string_view punct)
+{
+    if (!tok().is(punct))
+        return false;
+    next();
+    return true;
+}
+
+bool NativeParser::eatName(string_view name)
+{
+    if (!tok().isName(name))
+        return false;
+    next();
+    return true;
+}
+
+void NativeParser::expect(string_view punct)
+{
+    if (!eat(punct))
+        unexpected();
+}
+
+void NativeParser::expectName(string_view name)
+{
+    if (!eatName(name))
+        unexpected();
+}
+
+bool NativeParser::canInsertSemicolon() const
+{
+    return tok().type == TokenType::EndOfFile || tok().is("}") || tok().newlineBefore;
+}
+
+void NativeParser::semicolon()
+{
+    if (!eat(";") && !canInsertSemicolon())
+        unexpected();
+}
+
+void NativeParser::unexpected() const
+{
+    if (tok().type == TokenType::EndOfFile)
+        lexer.fail("Unexpected end of input");
+    lexer.fail("Unexpected token '"+string(tok().raw)+"'");
+}
+
+void NativeParser::unsupported(const string& what) const
+{
+    lexer.fail(what+" are not supported");
+}
+
+AstRoot* NativeParser::parseProgram()
+{
+    lexer.next();
+    vector<AstNode*> body = parseStatementList(true);
+    if (tok().type != TokenType::EndOfFile)
+        unexpected();
+    AstSourceSpan location{0, tok().end};
+
+    vector<AstComment*> comments;
+    for (const auto& comment : lexer.getComments()) {
+        auto type = comment.isBlock ? AstComment::Type::Block : AstComment::Type::Line;
+        comments.push_back(makeAt<AstComment>({comment.start, comment.end}, type, string(comment.text)));
+    }
+
+    return new AstRoot(location, parentModule, move(body), move(comments), move(arena));
+}
+
+vector<AstNode*> NativeParser::parseStatementList(bool allowDirectives)
+{
+    vector<AstNode*> body;
+    bool inPrologue = allowDirectives;
+    while (tok().type != TokenType::EndOfFile && !tok().is("}")) {
+        if (inPrologue && tok().type == TokenType::String) {
+            // Babel moves directives out of the body, we just drop them
+            size_t nodesCount = arena->nodeCount();
+            AstSourceOffset start = tok().start;
+            AstNode* statement = parseStatement();
+            if (statement->getType() == AstNodeType::ExpressionStatement) {
+                AstNode* expr = ((ExpressionStatement*)statement)->getExpression();
+                if (expr->getType() == AstNodeType::StringLiteral && expr->getLocation().start == start) {
+                    discardNodes(nodesCount, arena->nodeCount());
+                    continue;
+                }
+            }
+            inPrologue = false;
+            body.push_back(statement);
+            continue;
+        }
+        inPrologue = false;
+        body.push_back(parseStatement());
+    }
+    return body;
+}
+
+AstNode* NativeParser::parseBlock(bool allowDirectives)
+{
+    AstSourceOffset start = tok().start;
+    expect("{");
+    vector<AstNode*> body = parseStatementList(allowDirectives);
+    expect("}");
+    return make<BlockStatement>(start, move(body));
+}
+
+AstNode* NativeParser::parseFunctionBody(bool isAsync, bool isGenerator)
+{
+    Flags outerFlags = flags;
+    flags = {};
+    flags.inAsync = isAsync;
+    flags.inGenerator = isGenerator;
+    AstNode* body = parseBlock(true);
+    flags = outerFlags;
+    return body;
+}
+
+bool NativeParser::isLetDeclaration()
+{
+    if (!tok().isName("let"))
+        return false;
+    Token nextToken = peek();
+    return nextToken.type == TokenType::Name || nextToken.is("[") || nextToken.is("{");
+}
+
+AstNode* NativeParser::parseStatement()
+{
+    const Token& t = tok();
+    AstSourceOffset start = t.start;
+
+    if (t.is("{")) {
+        return parseBlock();
+    } else if (t.is(";")) {
+        next();
+        return make<EmptyStatement>(start);
+    } else if (t.type == TokenType::Name && t.value.empty()) {
+        string_view name = t.raw;
+        if (name == "var" || name == "const" || isLetDeclaration()) {
+            return parseVar(start, false);
+        } else if (name == "function") {
+            return parseFunction(start, true, false);
+        } else if (name == "async") {
+            Token nextToken = peek();
+            if (nextToken.isName("function") && !nextToken.newlineBefore) {
+                next();
+                return parseFunction(start, true, true);
+            }
+        } else if (name == "class") {
+            return parseClass(start, true);
+        } else if (name == "if") {
+            return parseIf(start);
+        } else if (name == "for") {
+            return parseFor(start);
+        } else if (name == "while") {
+            next();
+            expect("(");
+            AstNode* test = parseExpression();
+            expect(")");
+            AstNode* body = parseStatement();
+            return make<WhileStatement>(start, test, body);
+        } else if (name == "do") {
+            next();
+            AstNode* body = parseStatement();
+            expectName("while");
+            expect("(");
+            AstNode* test = parseExpression();
+            expect(")");
+            eat(";");
+            return make<DoWhileStatement>(start, test, body);
+        } else if (name == "return") {
+            next();
+            AstNode* argument = nullptr;
+            if (!tok().is(";") && !canInsertSemicolon())
+                argument = parseExpression();
+            semicolon();
+            return make<ReturnStatement>(start, argument);
+        } else if (name == "break" || name == "continue") {
+            bool isBreak = name == "break";
+            next();
+            AstNode* label = nullptr;
+            if (tok().type == TokenType::Name && !tok().newlineBefore && !isReserved(tok()))
+                label = parseIdentifier();
+            semicolon();
+            if (isBreak)
+                return make<BreakStatement>(start, label);
+            return make<ContinueStatement>(start, label);
+        } else if (name == "throw") {
+            next();
+            if (tok().newlineBefore)
+                lexer.fail("Illegal newline after throw");
+            AstNode* argument = parseExpression();
+            semicolon();
+            return make<ThrowStatement>(start, argument);
+        } else if (name == "try") {
+            return parseTry(start);
+        } else if (name == "switch") {
+            return parseSwitch(start);
+        } else if (name == "with") {
+            next();
+            expect("(");
+            AstNode* object = parseExpression();
+            expect(")");
+            AstNode* body = parseStatement();
+            return make<WithStatement>(start, object, body);
+        } else if (name == "debugger") {
+            next();
+            semicolon();
+            return make<DebuggerStatement>(start);
+        } else if (name == "import") {
+            Token nextToken = peek();
+            if (!nextToken.is("(") && !nextToken.is("."))
+                return parseImport(start);
+        } else if (name == "export") {
+            return parseExport(start);
+        } else if (name == "type" || name == "interface" || name == "declare" || name == "opaque") {
+            Token nextToken = peek();
+            bool nextIsName = nextToken.type == TokenType::Name && !isReserved(nextToken);
+            if (name == "type" && nextIsName) {
+                next();
+                return parseTypeAlias(start);
+            } else if (name == "interface" && nextIsName) {
+                next();
+                return parseInterface(start);
+            } else if (name == "declare" && (nextIsName || nextToken.isName("class") || nextToken.isName("function")
+                                             || nextToken.isName("var") || nextToken.isName("export"))) {
+                return parseDeclare(start);
+            } else if (name == "opaque" && nextIsName) {
+                unsupported("Opaque types");
+            }
+        }
+    }
+
+    AstNode* expr = parseExpression();
+    if (expr->getType() == AstNodeType::Identifier && tok().is(":") && expr->getLocation().start == start) {
+        next();
+        AstNode* body = parseStatement();
+        return make<LabeledStatement>(start, expr, body);
+    }
+    semicolon();
+    return make<ExpressionStatement>(start, expr);
+}
+
+VariableDeclaration* NativeParser::parseVar(AstSourceOffset start, bool isFor)
+{
+    using Kind = VariableDeclaration::Kind;
+    Kind kind = tok().isName("var") ? Kind::Var : tok().isName("let") ? Kind::Let : Kind::Const;
+    next();
+
+    vector<VariableDeclarator*> declarators;
+    do {
+        AstSourceOffset declStart = tok().start;
+        AstNode* id = parseBindingAtom(true, true);
+        AstNode* init = nullptr;
+        if (eat("="))
+            init = parseMaybeAssign(isFor);
+        declarators.push_back(make<VariableDeclarator>(declStart, id, init));
+    } while (eat(","));
+
+    if (!isFor)
+        semicolon();
+    return make<VariableDeclaration>(start, move(declarators), kind);
+}
+
+AstNode* NativeParser::parseIf(AstSourceOffset start)
+{
+    next();
+    expect("(");
+    AstNode* test = parseExpression();
+    expect(")");
+    AstNode* consequent = parseStatement();
+    AstNode* alternate = nullptr;
+    if (eatName("else"))
+        alternate = parseStatement();
+    return make<IfStatement>(start, test, consequent, alternate);
+}
+
+AstNode* NativeParser::parseFor(AstSourceOffset start)
+{
+    next();
+    bool isAwait = flags.inAsync && eatName("await");
+    expect("(");
+
+    AstNode* init = nullptr;
+    if (tok().is(";")) {
+        // Nothing to initialize
+    } else if (tok().isName("var") || tok().isName("const") || isLetDeclaration()) {
+        init = parseVar(tok().start, true);
+    } else if (tok().is("[") || tok().is("{")) {
+        Checkpoint beforePattern = checkpoint();
+        try {
+            init = parseBindingAtom(false, false);
+            if (!tok().isName("of") && !tok().isName("in"))
+                unexpected();
+        } catch (const runtime_error&) {
+            rewind(beforePattern);
+            init = parseExpression(true);
+        }
+    } else {
+        init = parseExpression(true);
+    }
+
+    if (init && (tok().isName("of") || tok().isName("in"))) {
+        bool isOf = tok().isName("of");
+        next();
+        AstNode* right = isOf ? parseMaybeAssign() : parseExpression();
+        expect(")");
+        AstNode* body = parseStatement();
+        if (isOf)
+            return make<ForOfStatement>(start, init, right, body, isAwait);
+        return make<ForInStatement>(start, init, right, body);
+    }
+
+    expect(";");
+    AstNode* test = tok().is(";") ? nullptr : parseExpression();
+    expect(";");
+    AstNode* update = tok().is(")") ? nullptr : parseExpression();
+    expect(")");
+    AstNode* body = parseStatement();
+    return make<ForStatement>(start, init, test, update, body);
+}
+
+AstNode* NativeParser::parseSwitch(AstSourceOffset start)
+{
+    next();
+    expect("(");
+    AstNode* discriminant = parseExpression();
+    expect(")");
+    expect("{");
+
+    vector<SwitchCase*> cases;
+    while (!eat("}")) {
+        AstSourceOffset caseStart = tok().start;
+        AstNode* test = nullptr;
+        if (eatName("case"))
+            test = parseExpression();
+        else
+            expectName("default");
+        expect(":");
+
+        vector<AstNode*> consequent;
+        while (!tok().is("}") && !tok().isName("case") && !tok().isName("default") && tok().type != TokenType::EndOfFile)
+            consequent.push_back(parseStatement());
+        cases.push_back(make<SwitchCase>(caseStart, test, move(consequent)));
+    }
+    return make<SwitchStatement>(start, discriminant, move(cases));
+}
+
+AstNode* NativeParser::parseTry(AstSourceOffset start)
+{
+    next();
+    AstNode* block = parseBlock();
+
+    AstNode* handler = nullptr;
+    if (tok().isName("catch")) {
+        AstSourceOffset catchStart = tok().start;
+        next();
+        AstNode* param = nullptr;
+        if (eat("(")) {
+            param = parseBindingAtom(true, false);
+            expect(")");
+        }
+        AstNode* body = parseBlock();
+        handler = make<CatchClause>(catchStart, param, body);
+    }
+
+    AstNode* finalizer = nullptr;
+    if (eatName("finally"))
+        finalizer = parseBlock();
+    if (!handler && !finalizer)
+        lexer.fail("Missing catch or finally clause");
+    return make<TryStatement>(start, block, handler, finalizer);
+}
+
+AstNode* NativeParser::parseImport(AstSourceOffset start)
+{
+    using Kind = ImportDeclaration::Kind;
+    next();
+
+    vector<AstNode*> specifiers;
+    Kind kind = Kind::None;
+    if (tok().type != TokenType::String) {
+        kind = Kind::Value;
+        if (tok().isName("type") || tok().isName("typeof")) {
+            Token nextToken = peek();
+            if ((nextToken.type == TokenType::Name && !nextToken.isName("from")) || nextToken.is("{") || nextToken.is("*")) {
+                if (tok().isName("typeof"))
+                    unsupported("Typeof imports");
+                kind = Kind::Type;
+                next();
+            }
+        }
+
+        bool hasMoreSpecifiers = true;
+        if (tok().type == TokenType::Name) {
+            AstSourceOffset specStart = tok().start;
+            Identifier* local = parseIdentifier();
+            specifiers.push_back(make<ImportDefaultSpecifier>(specStart, local));
+            hasMoreSpecifiers = eat(",");
+        }
+
+        if (!hasMoreSpecifiers) {
+            // Only a default import
+        } else if (tok().is("*")) {
+            AstSourceOffset specStart = tok().start;
+            next();
+            expectName("as");
+            Identifier* local = parseIdentifier();
+            specifiers.push_back(make<ImportNamespaceSpecifier>(specStart, local));
+        } else {
+            expect("{");
+            while (!eat("}")) {
+                AstSourceOffset specStart = tok().start;
+                bool isTypeImport = false;
+                if (tok().isName("type") || tok().isName("typeof")) {
+                    Token nextToken = peek();
+                    if (nextToken.type == TokenType::Name && !nextToken.isName("as")) {
+                        isTypeImport = tok().isName("type"); // Babel marks typeof imports differently, and we import those as values
+                        next();
+                    }
+                }
+                Identifier* imported = parseIdentifier(true);
+                Identifier* local;
+                if (eatName("as")) {
+                    local = parseIdentifier();
+                } else {
+                    if (reservedWords.count(imported->getName()))
+                        unexpected();
+                    local = cloneIdentifier(imported);
+                }
+                specifiers.push_back(make<ImportSpecifier>(specStart, local, imported, isTypeImport));
+                if (!tok().is("}"))
+                    expect(",");
+            }
+        }
+        expectName("from");
+    }
+
+    if (tok().type != TokenType::String)
+        unexpected();
+    AstNode* source = parseLiteral();
+    semicolon();
+    return make<ImportDeclaration>(start, move(specifiers), source, kind);
+}
+
+vector<AstNode*> NativeParser::parseExportSpecifiers()
+{
+    vector<AstNode*> specifiers;
+    expect("{");
+    while (!eat("}")) {
+        AstSourceOffset specStart = tok().start;
+        Identifier* local = parseIdentifier(true);
+        Identifier* exported = eatName("as") ? parseIdentifier(true) : cloneIdentifier(local);
+        specifiers.push_back(make<ExportSpecifier>(specStart, local, exported));
+        if (!tok().is("}"))
+            expect(",");
+    }
+    return specifiers;
+}
+
+AstNode* NativeParser::parseExport(AstSourceOffset start)
+{
+    using Kind = ExportNamedDeclaration::Kind;
+    next();
+
+    if (tok().is("*")) {
+        next();
+        if (tok().isName("as"))
+            unsupported("Namespace exports");
+        expectName("from");
+        if (tok().type != TokenType::String)
+            unexpected();
+        AstNode* source = parseLiteral();
+        semicolon();
+        return make<ExportAllDeclaration>(start, source);
+    } else if (eatName("default")) {
+        AstSourceOffset declStart = tok().start;
+        AstNode* declaration;
+        if (tok().isName("function")) {
+            declaration = parseFunction(declStart, true, false, true);
+        } else if (tok().isName("async") && peek().isName("function")) {
+            next();
+            declaration = parseFunction(declStart, true, true, true);
+        } else if (tok().isName("class")) {
+            declaration = parseClass(declStart, true, true);
+        } else {
+            declaration = parseMaybeAssign();
+            semicolon();
+        }
+        return make<ExportDefaultDeclaration>(start, declaration);
+    } else if (tok().is("{")) {
+        vector<AstNode*> specifiers = parseExportSpecifiers();
+        AstNode* source = nullptr;
+        if (eatName("from")) {
+            if (tok().type != TokenType::String)
+                unexpected();
+            source = parseLiteral();
+        }
+        semicolon();
+        return make<ExportNamedDeclaration>(start, nullptr, source, move(specifiers), Kind::Value);
+    } else if (tok().isName("type") || tok().isName("interface")) {
+        AstSourceOffset declStart = tok().start;
+        bool isInterface = tok().isName("interface");
+        next();
+        if (!isInterface && tok().is("{")) {
+            vector<AstNode*> specifiers = parseExportSpecifiers();
+            AstNode* source = nullptr;
+            if (eatName("from")) {
+                if (tok().type != TokenType::String)
+                    unexpected();
+                source = parseLiteral();
+            }
+            semicolon();
+            return make<ExportNamedDeclaration>(start, nullptr, source, move(specifiers), Kind::Type);
+        }
+        AstNode* declaration = isInterface ? parseInterface(declStart) : parseTypeAlias(declStart);
+        return make<ExportNamedDeclaration>(start, declaration, nullptr, vector<AstNode*>{}, Kind::Type);
+    } else if (tok().isName("var") || tok().isName("let") || tok().isName("const") || tok().isName("function")
+               || tok().isName("class") || tok().isName("async")) {
+        AstNode* declaration = parseStatement();
+        return make<ExportNamedDeclaration>(start, declaration, nullptr, vector<AstNode*>{}, Kind::Value);
+    } else if (tok().isName("opaque")) {
+        unsupported("Opaque types");
+    } else if (tok().type == TokenType::Name) {
+        unsupported("Default specifier exports");
+    }
+    unexpected();
+}
+
+AstNode* NativeParser::parseFunction(AstSourceOffset start, bool isStatement, bool isAsync, bool allowAnonymous)
+{
+    expectName("function");
+    bool isGenerator = eat("*");
+
+    AstNode* id = nullptr;
+    if (tok().type == TokenType::Name)
+        id = parseBindingIdentifier(false, false);
+    else if (isStatement && !allowAnonymous)
+        unexpected();
+
+    TypeParameterDeclaration* typeParameters = tok().is("<") ? parseTypeParameterDeclaration() : nullptr;
+    vector<AstNode*> params = parseFunctionParams();
+    TypeAnnotation* returnType = tok().is(":") ? parseTypeAnnotation() : nullptr;
+    AstNode* body = parseFunctionBody(isAsync, isGenerator);
+
+    if (isStatement)
+        return make<FunctionDeclaration>(start, id, move(params), body, typeParameters, returnType, isGenerator, isAsync);
+    return make<FunctionExpression>(start, id, move(params), body, typeParameters, returnType, isGenerator, isAsync);
+}
+
+vector<AstNode*> NativeParser::parseFunctionParams()
+{
+    vector<AstNode*> params;
+    expect("(");
+    while (!tok().is(")")) {
+        if (tok().is("...")) {
+            params.push_back(parseRestElement(true, true));
+            break;
+        }
+
+        AstSourceOffset start = tok().start;
+        AstNode* param = parseBindingAtom(true, true);
+        if (eat("=")) {
+            AstNode* right = parseMaybeAssign();
+            param = make<AssignmentPattern>(start, param, right);
+        }
+        params.push_back(param);
+        if (!tok().is(")"))
+            expect(",");
+    }
+    expect(")");
+    return params;
+}
+
+AstNode* NativeParser::parseArrowBody(bool isAsync, bool& isExpression)
+{
+    Flags outerFlags = flags;
+    flags = {};
+    flags.inAsync = isAsync;
+
+    AstNode* body;
+    isExpression = !tok().is("{");
+    if (isExpression)
+        body = parseMaybeAssign();
+    else
+        body = parseBlock(true);
+
+    flags = outerFlags;
+    return body;
+}
+
+NativeParser::ArrowHead NativeParser::parseArrowHead()
+{
+    TypeParameterDeclaration* typeParameters = tok().is("<") ? parseTypeParameterDeclaration() : nullptr;
+    vector<AstNode*> params = parseFunctionParams();
+
+    TypeAnnotation* returnType = nullptr;
+    if (tok().is(":")) {
+        bool outerNoAnonFunctionType = flags.noAnonFunctionType;
+        flags.noAnonFunctionType = true;
+        returnType = parseTypeAnnotation();
+        flags.noAnonFunctionType = outerNoAnonFunctionType;
+    }
+
+    if (!tok().is("=>") || tok().newlineBefore)
+        unexpected();
+    next();
+    return {typeParameters, move(params), returnType};
+}
+
+AstNode* NativeParser::finishArrow(AstSourceOffset start, ArrowHead head, bool isAsync)
+{
+    bool isExpression;
+    AstNode* body = parseArrowBody(isAsync, isExpression);
+    return make<ArrowFunctionExpression>(start, nullptr, move(head.params), body, head.typeParameters, head.returnType,
+                                         false, isAsync, isExpression);
+}
+
+AstNode* NativeParser::parseArrowFromParens(AstSourceOffset start, bool isAsync)
+{
+    ArrowHead head = parseArrowHead();
+    return finishArrow(start, move(head), isAsync);
+}
+
+AstNode* NativeParser::parseArrowFromIdentifier(AstSourceOffset start, Identifier* param, bool isAsync)
+{
+    if (!tok().is("=>") || tok().newlineBefore)
+        unexpected();
+    next();
+
+    bool isExpression;
+    AstNode* body = parseArrowBody(isAsync, isExpression);
+    return make<ArrowFunctionExpression>(start, nullptr, vector<AstNode*>{param}, body, nullptr, nullptr, false, isAsync, isExpression);
+}
+
+AstNode* NativeParser::parseClass(AstSourceOffset start, bool isStatement, bool allowAnonymous)
+{
+    expectName("class");
+
+    AstNode* id = nullptr;
+    if (tok().type == TokenType::Name && !tok().isName("extends") && !tok().isName("implements"))
+        id = parseBindingIdentifier(false, false);
+    else if (isStatement && !allowAnonymous)
+        unexpected();
+
+    TypeParameterDeclaration* typeParameters = tok().is("<") ? parseTypeParameterDeclaration() : nullptr;
+
+    AstNode* superClass = nullptr;
+    TypeParameterInstantiation* superTypeParameters = nullptr;
+    if (eatName("extends")) {
+        superClass = parseExprSubscripts();
+        if (tok().is("<"))
+            superTypeParameters = parseTypeParameterInstantiation();
+    }
+
+    vector<ClassImplements*> implements;
+    if (eatName("implements")) {
+        do {
+            AstSourceOffset implStart = tok().start;
+            Identifier* implId = parseIdentifier();
+            TypeParameterInstantiation* implTypeParameters = tok().is("<") ? parseTypeParameterInstantiation() : nullptr;
+            implements.push_back(make<ClassImplements>(implStart, implId, implTypeParameters));
+        } while (eat(","));
+    }
+
+    AstSourceOffset bodyStart = tok().start;
+    expect("{");
+    vector<AstNode*> members;
+    while (!eat("}")) {
+        if (eat(";"))
+            continue;
+        members.push_back(parseClassMember());
+    }
+    AstNode* body = make<ClassBody>(bodyStart, move(members));
+
+    if (isStatement)
+        return make<ClassDeclaration>(start, id, superClass, body, typeParameters, superTypeParameters, move(implements));
+    return make<ClassExpression>(start, id, superClass, body, typeParameters, superTypeParameters, move(implements));
+}
+
+// Whether the current name is itself a property key, rather than a modifier like get/set/static/async
+bool NativeParser::isPropertyKeyEnd()
+{
+    Token nextToken = peek();
+    return nextToken.type == TokenType::EndOfFile || nextToken.is("(") || nextToken.is("<") || nextToken.is("=")
+            || nextToken.is(";") || nextToken.is("}") || nextToken.is(":") || nextToken.is("?") || nextToken.is(",");
+}
+
+AstNode* NativeParser::parseClassMember()
+{
+    using Kind = ClassMethod::Kind;
+    AstSourceOffset start = tok().start;
+    bool isStatic = false, isAsync = false, isGenerator = false;
+    Kind kind = Kind::Method;
+
+    if (tok().isName("static") && !isPropertyKeyEnd()) {
+        isStatic = true;
+        next();
+    }
+    if (tok().isName("async") && !isPropertyKeyEnd() && !peek().newlineBefore) {
+        isAsync = true;
+        next();
+    }
+    if (eat("*"))
+        isGenerator = true;
+    if (!isAsync && !isGenerator && (tok().isName("get") || tok().isName("set")) && !isPropertyKeyEnd()) {
+        kind = tok().isName("get") ? Kind::Get : Kind::Set;
+        next();
+    }
+
+    bool computed;
+    AstNode* key = parsePropertyKey(computed);
+
+    if (tok().is("(") || tok().is("<")) {
+        if (kind == Kind::Method && !isStatic && !computed) {
+            if ((key->getType() == AstNodeType::Identifier && ((Identifier*)key)->getName() == "constructor")
+                || (key->getType() == AstNodeType::StringLiteral && ((StringLiteral*)key)->getValue() == "constructor"))
+                kind = Kind::Constructor;
+        }
+        TypeParameterDeclaration* typeParameters = tok().is("<") ? parseTypeParameterDeclaration() : nullptr;
+        vector<AstNode*> params = parseFunctionParams();
+        TypeAnnotation* returnType = tok().is(":") ? parseTypeAnnotation() : nullptr;
+        AstNode* body = parseFunctionBody(isAsync, isGenerator);
+        return make<ClassMethod>(start, nullptr, move(params), body, key, typeParameters, returnType,
+                                 kind, isGenerator, isAsync, computed, isStatic);
+    }
+
+    if (isAsync || isGenerator || kind != Kind::Method)
+        unexpected();
+    if (tok().is("?"))
+        unsupported("Optional class properties");
+
+    TypeAnnotation* typeAnnotation = tok().is(":") ? parseTypeAnnotation() : nullptr;
+    AstNode* value = nullptr;
+    if (eat("=")) {
+        Flags outerFlags = flags;
+        flags = {};
+        value = parseMaybeAssign();
+        flags = outerFlags;
+    }
+    semicolon();
+    return make<ClassProperty>(start, key, value, typeAnnotation, isStatic, computed);
+}
+
+AstNode* NativeParser::parsePropertyKey(bool& computed)
+{
+    computed = false;
+    const Token& t = tok();
+    if (t.is("[")) {
+        computed = true;
+        next();
+        AstNode* key = parseMaybeAssign();
+        expect("]");
+        return key;
+    } else if (t.type == TokenType::String || t.type == TokenType::Number) {
+        return parseLiteral();
+    } else if (t.type == TokenType::Name) {
+        return parseIdentifier(true);
+    } else if (t.is("#")) {
+        unsupported("Private class members");
+    }
+    unexpected();
+}
+
+Identifier* NativeParser::parseBindingIdentifier(bool allowTypes, bool allowOptional)
+{
+    AstSourceOffset start = tok().start;
+    if (tok().type != TokenType::Name || isReserved(tok()))
+        unexpected();
+    Atom name(tok().name());
+    next();
+
+    bool optional = allowOptional && eat("?");
+    TypeAnnotation* typeAnnotation = (allowTypes && tok().is(":")) ? parseTypeAnnotation() : nullptr;
+    return make<Identifier>(start, name, typeAnnotation, optional);
+}
+
+AstNode* NativeParser::parseBindingAtom(bool isBinding, bool allowTypes)
+{
+    AstSourceOffset start = tok().start;
+    if (tok().is("[")) {
+        next();
+        vector<AstNode*> elements;
+        while (!tok().is("]")) {
+            if (tok().is(",")) {
+                next();
+                elements.push_back(nullptr);
+                continue;
+            } else if (tok().is("...")) {
+                elements.push_back(parseRestElement(isBinding, false));
+                break;
+            }
+            elements.push_back(parseBindingElement(isBinding));
+            if (!tok().is("]"))
+                expect(",");
+        }
+        expect("]");
+        if (allowTypes && tok().is(":")) {
+            // ArrayPattern doesn't keep its annotation, but Babel still extends its location over it
+            size_t nodesCount = arena->nodeCount();
+            parseTypeAnnotation();
+            discardNodes(nodesCount, arena->nodeCount());
+        }
+        return make<ArrayPattern>(start, move(elements));
+    } else if (tok().is("{")) {
+        next();
+        vector<AstNode*> properties;
+        while (!tok().is("}")) {
+            if (tok().is("...")) {
+                properties.push_back(parseRestElement(isBinding, false));
+                break;
+            }
+
+            AstSourceOffset propStart = tok().start;
+            bool computed;
+            AstNode* key = parsePropertyKey(computed);
+            AstNode* value;
+            bool shorthand = false;
+            if (eat(":")) {
+                value = parseBindingElement(isBinding);
+            } else {
+                if (computed || key->getType() != AstNodeType::Identifier || reservedWords.count(((Identifier*)key)->getName()))
+                    unexpected();
+                shorthand = true;
+                value = cloneIdentifier((Identifier*)key);
+                if (eat("=")) {
+                    AstNode* right = parseMaybeAssign();
+                    value = make<AssignmentPattern>(propStart, value, right);
+                }
+            }
+            properties.push_back(make<ObjectProperty>(propStart, key, value, shorthand, computed));
+            if (!tok().is("}"))
+                expect(",");
+        }
+        expect("}");
+        TypeAnnotation* typeAnnotation = (allowTypes && tok().is(":")) ? parseTypeAnnotation() : nullptr;
+        return make<ObjectPattern>(start, move(properties), typeAnnotation);
+    } else if (isBinding) {
+        return parseBindingIdentifier(allowTypes, allowTypes);
+    }
+
+    // Destructuring assignment targets can be any simple assignment target
+    AstNode* target = parseExprSubscripts();
+    if (target->getType() != AstNodeType::Identifier && target->getType() != AstNodeType::MemberExpression)
+        lexer.fail("Invalid assignment target");
+    return target;
+}
+
+AstNode* NativeParser::parseBindingElement(bool isBinding)
+{
+    AstSourceOffset start = tok().start;
+    AstNode* left = parseBindingAtom(isBinding, false);
+    if (!eat("="))
+        return left;
+    AstNode* right = parseMaybeAssign();
+    return make<AssignmentPattern>(start, left, right);
+}
+
+AstNode* NativeParser::parseRestElement(bool isBinding, bool allowTypes)
+{
+    AstSourceOffset start = tok().start;
+    expect("...");
+    AstNode* argument = parseBindingAtom(isBinding, false);
+    TypeAnnotation* typeAnnotation = (allowTypes && tok().is(":")) ? parseTypeAnnotation() : nullptr;
+    return make<RestElement>(start, argument, typeAnnotation);
+}
+
+AstNode* NativeParser::parseExpression(bool noIn)
+{
+    AstSourceOffset start = tok().start;
+    AstNode* expr = parseMaybeAssign(noIn);
+    if (!tok().is(","))
+        return expr;
+
+    vector<AstNode*> expressions{expr};
+    while (eat(","))
+        expressions.push_back(parseMaybeAssign(noIn));
+    return make<SequenceExpression>(start, move(expressions));
+}
+
+AstNode* NativeParser::parseMaybeAssign(bool noIn)
+{
+    if (flags.inGenerator && tok().isName("yield"))
+        return parseYield(noIn);
+
+    AstSourceOffset start = tok().start;
+    Checkpoint beforeLeft = checkpoint();
+    AstNode* left;
+    try {
+        left = parseMaybeConditional(noIn);
+    } catch (const runtime_error& e) {
+        // Patterns like {a = 1} are not valid expressions, but they are valid destructuring targets
+        if (!beforeLeft.lexerState.token.is("[") && !beforeLeft.lexerState.token.is("{"))
+            throw;
+        runtime_error expressionError = e;
+        rewind(beforeLeft);
+        try {
+            left = parseBindingAtom(false, false);
+            if (!tok().is("="))
+                unexpected();
+        } catch (const runtime_error&) {
+            throw expressionError; // More useful than the error we got trying to parse a pattern
+        }
+    }
+
+    auto op = toAssignmentOperator(tok());
+    if (!op)
+        return left;
+
+    AstNodeType leftType = left->getType();
+    if ((leftType == AstNodeType::ObjectExpression || leftType == AstNodeType::ArrayExpression) && *op == AssignmentExpression::Operator::Equal) {
+        // Parse it again as a destructuring pattern, now that we know
+        rewind(beforeLeft);
+        left = parseBindingAtom(false, false);
+    } else if (leftType != AstNodeType::Identifier && leftType != AstNodeType::MemberExpression
+               && leftType != AstNodeType::ObjectPattern && leftType != AstNodeType::ArrayPattern) {
+        lexer.fail("Invalid left-hand side in assignment");
+    }
+
+    next();
+    AstNode* right = parseMaybeAssign(noIn);
+    return make<AssignmentExpression>(start, left, right, *op);
+}
+
+bool NativeParser::startsExpression(const Token& token) const
+{
+    switch (token.type) {
+    case TokenType::EndOfFile:
+        return false;
+    case TokenType::Name:
+        return !token.isName("in") && !token.isName("instanceof") && !token.isName("of");
+    case TokenType::Punctuator:
+        return token.is("(") || token.is("[") || token.is("{") || token.is("+") || token.is("-") || token.is("!")
+                || token.is("~") || token.is("++") || token.is("--") || token.is("/") || token.is("/=")
+                || token.is("`") || token.is("<");
+    default:
+        return true;
+    }
+}
+
+AstNode* NativeParser::parseYield(bool noIn)
+{
+    AstSourceOffset start = tok().start;
+    next();
+
+    bool isDelegate = false;
+    AstNode* argument = nullptr;
+    if (!tok().newlineBefore) {
+        if (eat("*")) {
+            isDelegate = true;
+            argument = parseMaybeAssign(noIn);
+        } else if (startsExpression(tok())) {
+            argument = parseMaybeAssign(noIn);
+        }
+    }
+    return make<YieldExpression>(start, argument, isDelegate);
+}
+
+AstNode* NativeParser::parseMaybeConditional(bool noIn)
+{
+    AstSourceOffset start = tok().start;
+    AstNode* test = parseExprOps(noIn);
+    if (!eat("?"))
+        return test;
+
+    AstNode* consequent = parseMaybeAssign();
+    expect(":");
+    AstNode* alternate = parseMaybeAssign(noIn);
+    return make<ConditionalExpression>(start, test, alternate, consequent);
+}
+
+AstNode* NativeParser::parseExprOps(bool noIn)
+{
+    // Operator precedence parsing, with an explicit stack so long chains like a+b+c+... don't recurse
+    struct Pending {
+        AstSourceOffset start;
+        AstNode* left;
+        Token op;
+        int precedence;
+    };
+    vector<Pending> stack;
+
+    AstSourceOffset start = tok().start;
+    AstNode* expr = parseMaybeUnary();
+    for (;;) {
+        int precedence = binaryPrecedence(tok(), noIn);
+        // Reduce while the operator on the stack binds at least as tightly (** is right associative)
+        while (!stack.empty() && precedence <= stack.back().precedence
+               && !(precedence == 11 && stack.back().precedence == 11)) {
+            Pending pending = move(stack.back());
+            stack.pop_back();
+            AstSourceSpan location{pending.start, lastEnd};
+            if (pending.op.is("||") || pending.op.is("&&")) {
+                auto op = pending.op.is("||") ? LogicalExpression::Operator::Or : LogicalExpression::Operator::And;
+                expr = makeAt<LogicalExpression>(location, pending.left, expr, op);
+            } else {
+                expr = makeAt<BinaryExpression>(location, pending.left, expr, toBinaryOperator(pending.op.raw));
+            }
+            start = pending.start;
+        }
+        if (precedence < 0)
+            return expr;
+
+        stack.push_back({start, expr, tok(), precedence});
+        next();
+        start = tok().start;
+        expr = parseMaybeUnary();
+    }
+}
+
+AstNode* NativeParser::parseMaybeUnary()
+{
+    AstSourceOffset start = tok().start;
+    if (auto op = toUnaryOperator(tok())) {
+        next();
+        AstNode* argument = parseMaybeUnary();
+        return make<UnaryExpression>(start, argument, *op, true);
+    } else if (tok().is("++") || tok().is("--")) {
+        auto op = tok().is("++") ? UpdateExpression::Operator::Increment : UpdateExpression::Operator::Decrement;
+        next();
+        AstNode* argument = parseMaybeUnary();
+        return make<UpdateExpression>(start, argument, op, true);
+    } else if (flags.inAsync && tok().isName("await")) {
+        next();
+        AstNode* argument = parseMaybeUnary();
+        return make<AwaitExpression>(start, argument);
+    }
+
+    AstNode* expr = parseExprSubscripts();
+    while ((tok().is("++") || tok().is("--")) && !tok().newlineBefore) {
+        auto op = tok().is("++") ? UpdateExpression::Operator::Increment : UpdateExpression::Operator::Decrement;
+        next();
+        expr = make<UpdateExpression>(start, expr, op, false);
+    }
+    return expr;
+}
+
+AstNode* NativeParser::parseExprSubscripts()
+{
+    AstSourceOffset start = tok().start;
+    AstNode* base = tok().isName("new") ? parseNew() : parseExprAtom();
+    // Unparenthesized arrow functions can't be called or indexed
+    if (base->getType() == AstNodeType::ArrowFunctionExpression && base->getLocation().end == lastEnd)
+        return base;
+    return parseSubscripts(base, start, false);
+}
+
+AstNode* NativeParser::parseSubscripts(AstNode* base, AstSourceOffset start, bool noCalls)
+{
+    for (;;) {
+        if (eat(".")) {
+            if (tok().is("#"))
+                unsupported("Private class members");
+            Identifier* property = parseIdentifier(true);
+            base = make<MemberExpression>(start, base, property, false);
+        } else if (eat("[")) {
+            AstNode* property = parseExpression();
+            expect("]");
+            base = make<MemberExpression>(start, base, property, true);
+        } else if (!noCalls && tok().is("(")) {
+            vector<AstNode*> arguments = parseCallArguments();
+            base = make<CallExpression>(start, base, move(arguments));
+        } else if (tok().is("`")) {
+            AstNode* quasi = parseTemplate();
+            base = make<TaggedTemplateExpression>(start, base, quasi);
+        } else {
+            return base;
+        }
+    }
+}
+
+AstNode* NativeParser::parseNew()
+{
+    AstSourceOffset start = tok().start;
+    AstSourceSpan newLocation{tok().start, tok().end};
+    next();
+
+    if (eat(".")) {
+        Identifier* meta = makeAt<Identifier>(newLocation, "new", nullptr, false);
+        Identifier* property = parseIdentifier(true);
+        return make<MetaProperty>(start, meta, property);
+    }
+
+    AstSourceOffset calleeStart = tok().start;
+    AstNode* callee = tok().isName("new") ? parseNew() : parseExprAtom();
+    callee = parseSubscripts(callee, calleeStart, true);
+    vector<AstNode*> arguments;
+    if (tok().is("("))
+        arguments = parseCallArguments();
+    return make<NewExpression>(start, callee, move(arguments));
+}
+
+vector<AstNode*> NativeParser::parseCallArguments()
+{
+    vector<AstNode*> arguments;
+    expect("(");
+    while (!eat(")")) {
+        if (tok().is("...")) {
+            AstSourceOffset start = tok().start;
+            next();
+            AstNode* argument = parseMaybeAssign();
+            arguments.push_back(make<SpreadElement>(start, argument));
+        } else {
+            arguments.push_back(parseMaybeAssign());
+        }
+        if (!tok().is(")"))
+            expect(",");
+    }
+    return arguments;
+}
+
+Identifier* NativeParser::parseIdentifier(bool allowReserved)
+{
+    if (tok().type != TokenType::Name || (!allowReserved && isReserved(tok())))
+        unexpected();
+    AstSourceOffset start = tok().start;
+    Atom name(tok().name());
+    next();
+    return make<Identifier>(start, name, nullptr, false);
+}
+
+AstNode* NativeParser::parseLiteral()
+{
+    const Token& t = tok();
+    AstSourceOffset start = t.start;
+    if (t.type == TokenType::String) {
+        string value = t.value;
+        next();
+        return make<StringLiteral>(start, move(value));
+    } else if (t.type == TokenType::Number) {
+        double value = t.number;
+        next();
+        return make<NumericLiteral>(start, value);
+    }
+    unexpected();
+}
+
+AstNode* NativeParser::parseExprAtom()
+{
+    const Token& t = tok();
+    AstSourceOffset start = t.start;
+
+    switch (t.type) {
+    case TokenType::String:
+    case TokenType::Number:
+        return parseLiteral();
+    case TokenType::Punctuator:
+        if (t.is("(")) {
+            return parseParenExpression();
+        } else if (t.is("[")) {
+            return parseArrayLiteral();
+        } else if (t.is("{")) {
+            return parseObjectLiteral();
+        } else if (t.is("`")) {
+            return parseTemplate();
+        } else if (t.is("/") || t.is("/=")) {
+            lexer.rescanAsRegExp();
+            string pattern(tok().raw), regexFlags = tok().value;
+            next();
+            return make<RegExpLiteral>(start, move(pattern), move(regexFlags));
+        } else if (t.is("<")) {
+            return parseArrowFromParens(start, false); // Flow generic arrow function
+        }
+        unexpected();
+    case TokenType::Name:
+        break;
+    default:
+        unexpected();
+    }
+
+    if (t.value.empty()) {
+        string_view name = t.raw;
+        if (name == "this") {
+            next();
+            return make<ThisExpression>(start);
+        } else if (name == "null") {
+            next();
+            return make<NullLiteral>(start);
+        } else if (name == "true" || name == "false") {
+            bool value = name == "true";
+            next();
+            return make<BooleanLiteral>(start, value);
+        } else if (name == "function") {
+            return parseFunction(start, false, false);
+        } else if (name == "class") {
+            return parseClass(start, false);
+        } else if (name == "super") {
+            next();
+            return make<Super>(start);
+        } else if (name == "import") {
+            next();
+            if (!tok().is("("))
+                unsupported("Import meta-properties");
+            return make<Import>(start);
+        } else if (name == "async") {
+            Token nextToken = peek();
+            if (!nextToken.newlineBefore) {
+                if (nextToken.isName("function")) {
+                    next();
+                    return parseFunction(start, false, true);
+                } else if (nextToken.type == TokenType::Name && !isReserved(nextToken)) {
+                    next();
+                    Identifier* param = parseIdentifier();
+                    return parseArrowFromIdentifier(start, param, true);
+                } else if (nextToken.is("(") || nextToken.is("<")) {
+                    Checkpoint beforeArrow = checkpoint();
+                    optional<ArrowHead> head;
+                    try {
+                        next();
+                        head = parseArrowHead();
+                    } catch (const runtime_error&) {
+                        rewind(beforeArrow); // Just a call to something named async
+                    }
+                    if (head)
+                        return finishArrow(start, move(*head), true);
+                }
+            }
+        }
+    }
+
+    Identifier* id = parseIdentifier();
+    if (tok().is("=>") && !tok().newlineBefore)
+        return parseArrowFromIdentifier(start, id, false);
+    return id;
+}
+
+AstNode* NativeParser::parseParenExpression()
+{
+    // We try to parse an expression first, and go back to parse arrow function params if it turns out we were wrong
+    AstSourceOffset start = tok().start;
+    Checkpoint beforeParens = checkpoint();
+    next();
+    if (tok().is(")")) {
+        rewind(beforeParens);
+        return parseArrowFromParens(start, false);
+    }
+
+    // Only the arrow's head is speculative, so errors in its body are reported as such
+    AstNode* expr;
+    try {
+        expr = parseParenContents();
+    } catch (const runtime_error& e) {
+        runtime_error expressionError = e;
+        rewind(beforeParens);
+        optional<ArrowHead> head;
+        try {
+            head = parseArrowHead();
+        } catch (const runtime_error&) {
+            throw expressionError;
+        }
+        return finishArrow(start, move(*head), false);
+    }
+
+    if (tok().is("=>") && !tok().newlineBefore) {
+        rewind(beforeParens);
+        return parseArrowFromParens(start, false);
+    } else if (tok().is(":")) {
+        // Either an arrow function's return type, or the end of a conditional's consequent
+        Checkpoint afterParens = checkpoint();
+        lexer.restore(beforeParens.lexerState);
+        lastEnd = beforeParens.lastEnd;
+        optional<ArrowHead> head;
+        try {
+            head = parseArrowHead();
+        } catch (const runtime_error&) {
+            rewind(afterParens);
+        }
+        if (head) {
+            discardNodes(beforeParens.arenaMark.nodeCount, afterParens.arenaMark.nodeCount);
+            return finishArrow(start, move(*head), false);
+        }
+    }
+    return expr;
+}
+
+AstNode* NativeParser::parseParenContents()
+{
+    Flags outerFlags = flags;
+    flags.noAnonFunctionType = false;
+
+    AstSourceOffset innerStart = tok().start;
+    vector<AstNode*> items;
+    bool hasTypeCast = false;
+    do {
+        AstSourceOffset itemStart = tok().start;
+        AstNode* item = parseMaybeAssign();
+        if (tok().is(":")) {
+            TypeAnnotation* typeAnnotation = parseTypeAnnotation();
+            item = make<TypeCastExpression>(itemStart, item, typeAnnotation);
+            hasTypeCast = true;
+        }
+        items.push_back(item);
+    } while (eat(","));
+    AstSourceOffset innerEnd = lastEnd;
+    expect(")");
+    flags = outerFlags;
+
+    if (items.size() == 1)
+        return items[0];
+    if (hasTypeCast)
+        lexer.fail("Type casts must be wrapped in parentheses");
+    return makeAt<SequenceExpression>({innerStart, innerEnd}, move(items));
+}
+
+AstNode* NativeParser::parseArrayLiteral()
+{
+    AstSourceOffset start = tok().start;
+    expect("[");
+    vector<AstNode*> elements;
+    while (!tok().is("]")) {
+        if (tok().is(",")) {
+            next();
+            elements.push_back(nullptr);
+            continue;
+        }
+
+        if (tok().is("...")) {
+            AstSourceOffset spreadStart = tok().start;
+            next();
+            AstNode* argument = parseMaybeAssign();
+            elements.push_back(make<SpreadElement>(spreadStart, argument));
+        } else {
+            elements.push_back(parseMaybeAssign());
+        }
+        if (!tok().is("]"))
+            expect(",");
+    }
+    next();
+    return make<ArrayExpression>(start, move(elements));
+}
+
+AstNode* NativeParser::parseObjectLiteral()
+{
+    using Kind = ObjectMethod::Kind;
+    AstSourceOffset start = tok().start;
+    expect("{");
+    vector<AstNode*> properties;
+    while (!tok().is("}")) {
+        AstSourceOffset propStart = tok().start;
+        if (eat("...")) {
+            AstNode* argument = parseMaybeAssign();
+            properties.push_back(make<SpreadElement>(propStart, argument));
+            if (!tok().is("}"))
+                expect(",");
+            continue;
+        }
+
+        bool isAsync = false, isGenerator = false;
+        Kind kind = Kind::Method;
+        if (tok().isName("async") && !isPropertyKeyEnd() && !peek().newlineBefore) {
+            isAsync = true;
+            next();
+        }
+        if (eat("*"))
+            isGenerator = true;
+        if (!isAsync && !isGenerator && (tok().isName("get") || tok().isName("set")) && !isPropertyKeyEnd()) {
+            kind = tok().isName("get") ? Kind::Get : Kind::Set;
+            next();
+        }
+
+        bool computed;
+        AstNode* key = parsePropertyKey(computed);
+        if (isAsync || isGenerator || kind != Kind::Method || tok().is("(") || tok().is("<")) {
+            TypeParameterDeclaration* typeParameters = tok().is("<") ? parseTypeParameterDeclaration() : nullptr;
+            vector<AstNode*> params = parseFunctionParams();
+            TypeAnnotation* returnType = tok().is(":") ? parseTypeAnnotation() : nullptr;
+            AstNode* body = parseFunctionBody(isAsync, isGenerator);
+            properties.push_back(make<ObjectMethod>(propStart, nullptr, move(params), body, typeParameters, returnType,
+                                                    key, kind, isGenerator, isAsync, computed));
+        } else if (eat(":")) {
+            AstNode* value = parseMaybeAssign();
+            properties.push_back(make<ObjectProperty>(propStart, key, value, false, computed));
+        } else {
+            if (computed || key->getType() != AstNodeType::Identifier || reservedWords.count(((Identifier*)key)->getName()))
+                unexpected();
+            if (tok().is("="))
+                lexer.fail("Shorthand property initializers are only valid in patterns");
+            AstNode* value = cloneIdentifier((Identifier*)key);
+            properties.push_back(make<ObjectProperty>(propStart, key, value, true, false));
+        }
+
+        if (!tok().is("}"))
+            expect(",");
+    }
+    next();
+    return make<ObjectExpression>(start, move(properties));
+}
+
+AstNode* NativeParser::parseTemplate()
+{
+    AstSourceOffset start = tok().start;
+    if (!tok().is("`"))
+        unexpected();
+
+    vector<AstNode*> quasis, expressions;
+    for (;;) {
+        bool tail = lexer.readTemplateChunk();
+        AstSourceSpan chunkLocation{tok().start, tok().end};
+        quasis.push_back(makeAt<TemplateElement>(chunkLocation, normalizeTemplateRaw(tok().raw), tail));
+        if (tail)
+            break;
+
+        lastEnd = tok().end;
+        lexer.next();
+        expressions.push_back(parseExpression());
+        if (!tok().is("}"))
+            unexpected();
+    }
+    lastEnd = lexer.templateChunkTerminatorEnd();
+    lexer.next();
+    return make<TemplateLiteral>(start, move(quasis), move(expressions));
+}
+
+TypeAnnotation* NativeParser::parseTypeAnnotation()
+{
+    AstSourceOffset start = tok().start;
+    expect(":");
+    AstNode* type = parseType();
+    return make<TypeAnnotation>(start, type);
+}
+
+AstNode* NativeParser::parseType()
+{
+    // Union types
+    AstSourceOffset start = tok().start;
+    eat("|");
+    AstNode* type = parseIntersectionType();
+    if (!tok().is("|"))
+        return type;
+
+    vector<AstNode*> types{type};
+    while (eat("|"))
+        types.push_back(parseIntersectionType());
+    return make<UnionTypeAnnotation>(start, move(types));
+}
+
+AstNode* NativeParser::parseIntersectionType()
+{
+    AstSourceOffset start = tok().start;
+    eat("&");
+    AstNode* type = parseAnonFunctionWithoutParens();
+    if (!tok().is("&"))
+        return type;
+
+    vector<AstNode*> types{type};
+    while (eat("&"))
+        types.push_back(parseAnonFunctionWithoutParens());
+    return make<IntersectionTypeAnnotation>(start, move(types));
+}
+
+AstNode* NativeParser::parseAnonFunctionWithoutParens()
+{
+    AstNode* param = parsePrefixType();
+    if (flags.noAnonFunctionType || !eat("=>"))
+        return param;
+
+    // Babel ends the reinterpreted param after the arrow
+    AstSourceOffset start = param->getLocation().start;
+    FunctionTypeParam* typeParam = make<FunctionTypeParam>(start, nullptr, param);
+    AstNode* returnType = parseType();
+    return make<FunctionTypeAnnotation>(start, vector<FunctionTypeParam*>{typeParam}, nullptr, returnType);
+}
+
+AstNode* NativeParser::parsePrefixType()
+{
+    AstSourceOffset start = tok().start;
+    if (!eat("?"))
+        return parsePostfixType();
+    AstNode* type = parsePrefixType();
+    return make<NullableTypeAnnotation>(start, type);
+}
+
+AstNode* NativeParser::parsePostfixType()
+{
+    AstSourceOffset start = tok().start;
+    AstNode* type = parsePrimaryType();
+    while (tok().is("[") && !tok().newlineBefore) {
+        next();
+        expect("]");
+        type = make<ArrayTypeAnnotation>(start, type);
+    }
+    return type;
+}
+
+AstNode* NativeParser::parseGenericType()
+{
+    AstSourceOffset start = tok().start;
+    AstNode* id = parseIdentifier(true);
+    while (eat(".")) {
+        Identifier* property = parseIdentifier(true);
+        id = make<QualifiedTypeIdentifier>(start, (Identifier*)id, property);
+    }
+    TypeParameterInstantiation* typeParameters = tok().is("<") ? parseTypeParameterInstantiation() : nullptr;
+    return make<GenericTypeAnnotation>(start, id, typeParameters);
+}
+
+AstNode* NativeParser::parsePrimaryType()
+{
+    const Token& t = tok();
+    AstSourceOffset start = t.start;
+    Flags outerFlags = flags;
+
+    switch (t.type) {
+    case TokenType::String: {
+        string value = t.value;
+        next();
+        return make<StringLiteralTypeAnnotation>(start, move(value));
+    }
+    case TokenType::Number: {
+        double value = t.number;
+        next();
+        return make<NumberLiteralTypeAnnotation>(start, value);
+    }
+    case TokenType::Punctuator:
+        if (t.is("-")) {
+            next();
+            if (tok().type != TokenType::Number)
+                unexpected();
+            double value = -tok().number;
+            next();
+            return make<NumberLiteralTypeAnnotation>(start, value);
+        } else if (t.is("*")) {
+            next();
+            return make<ExistsTypeAnnotation>(start);
+        } else if (t.is("{") || t.is("{|")) {
+            flags.noAnonFunctionType = false;
+            AstNode* type = parseObjectType(false, true);
+            flags = outerFlags;
+            return type;
+        } else if (t.is("[")) {
+            flags.noAnonFunctionType = false;
+            next();
+            vector<AstNode*> types;
+            while (!tok().is("]")) {
+                types.push_back(parseType());
+                if (!tok().is("]"))
+                    expect(",");
+            }
+            next();
+            flags = outerFlags;
+            return make<TupleTypeAnnotation>(start, move(types));
+        } else if (t.is("<")) {
+            parseTypeParameterDeclaration(); // Function types don't keep their type parameters
+            expect("(");
+            vector<FunctionTypeParam*> params;
+            FunctionTypeParam* rest = nullptr;
+            parseFunctionTypeParams(params, rest);
+            expect(")");
+            expect("=>");
+            AstNode* returnType = parseType();
+            return make<FunctionTypeAnnotation>(start, move(params), rest, returnType);
+        } else if (t.is("(")) {
+            return parseParenType(start);
+        }
+        unexpected();
+    case TokenType::Name:
+        break;
+    default:
+        unexpected();
+    }
+
+    if (t.value.empty()) {
+        string_view name = t.raw;
+        if (name == "typeof") {
+            next();
+            AstNode* argument = parsePrimaryType();
+            return make<TypeofTypeAnnotation>(start, argument);
+        } else if (name == "any" || name == "mixed" || name == "bool" || name == "boolean" || name == "number"
+                   || name == "string" || name == "void" || name == "null") {
+            char first = name[0], second = name[1];
+            next();
+            if (first == 'a')
+                return make<AnyTypeAnnotation>(start);
+            else if (first == 'm')
+                return make<MixedTypeAnnotation>(start);
+            else if (first == 'b')
+                return make<BooleanTypeAnnotation>(start);
+            else if (first == 's')
+                return make<StringTypeAnnotation>(start);
+            else if (first == 'v')
+                return make<VoidTypeAnnotation>(start);
+            else if (second == 'u' && name == "number")
+                return make<NumberTypeAnnotation>(start);
+            else
+                return make<NullLiteralTypeAnnotation>(start);
+        } else if (name == "true" || name == "false") {
+            bool value = name == "true";
+            next();
+            return make<BooleanLiteralTypeAnnotation>(start, value);
+        } else if (name == "empty" || name == "symbol" || name == "this" || name == "interface") {
+            unsupported("'"+string(name)+"' types");
+        }
+    }
+    return parseGenericType();
+}
+
+AstNode* NativeParser::parseParenType(AstSourceOffset start)
+{
+    Flags outerFlags = flags;
+    next();
+
+    // This is either a parenthesized type, or the params of a function type
+    bool isGroupedType = false;
+    if (!tok().is(")") && !tok().is("...")) {
+        if (tok().type == TokenType::Name && !tok().isName("typeof") && !tok().isName("void") && !tok().isName("null")) {
+            Token nextToken = peek();
+            isGroupedType = !nextToken.is("?") && !nextToken.is(":");
+        } else {
+            isGroupedType = true;
+        }
+    }
+
+    vector<FunctionTypeParam*> params;
+    FunctionTypeParam* rest = nullptr;
+    if (isGroupedType) {
+        flags.noAnonFunctionType = false;
+        AstNode* type = parseType();
+        flags.noAnonFunctionType = outerFlags.noAnonFunctionType;
+        if (flags.noAnonFunctionType || !(tok().is(",") || (tok().is(")") && peek().is("=>")))) {
+            expect(")");
+            return type;
+        }
+        eat(",");
+        params.push_back(make<FunctionTypeParam>(type->getLocation().start, nullptr, type));
+    }
+
+    parseFunctionTypeParams(params, rest);
+    expect(")");
+    expect("=>");
+    AstNode* returnType = parseType();
+    flags = outerFlags;
+    return make<FunctionTypeAnnotation>(start, move(params), rest, returnType);
+}
+
+FunctionTypeParam* NativeParser::parseFunctionTypeParam()
+{
+    AstSourceOffset start = tok().start;
+    Identifier* name = nullptr;
+    AstNode* type;
+    Token nextToken = peek();
+    if (tok().type == TokenType::Name && (nextToken.is(":") || nextToken.is("?"))) {
+        name = parseIdentifier(true);
+        if (eat("?"))
+            unsupported("Optional function type params");
+        expect(":");
+        type = parseType();
+    } else {
+        type = parseType();
+    }
+    return make<FunctionTypeParam>(start, name, type);
+}
+
+void NativeParser::parseFunctionTypeParams(vector<FunctionTypeParam*>& params, FunctionTypeParam*& rest)
+{
+    Flags outerFlags = flags;
+    flags.noAnonFunctionType = false;
+    while (!tok().is(")") && !tok().is("...")) {
+        params.push_back(parseFunctionTypeParam());
+        if (!tok().is(")"))
+            expect(",");
+    }
+    if (eat("..."))
+        rest = parseFunctionTypeParam();
+    flags = outerFlags;
+}
+
+AstNode* NativeParser::parseObjectTypeMethodish(AstSourceOffset start)
+{
+    if (tok().is("<"))
+        parseTypeParameterDeclaration();
+    expect("(");
+    vector<FunctionTypeParam*> params;
+    FunctionTypeParam* rest = nullptr;
+    parseFunctionTypeParams(params, rest);
+    expect(")");
+    expect(":");
+    AstNode* returnType = parseType();
+    return make<FunctionTypeAnnotation>(start, move(params), rest, returnType);
+}
+
+AstNode* NativeParser::parseObjectType(bool allowStatic, bool allowSpread)
+{
+    AstSourceOffset start = tok().start;
+    bool exact = tok().is("{|");
+    string_view endToken = exact ? "|}" : "}";
+    next();
+
+    vector<AstNode*> properties;
+    vector<ObjectTypeIndexer*> indexers;
+    while (!tok().is(endToken)) {
+        AstSourceOffset propStart = tok().start;
+        if (allowStatic && tok().isName("static")) {
+            Token nextToken = peek();
+            if (!nextToken.is(":") && !nextToken.is("?"))
+                next();
+        }
+        if (tok().is("+") || tok().is("-")) // Variance annotations are not kept in our AST
+            next();
+
+        if (eat("[")) {
+            if (tok().is("["))
+                unsupported("Internal slot properties");
+            Identifier* id = nullptr;
+            AstNode* key;
+            if (peek().is(":")) {
+                id = parseIdentifier(true);
+                expect(":");
+            }
+            key = parseType();
+            expect("]");
+            expect(":");
+            AstNode* value = parseType();
+            indexers.push_back(make<ObjectTypeIndexer>(propStart, id, key, value));
+        } else if (tok().is("(") || tok().is("<")) {
+            // Call properties are not kept in our AST
+            size_t nodesCount = arena->nodeCount();
+            parseObjectTypeMethodish(tok().start);
+            discardNodes(nodesCount, arena->nodeCount());
+        } else if (tok().is("...")) {
+            if (!allowSpread)
+                unexpected();
+            next();
+            AstNode* argument = parseType();
+            properties.push_back(make<ObjectTypeSpreadProperty>(propStart, argument));
+        } else {
+            if (tok().isName("get") || tok().isName("set")) {
+                Token nextToken = peek();
+                if (nextToken.type == TokenType::Name || nextToken.type == TokenType::String || nextToken.type == TokenType::Number)
+                    unsupported("Object type getters and setters");
+            }
+
+            AstNode* key = tok().type == TokenType::Name ? parseIdentifier(true) : parseLiteral();
+            AstNode* value;
+            bool optional = false;
+            if (tok().is("(") || tok().is("<")) {
+                value = parseObjectTypeMethodish(propStart);
+            } else {
+                optional = eat("?");
+                expect(":");
+                value = parseType();
+            }
+            properties.push_back(make<ObjectTypeProperty>(propStart, (Identifier*)key, value, optional));
+        }
+
+        if (!eat(";") && !eat(",") && !tok().is(endToken))
+            unexpected();
+    }
+    next();
+    return make<ObjectTypeAnnotation>(start, move(properties), move(indexers), exact);
+}
+
+void NativeParser::expectTypeClose()
+{
+    // The lexer doesn't know about types, so the '>' of nested type parameters can be stuck to other characters
+    if (tok().type == TokenType::Punctuator && tok().raw.size() > 1 && tok().raw[0] == '>')
+        lexer.rescanAsSingleChar();
+    expect(">");
+}
+
+TypeParameterDeclaration* NativeParser::parseTypeParameterDeclaration()
+{
+    Flags outerFlags = flags;
+    flags.noAnonFunctionType = false;
+    AstSourceOffset start = tok().start;
+    expect("<");
+
+    vector<TypeParameter*> params;
+    while (!tok().is(">")) {
+        AstSourceOffset paramStart = tok().start;
+        if (tok().is("+") || tok().is("-"))
+            next();
+        if (tok().type != TokenType::Name)
+            unexpected();
+        string name(tok().name());
+        next();
+        AstNode* bound = tok().is(":") ? parseTypeAnnotation() : nullptr;
+        if (eat("=")) {
+            size_t nodesCount = arena->nodeCount();
+            parseType(); // Defaults are not kept in our AST
+            discardNodes(nodesCount, arena->nodeCount());
+        }
+        params.push_back(make<TypeParameter>(paramStart, move(name), bound));
+
+        if (tok().type == TokenType::Punctuator && tok().raw.size() > 1 && tok().raw[0] == '>')
+            lexer.rescanAsSingleChar();
+        if (!tok().is(">"))
+            expect(",");
+    }
+    expectTypeClose();
+    flags = outerFlags;
+    return make<TypeParameterDeclaration>(start, move(params));
+}
+
+TypeParameterInstantiation* NativeParser::parseTypeParameterInstantiation()
+{
+    Flags outerFlags = flags;
+    flags.noAnonFunctionType = false;
+    AstSourceOffset start = tok().start;
+    expect("<");
+
+    vector<AstNode*> params;
+    for (;;) {
+        if (tok().type == TokenType::Punctuator && tok().raw.size() > 1 && tok().raw[0] == '>')
+            lexer.rescanAsSingleChar();
+        if (tok().is(">"))
+            break;
+        params.push_back(parseType());
+        if (tok().type == TokenType::Punctuator && tok().raw.size() > 1 && tok().raw[0] == '>')
+            lexer.rescanAsSingleChar();
+        if (!tok().is(">"))
+            expect(",");
+    }
+    expectTypeClose();
+    flags = outerFlags;
+    return make<TypeParameterInstantiation>(start, move(params));
+}
+
+AstNode* NativeParser::parseTypeAlias(AstSourceOffset start)
+{
+    Identifier* id = parseIdentifier();
+    AstNode* typeParameters = tok().is("<") ? parseTypeParameterDeclaration() : nullptr;
+    expect("=");
+    AstNode* right = parseType();
+    semicolon();
+    return make<TypeAlias>(start, id, typeParameters, right);
+}
+
+InterfaceExtends* NativeParser::parseInterfaceExtends()
+{
+    AstSourceOffset start = tok().start;
+    AstNode* id = parseIdentifier(true);
+    while (eat(".")) {
+        Identifier* property = parseIdentifier(true);
+        id = make<QualifiedTypeIdentifier>(start, (Identifier*)id, property);
+    }
+    TypeParameterInstantiation* typeParameters = tok().is("<") ? parseTypeParameterInstantiation() : nullptr;
+    return make<InterfaceExtends>(start, (Identifier*)id, typeParameters);
+}
+
+AstNode* NativeParser::parseInterface(AstSourceOffset start)
+{
+    Identifier* id = parseIdentifier();
+    TypeParameterDeclaration* typeParameters = tok().is("<") ? parseTypeParameterDeclaration() : nullptr;
+    vector<InterfaceExtends*> extends;
+    if (eatName("extends")) {
+        do {
+            extends.push_back(parseInterfaceExtends());
+        } while (eat(","));
+    }
+    if (!tok().is("{"))
+        unexpected();
+    AstNode* body = parseObjectType(false, false);
+    return make<InterfaceDeclaration>(start, id, typeParameters, body, move(extends), vector<InterfaceExtends*>{});
+}
+
+AstNode* NativeParser::parseDeclare(AstSourceOffset start)
+{
+    expectName("declare");
+    return parseDeclareBody(start, false);
+}
+
+AstNode* NativeParser::parseDeclareBody(AstSourceOffset start, bool insideModule)
+{
+    if (eatName("class")) {
+        Identifier* id = parseIdentifier();
+        TypeParameterDeclaration* typeParameters = tok().is("<") ? parseTypeParameterDeclaration() : nullptr;
+        vector<InterfaceExtends*> extends, mixins;
+        if (eatName("extends"))
+            extends.push_back(parseInterfaceExtends());
+        if (eatName("mixins")) {
+            do {
+                mixins.push_back(parseInterfaceExtends());
+            } while (eat(","));
+        }
+        if (eatName("implements")) {
+            size_t nodesCount = arena->nodeCount();
+            do {
+                parseInterfaceExtends(); // Not kept in our AST
+            } while (eat(","));
+            discardNodes(nodesCount, arena->nodeCount());
+        }
+        if (!tok().is("{"))
+            unexpected();
+        AstNode* body = parseObjectType(true, false);
+        return make<DeclareClass>(start, id, typeParameters, body, move(extends), move(mixins));
+    } else if (eatName("function")) {
+        AstSourceOffset idStart = tok().start;
+        if (tok().type != TokenType::Name)
+            unexpected();
+        string name(tok().name());
+        next();
+
+        AstSourceOffset typeStart = tok().start;
+        if (tok().is("<"))
+            parseTypeParameterDeclaration();
+        expect("(");
+        vector<FunctionTypeParam*> params;
+        FunctionTypeParam* rest = nullptr;
+        parseFunctionTypeParams(params, rest);
+        expect(")");
+        expect(":");
+        AstNode* returnType = parseType();
+        if (tok().isName("%checks") || tok().is("%"))
+            unsupported("Predicate functions");
+        AstNode* functionType = make<FunctionTypeAnnotation>(typeStart, move(params), rest, returnType);
+        TypeAnnotation* typeAnnotation = make<TypeAnnotation>(typeStart, functionType);
+        Identifier* id = make<Identifier>(idStart, move(name), typeAnnotation, false);
+        semicolon();
+        return make<DeclareFunction>(start, id);
+    } else if (eatName("var")) {
+        Identifier* id = parseBindingIdentifier(true, false);
+        semicolon();
+        return make<DeclareVariable>(start, id);
+    } else if (eatName("module")) {
+        if (tok().is("."))
+            unsupported("Module exports declarations");
+        if (tok().type != TokenType::String)
+            unsupported("Non-string module declarations");
+        StringLiteral* id = (StringLiteral*)parseLiteral();
+
+        AstSourceOffset bodyStart = tok().start;
+        expect("{");
+        vector<AstNode*> body;
+        while (!eat("}")) {
+            AstSourceOffset statementStart = tok().start;
+            if (tok().isName("import"))
+                body.push_back(parseImport(statementStart));
+            else if (tok().isName("declare"))
+                body.push_back(parseDeclare(statementStart));
+            else
+                unexpected();
+        }
+        AstNode* block = make<BlockStatement>(bodyStart, move(body));
+        return make<DeclareModule>(start, id, block);
+    } else if (eatName("type")) {
+        Identifier* id = parseIdentifier();
+        if (tok().is("<")) {
+            size_t nodesCount = arena->nodeCount();
+            parseTypeParameterDeclaration();
+            discardNodes(nodesCount, arena->nodeCount());
+        }
+        expect("=");
+        AstNode* right = parseType();
+        semicolon();
+        return make<DeclareTypeAlias>(start, id, right);
+    } else if (eatName("export") && !insideModule) {
+        AstSourceOffset declStart = tok().start;
+        AstNode* declaration;
+        if (eatName("default")) {
+            declStart = tok().start;
+            if (tok().isName("function") || tok().isName("class")) {
+                declaration = parseDeclareBody(declStart, true);
+            } else {
+                declaration = parseType();
+                semicolon();
+            }
+        } else if (tok().isName("function") || tok().isName("class") || tok().isName("var")) {
+            declaration = parseDeclareBody(declStart, true);
+        } else {
+            unsupported("Declare export specifiers");
+        }
+        return make<DeclareExportDeclaration>(start, declaration);
+    }
+    unsupported("Declarations of this kind");
+}
+
+AstRoot* parseSourceScriptNative(Module& parentModule, const string& source, bool keepComments)
+{
+    NativeParser parser(parentModule, source, keepComments);
+    return parser.parseProgram();
+}
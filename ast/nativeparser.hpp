@@ -0,0 +1,13 @@
+#ifndef NATIVEPARSER_HPP
+#define NATIVEPARSER_HPP
+
+#include <string>
+
+class AstRoot;
+class Module;
+
+// Parses ES2018 with Flow annotations straight into our AST, producing the same nodes and locations as Babel.
+// Throws a runtime_error on syntax errors and on constructs we don't support, in which case callers should fall back to Babel.
+AstRoot* parseSourceScriptNative(Module& parentModule, const std::string& source, bool keepComments);
+
+#endif // NATIVEPARSER_HPP
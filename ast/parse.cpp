@@ -1,10 +1,17 @@
 #include "ast/parse.hpp"
-#include "ast/import.hpp"
+#include "ast/ast.hpp"
+#include "ast/nativeparser.hpp"
+#include "ast/serialize.hpp"
 #include "utils/utils.hpp"
+#include "utils/hash.hpp"
 #include "utils/reporting.hpp"
 #include "v8/isolatewrapper.hpp"
+#include "v8/v8.hpp"
 #include <atomic>
+#include <memory>
 #include <thread>
+#include <deque>
+#include <chrono>
 #include <cstring>
 #include <cassert>
 #include <algorithm>
@@ -15,132 +22,248 @@
 
 using namespace std;
 
-extern "C" {
-extern const char babelScriptStart[];
-extern uint32_t babelScriptSize;
-}
-
 struct ParseWorkPackage
 {
+    ParseWorkPackage(Module& module, const std::string& source, bool keepComments)
+        : module{module}, source{source}, keepComments{keepComments}, enqueueTime{chrono::steady_clock::now()} {}
+
     Module& module;
     const std::string& source;
     promise<AstRoot*> astPromise;
     bool keepComments;
+    atomic_bool taken{false}; //< A package can be queued twice once prioritized, only the first worker to take it parses it
+    chrono::steady_clock::time_point enqueueTime;
+    chrono::nanoseconds queueWaitTime{0};
 };
 
-static const char babelCompileCacheFileName[] = "babel_compile_cache.bin";
-static vector<uint8_t> babelCompileCacheBackingVector;
-static atomic<v8::ScriptCompiler::CachedData*> babelCompileCache;
+// Each worker pops from the front of its own queue, and steals from the front of the others' when it runs out
+struct WorkerQueue
+{
+    mutex queueMutex;
+    deque<shared_ptr<ParseWorkPackage>> packages;
+};
 
-static atomic_int workersStarted{0};
+static atomic<ParserBackend> parserBackend{ParserBackend::Native};
+static atomic_uint configuredWorkersCount{0};
 static atomic_bool workersStopFlag{false};
 static vector<thread> workers;
-static vector<ParseWorkPackage> workQueue;
-static std::condition_variable condvar;
-static std::mutex condvar_mutex;
+static std::mutex workersMutex;
+static unsigned workersStarted = 0; //< Guarded by workersMutex
+static std::condition_variable workersStartedCondvar;
+static vector<unique_ptr<WorkerQueue>> workerQueues;
+static WorkerQueue priorityQueue; //< Packages someone is already waiting on, taken before anything else
+static atomic_uint nextWorkerQueue{0};
+static atomic_int pendingPackages{0}; //< Queued packages not taken by a worker yet
+static atomic_int sleepingWorkers{0};
+static std::condition_variable idleCondvar;
+static std::mutex idleMutex;
+static ParseQueueStats queueStats;
+
+static string astCacheFileName(const string& source, bool keepComments);
+static AstRoot* tryLoadAstCacheFile(Module& module, const string& cacheFileName);
+static void writeAstCacheFile(const string& cacheFileName, const vector<uint8_t>& serializedAst);
+static v8::Local<v8::Object> getBabelObject(IsolateWrapper& isolateWrapper);
+static vector<uint8_t> parseSourceScript(IsolateWrapper& isolateWrapper, v8::Local<v8::Object> babelObject, const std::string& scriptSource, bool keepComments);
+
+static shared_ptr<ParseWorkPackage> tryTakeFrom(WorkerQueue& queue)
+{
+    lock_guard lock(queue.queueMutex);
+    while (!queue.packages.empty()) {
+        shared_ptr<ParseWorkPackage> package = move(queue.packages.front());
+        queue.packages.pop_front();
+        if (!package->taken.exchange(true))
+            return package;
+    }
+    return nullptr;
+}
+
+static shared_ptr<ParseWorkPackage> tryTakePackage(size_t ownQueueIndex)
+{
+    shared_ptr<ParseWorkPackage> package = tryTakeFrom(priorityQueue);
+    if (!package)
+        package = tryTakeFrom(*workerQueues[ownQueueIndex]);
+    for (size_t i = 1; !package && i < workerQueues.size(); ++i) {
+        package = tryTakeFrom(*workerQueues[(ownQueueIndex + i) % workerQueues.size()]);
+        if (package)
+            queueStats.stolen++;
+    }
+    if (!package)
+        return nullptr;
+
+    pendingPackages--;
+    package->queueWaitTime = chrono::steady_clock::now() - package->enqueueTime;
+    auto waitNs = static_cast<uint64_t>(package->queueWaitTime.count());
+    queueStats.packages++;
+    queueStats.totalWaitNs += waitNs;
+    for (uint64_t maxWait = queueStats.maxWaitNs; waitNs > maxWait && !queueStats.maxWaitNs.compare_exchange_weak(maxWait, waitNs);)
+        ;
+    return package;
+}
+
+// Producers only take idleMutex when someone is sleeping. Since both sides use seq_cst atomics, either the producer sees
+// the sleeping worker and notifies it, or the worker sees the new package before going to sleep.
+static void wakeIdleWorker()
+{
+    if (sleepingWorkers.load() == 0)
+        return;
+    lock_guard lock(idleMutex);
+    idleCondvar.notify_one();
+}
 
-static void loadBabelCompileCacheFile();
-static void writeBabelCompileCacheFile(v8::ScriptCompiler::CachedData* cachedData);
-static v8::Local<v8::Object> makeBabelObject(IsolateWrapper& isolateWrapper);
-static v8::Local<v8::Object> parseSourceScript(IsolateWrapper& isolateWrapper, v8::Local<v8::Object> babelObject, const std::string& scriptSource);
+static void waitForPackages()
+{
+    unique_lock lock(idleMutex);
+    sleepingWorkers++;
+    idleCondvar.wait(lock, []{
+        return pendingPackages.load() > 0 || workersStopFlag.load(memory_order::memory_order_acquire);
+    });
+    sleepingWorkers--;
+}
 
-static void worker_thread_loop()
+static void worker_thread_loop(size_t queueIndex)
 {
     using namespace v8;
 
-    IsolateWrapper isolateWrapper;
-    HandleScope handleScope(*isolateWrapper);
-    Local<Object> babelObj = makeBabelObject(isolateWrapper);
+    // The isolate comes up with Babel ready from our startup snapshot, but still costs memory, so only create it if we need it
+    unique_ptr<IsolateWrapper> isolateWrapper;
+    Global<Object> babelObj;
 
-    unique_lock condvar_lock(condvar_mutex);
-    workersStarted++;
+    {
+        lock_guard workers_lock(workersMutex);
+        workersStarted++;
+    }
+    workersStartedCondvar.notify_all();
 
     while (!workersStopFlag.load(memory_order::memory_order_acquire)) {
-        if (workQueue.empty()) {
-            condvar.wait(condvar_lock);
+        shared_ptr<ParseWorkPackage> packagePtr = tryTakePackage(queueIndex);
+        if (!packagePtr) {
+            waitForPackages();
             continue;
         }
-        ParseWorkPackage package = move(workQueue.back());
-        workQueue.pop_back();
-        condvar_lock.unlock();
-
-        Isolate* isolate = isolateWrapper.get();
-        Isolate::Scope isolateScope(isolate);
-        HandleScope handleScope(isolate);
-        Local<Context> context = Context::New(*isolateWrapper);
-        Context::Scope contextScope(context);
-
-        auto astObj = parseSourceScript(isolateWrapper, babelObj, package.source);
-        auto ast = importBabylonAst(package.module, astObj, package.keepComments);
-        package.astPromise.set_value(ast);
+        ParseWorkPackage& package = *packagePtr;
+
+        string cacheFileName = astCacheFileName(package.source, package.keepComments);
+        AstRoot* ast = tryLoadAstCacheFile(package.module, cacheFileName);
+        bool fromCache = ast != nullptr;
+
+        if (!ast && parserBackend.load(memory_order::memory_order_relaxed) == ParserBackend::Native) {
+            try {
+                ast = parseSourceScriptNative(package.module, package.source, package.keepComments);
+            } catch (const runtime_error& e) {
+                trace("Falling back to Babel for "+package.module.getPath()+": "+e.what());
+            }
+        }
+
+        vector<uint8_t> serializedAst;
+        if (!ast) {
+            if (!isolateWrapper)
+                isolateWrapper = make_unique<IsolateWrapper>(::V8::getInstance().getBabelCreateParams());
+            Isolate* isolate = isolateWrapper->get();
+            Isolate::Scope isolateScope(isolate);
+            HandleScope handleScope(isolate);
+            // Babel lives in the default context, a fresh context per package would deserialize it all over again
+            if (babelObj.IsEmpty())
+                babelObj.Reset(isolate, getBabelObject(*isolateWrapper));
+
+            serializedAst = parseSourceScript(*isolateWrapper, babelObj.Get(isolate), package.source, package.keepComments);
+            ast = deserializeAst(package.module, serializedAst.data(), serializedAst.size());
+        }
 
-        condvar_lock.lock();
+        if (!fromCache) {
+            if (serializedAst.empty())
+                serializedAst = serializeAst(*ast);
+            writeAstCacheFile(cacheFileName, serializedAst);
+        }
+        package.astPromise.set_value(ast);
     }
 
+    babelObj.Reset();
+    lock_guard workers_lock(workersMutex);
     workersStarted--;
 }
 
-std::future<AstRoot*> parseSourceScriptAsync(Module &parentModule, const std::string& script, bool keepComments)
+void setParserBackend(ParserBackend backend)
+{
+    parserBackend.store(backend, memory_order::memory_order_relaxed);
+}
+
+const ParseQueueStats& getParseQueueStatistics()
+{
+    return queueStats;
+}
+
+PendingAst parseSourceScriptAsync(Module &parentModule, const std::string& script, bool keepComments)
 {
     assert(workersStopFlag.load(memory_order::memory_order_acquire) == false);
-    lock_guard condvar_lock(condvar_mutex);
+    assert(!workerQueues.empty());
 
-    promise<AstRoot*> promise;
-    future<AstRoot*> future = promise.get_future();
+    auto package = make_shared<ParseWorkPackage>(parentModule, script, keepComments);
+    PendingAst pendingAst{package};
 
-    ParseWorkPackage package{parentModule, script, move(promise), keepComments};
-    workQueue.push_back(move(package));
-    condvar.notify_one();
+    // Packages are spread round-robin, so enqueuing never contends on a single lock
+    WorkerQueue& queue = *workerQueues[nextWorkerQueue++ % workerQueues.size()];
+    {
+        lock_guard lock(queue.queueMutex);
+        queue.packages.push_back(move(package));
+    }
+    pendingPackages++;
+    wakeIdleWorker();
 
-    return future;
+    return pendingAst;
 }
 
-static v8::Local<v8::Object> makeBabelObject(IsolateWrapper& isolateWrapper)
+PendingAst::PendingAst(std::shared_ptr<ParseWorkPackage> package)
+    : package{package}
+    , future{package->astPromise.get_future()}
 {
-    using namespace v8;
-
-    Isolate* isolate = isolateWrapper.get();
-    Isolate::Scope isolateScope(isolate);
-    EscapableHandleScope handleScope(isolate);
-    Local<Context> context = isolate->GetCurrentContext();
-    TryCatch trycatch(isolate);
-
-    Local<String> babelSourceStr = String::NewFromUtf8(isolate, babelScriptStart,
-                                       NewStringType::kNormal, static_cast<int>(babelScriptSize))
-                                       .ToLocalChecked();
+}
 
-    ScriptCompiler::CachedData* cachedData = babelCompileCache.load();
-    if (cachedData) // ScriptCompiler::Source takes ownership, so we need a copy
-        cachedData = new ScriptCompiler::CachedData(cachedData->data, cachedData->length);
-    ScriptCompiler::Source source(babelSourceStr, cachedData);
-    Local<UnboundScript> unboundScript;
+bool PendingAst::valid() const
+{
+    return future.valid();
+}
 
-    auto compileFlags = cachedData ? ScriptCompiler::kConsumeCodeCache : ScriptCompiler::kEagerCompile;
-    if (!ScriptCompiler::CompileUnboundScript(isolate, &source, compileFlags).ToLocal(&unboundScript)) {
-        reportV8Exception(isolate, &trycatch);
-        throw std::runtime_error("makeBabelObject: Error compiling babel script");
+AstRoot* PendingAst::get()
+{
+    if (future.wait_for(chrono::seconds(0)) != future_status::ready && !package->taken.load()) {
+        // Someone is blocked on this package, so it jumps the queue. The copy left in its worker queue will be skipped.
+        {
+            lock_guard lock(priorityQueue.queueMutex);
+            priorityQueue.packages.push_back(package);
+        }
+        queueStats.prioritized++;
+        wakeIdleWorker();
     }
+    return future.get();
+}
 
-    if (!cachedData) {
-        cachedData = ScriptCompiler::CreateCodeCache(unboundScript);
-        ScriptCompiler::CachedData* expected = nullptr;
-        if (babelCompileCache.compare_exchange_strong(expected, cachedData))
-            writeBabelCompileCacheFile(cachedData);
-    }
+std::chrono::nanoseconds PendingAst::getQueueWaitTime() const
+{
+    return package->queueWaitTime;
+}
+
+static v8::Local<v8::Object> getBabelObject(IsolateWrapper& isolateWrapper)
+{
+    using namespace v8;
 
-    auto script = unboundScript->BindToCurrentContext();
-    script->Run(context).ToLocalChecked();
-    Local<Object> babelObject = context->Global()->Get(String::NewFromUtf8(isolate, "babylon")).As<Object>();
-    return handleScope.Escape(babelObject);
+    // Babel was evaluated in the default context when the startup snapshot was built, see v8/babelsnapshot.cpp
+    Isolate* isolate = isolateWrapper.get();
+    EscapableHandleScope handleScope(isolate);
+    Local<Context> context = isolate->GetCurrentContext();
+    Local<Value> babelObject;
+    if (!context->Global()->Get(context, String::NewFromUtf8(isolate, "babylon")).ToLocal(&babelObject) || !babelObject->IsObject())
+        throw std::runtime_error("getBabelObject: Babel missing from the startup snapshot");
+    return handleScope.Escape(babelObject.As<Object>());
 }
 
-static v8::Local<v8::Object> parseSourceScript(IsolateWrapper& isolateWrapper, v8::Local<v8::Object> babelObject, const std::string& scriptSource)
+// Babel encodes the AST in our serialized format itself, which is much faster than reading the AST objects through the V8 API
+static vector<uint8_t> parseSourceScript(IsolateWrapper& isolateWrapper, v8::Local<v8::Object> babelObject, const std::string& scriptSource, bool keepComments)
 {
     using namespace v8;
 
     Isolate* isolate = isolateWrapper.get();
     Isolate::Scope isolateScope(isolate);
-    EscapableHandleScope handleScope(isolate);
+    HandleScope handleScope(isolate);
     TryCatch trycatch(isolate);
     Local<Context> context = isolateWrapper.get()->GetCurrentContext();
     Local<Value> scriptSourceStr = String::NewFromUtf8(isolate, scriptSource.data(),
@@ -161,90 +284,114 @@ static v8::Local<v8::Object> parseSourceScript(IsolateWrapper& isolateWrapper, v
         reportV8Exception(isolate, &trycatch);
         throw std::runtime_error("parseSourceScript: Failed to parse JSON options");
     }
-    std::array arguments = { scriptSourceStr, transformOptions };
 
-    Local<String> parseFunctionName = String::NewFromUtf8(isolate, "parse");
+#define X(NODE) #NODE,
+    static const char* const nodeTypeNames[] = { IMPORTED_NODE_LIST(X) };
+#undef X
+    Local<Array> nodeTypes = Array::New(isolate, static_cast<int>(size(nodeTypeNames)));
+    for (uint32_t i = 0; i < size(nodeTypeNames); ++i)
+        nodeTypes->Set(context, i, String::NewFromUtf8(isolate, nodeTypeNames[i])).FromJust();
+
+    std::array<Local<Value>, 5> arguments = { scriptSourceStr, transformOptions, nodeTypes,
+                                              Integer::NewFromUnsigned(isolate, astFormatVersion), Boolean::New(isolate, keepComments) };
+
+    Local<String> parseFunctionName = String::NewFromUtf8(isolate, "parseToBuffer");
     Local<v8::Function> parseFunction = babelObject->Get(context, parseFunctionName).ToLocalChecked().As<v8::Function>();
 
     Local<Value> result;
     if (!parseFunction.As<v8::Function>()->Call(context, context->Global(), arguments.size(), arguments.data()).ToLocal(&result)
-        || !result->IsObject()) {
+        || !result->IsUint8Array()) {
         reportV8Exception(isolate, &trycatch);
         throw std::runtime_error("parseSourceScript: Failed to parse script");
     }
 
-    return handleScope.Escape(result.As<Object>());
+    Local<Uint8Array> resultArray = result.As<Uint8Array>();
+    vector<uint8_t> serializedAst(resultArray->ByteLength());
+    resultArray->CopyContents(serializedAst.data(), serializedAst.size());
+    return serializedAst;
 }
 
-static void loadBabelCompileCacheFile()
+// The key covers everything that affects the resulting AST, so stale entries are simply never looked up again
+static string astCacheFileName(const string& source, bool keepComments)
 {
-    optional<vector<uint8_t>> data = tryReadCacheFile(babelCompileCacheFileName);
-    if (!data.has_value())
-        return;
-    uint32_t versionTag;
-    memcpy(&versionTag, data->data(), sizeof(versionTag));
-    if (versionTag != v8::ScriptCompiler::CachedDataVersionTag()) {
-        trace("Invalidating Babel compile cache (v8 version mismatch)");
-        tryRemoveCacheFile(babelCompileCacheFileName);
-        return;
-    }
-
-    babelCompileCacheBackingVector = move(*data);
-    auto cachedData = new v8::ScriptCompiler::CachedData(babelCompileCacheBackingVector.data()+sizeof(versionTag),
-                                                         babelCompileCacheBackingVector.size()-sizeof(versionTag));
-    babelCompileCache.store(cachedData);
+    string name = "ast/" + stableHashHex(source.data(), source.size());
+    name += parserBackend.load(memory_order::memory_order_relaxed) == ParserBackend::Native ? "_native" : "_babel";
+    name += keepComments ? "_comments" : "";
+    name += "_v" + to_string(astFormatVersion) + ".bin";
+    return name;
 }
 
-
-static void writeBabelCompileCacheFile(v8::ScriptCompiler::CachedData* cachedData)
+static AstRoot* tryLoadAstCacheFile(Module& module, const string& cacheFileName)
 {
-    uint32_t versionTag = v8::ScriptCompiler::CachedDataVersionTag();
-    vector<uint8_t> data(sizeof(versionTag)+cachedData->length);
-    memcpy(data.data(), &versionTag, sizeof(versionTag));
-    memcpy(data.data()+sizeof(versionTag), cachedData->data, cachedData->length);
-    tryWriteCacheFile(babelCompileCacheFileName, data);
+    optional<MappedFile> file = tryMapCacheFile(cacheFileName.c_str());
+    if (!file.has_value())
+        return nullptr;
+
+    try {
+        return deserializeAst(module, file->data(), file->size());
+    } catch (const runtime_error& e) {
+        trace("Invalidating AST cache for "+module.getPath()+": "+e.what());
+        tryRemoveCacheFile(cacheFileName.c_str());
+        return nullptr;
+    }
 }
 
-static unsigned workersCount()
+static void writeAstCacheFile(const string& cacheFileName, const vector<uint8_t>& serializedAst)
 {
-    return std::max(4U, thread::hardware_concurrency()/2);
+    tryWriteCacheFile(cacheFileName.c_str(), serializedAst);
 }
 
-static void prepareOtherThreads()
+void setParseWorkersCount(unsigned count)
 {
-    loadBabelCompileCacheFile();
+    configuredWorkersCount.store(count, memory_order::memory_order_relaxed);
+}
 
-    {
-        lock_guard condvar_lock(condvar_mutex);
-        auto count = workersCount();
-        for (decltype(count) i = 0; i<count-1; ++i)
-            workers.emplace_back(worker_thread_loop);
-    }
+unsigned autoParseWorkersCount()
+{
+    // Rough peak footprint of a worker: a Babel isolate and the ASTs of the biggest files it parses
+    constexpr uint64_t workerMemoryEstimate = 256ULL << 20;
+    uint64_t memoryBound = max<uint64_t>(availableMemoryBytes() / workerMemoryEstimate, 1);
+    return static_cast<unsigned>(min<uint64_t>(availableCpuCount(), memoryBound));
+}
 
-    worker_thread_loop();
+static unsigned workersCount()
+{
+    unsigned count = configuredWorkersCount.load(memory_order::memory_order_relaxed);
+    return count ? count : autoParseWorkersCount();
 }
 
 void startParsingThreads()
 {
-    lock_guard condvar_lock(condvar_mutex); // Taken for concurrent push into workers vector
+    lock_guard workers_lock(workersMutex); // Taken for concurrent push into workers vector
+    assert(workers.empty() && workerQueues.empty());
     workersStopFlag.store(false, memory_order::memory_order_release);
-    workers.emplace_back(prepareOtherThreads);
+    unsigned count = workersCount();
+    trace("Starting "+to_string(count)+" parse worker(s)");
+    for (unsigned i = 0; i < count; ++i)
+        workerQueues.push_back(make_unique<WorkerQueue>());
+    for (unsigned i = 0; i < count; ++i)
+        workers.emplace_back(worker_thread_loop, i);
 }
 
 void stopParsingThreads()
 {
-    // Wait for the threads to be fully started before notify_all, should not take long and avoids deadlock in a crash-proof way.
-    while (workersStarted != (int)workersCount())
-        ;
+    // Startup barrier, so we never tear down the queues under a worker that is still starting
+    {
+        unique_lock workers_lock(workersMutex);
+        workersStartedCondvar.wait(workers_lock, []{ return workersStarted == workerQueues.size(); });
+    }
 
     workersStopFlag.store(true, memory_order::memory_order_release);
 
     {
-        lock_guard condvar_lock(condvar_mutex);
-        condvar.notify_all();
+        lock_guard lock(idleMutex);
+        idleCondvar.notify_all();
     }
 
     for (auto& worker : workers)
         worker.join();
     workers.clear();
+    // Anything left unparsed is dropped, its PendingAst will throw a broken_promise future_error
+    workerQueues.clear();
+    priorityQueue.packages.clear();
 }
@@ -3,14 +3,57 @@
 
 #include <string>
 #include <future>
+#include <memory>
+#include <atomic>
+#include <chrono>
 
 class AstRoot;
 class Module;
+struct ParseWorkPackage;
+
+enum class ParserBackend {
+    Babel,
+    Native, //< Falls back to Babel for anything it can't parse
+};
+
+void setParserBackend(ParserBackend backend);
+
+// Must be called before startParsingThreads. 0 (the default) picks a count with autoParseWorkersCount()
+void setParseWorkersCount(unsigned count);
+// One worker per available CPU, fewer if memory can't hold that many isolates
+unsigned autoParseWorkersCount();
 
 void startParsingThreads();
 void stopParsingThreads();
 
-// This runs babel and imports its result in a worker thread, returning the AST
-std::future<AstRoot*> parseSourceScriptAsync(Module& parentModule, const std::string& script, bool keepComments = false);
+// Handle to a queued parse. Calling get() before a worker picked up the package moves it to the front of the queue.
+class PendingAst
+{
+public:
+    PendingAst() = default;
+    explicit PendingAst(std::shared_ptr<ParseWorkPackage> package);
+
+    bool valid() const;
+    AstRoot* get();
+    // Time between enqueuing and a worker picking up the package, only meaningful once get() returned
+    std::chrono::nanoseconds getQueueWaitTime() const;
+
+private:
+    std::shared_ptr<ParseWorkPackage> package;
+    std::future<AstRoot*> future;
+};
+
+// This parses and imports the script in a worker thread, returning the AST
+PendingAst parseSourceScriptAsync(Module& parentModule, const std::string& script, bool keepComments = false);
+
+struct ParseQueueStats {
+    std::atomic_uint64_t packages = 0;
+    std::atomic_uint64_t totalWaitNs = 0;
+    std::atomic_uint64_t maxWaitNs = 0;
+    std::atomic_uint64_t stolen = 0; //< Taken from another worker's queue
+    std::atomic_uint64_t prioritized = 0; //< Moved to the front because a module was blocked on it
+};
+
+const ParseQueueStats& getParseQueueStatistics();
 
 #endif // PARSE_H
@@ -0,0 +1,1620 @@
+#include "ast/serialize.hpp"
+#include "ast/ast.hpp"
+#include <cstring>
+#include <stdexcept>
+
+using namespace std;
+
+static constexpr uint32_t astFormatMagic = 0x5441534A; // "JSAT"
+static constexpr uint8_t nullNodeTag = 0xFF;
+
+class AstSerializer
+{
+public:
+    vector<uint8_t> serialize(AstRoot& root);
+
+private:
+    template <class T> void write(T value);
+    void writeBool(bool value) { write<uint8_t>(value); }
+    template <class E> void writeEnum(E value) { write<uint8_t>(static_cast<uint8_t>(value)); }
+    void writeString(const string& str);
+    void writeSpan(const AstSourceSpan& span);
+    void writeNode(AstNode* node);
+    template <class T> void writeNodes(const vector<T*>& nodes);
+
+#define X(NODE) void write##NODE(AstNode& node);
+    IMPORTED_NODE_LIST(X)
+#undef X
+
+private:
+    vector<uint8_t> out;
+};
+
+class AstReader
+{
+public:
+    AstReader(const uint8_t* data, size_t size) : pos{data}, end{data+size} {}
+    bool atEnd() const { return pos == end; }
+
+    template <class T> T read();
+    bool readBool() { return read<uint8_t>() != 0; }
+    template <class E> E readEnum() { return static_cast<E>(read<uint8_t>()); }
+    string readString();
+    Atom readAtom();
+    AstSourceSpan readSpan();
+    AstNode* readNode();
+    template <class T = AstNode> vector<T*> readNodes();
+
+private:
+    void require(size_t size);
+
+private:
+    const uint8_t *pos, *end;
+};
+
+vector<uint8_t> serializeAst(AstRoot& root)
+{
+    return AstSerializer().serialize(root);
+}
+
+vector<uint8_t> AstSerializer::serialize(AstRoot& root)
+{
+    write(astFormatMagic);
+    write(astFormatVersion);
+    writeSpan(root.getLocation());
+    writeNodes(root.getBody());
+    writeNodes(root.getComments());
+    return move(out);
+}
+
+template <class T>
+void AstSerializer::write(T value)
+{
+    auto size = out.size();
+    out.resize(size + sizeof(T));
+    memcpy(out.data() + size, &value, sizeof(T));
+}
+
+void AstSerializer::writeString(const string& str)
+{
+    write<uint32_t>(str.size());
+    out.insert(out.end(), str.begin(), str.end());
+}
+
+void AstSerializer::writeSpan(const AstSourceSpan& span)
+{
+    uint32_t values[] = {span.start, span.end};
+    auto size = out.size();
+    out.resize(size + sizeof(values));
+    memcpy(out.data() + size, values, sizeof(values));
+}
+
+void AstSerializer::writeNode(AstNode* node)
+{
+    if (!node) {
+        write(nullNodeTag);
+        return;
+    }
+
+    write<uint8_t>(static_cast<uint8_t>(node->getType()));
+    writeSpan(node->getLocation());
+    switch (node->getType()) {
+#define X(NODE) case AstNodeType::NODE: write##NODE(*node); break;
+    IMPORTED_NODE_LIST(X)
+#undef X
+    default:
+        throw runtime_error("Cannot serialize AST node of type "s + node->getTypeName());
+    }
+}
+
+template <class T>
+void AstSerializer::writeNodes(const vector<T*>& nodes)
+{
+    write<uint32_t>(nodes.size());
+    for (T* node : nodes)
+        writeNode(node);
+}
+
+void AstSerializer::writeCommentLine(AstNode& node)
+{
+    writeString(static_cast<AstComment&>(node).getText());
+}
+
+void AstSerializer::writeCommentBlock(AstNode& node)
+{
+    writeString(static_cast<AstComment&>(node).getText());
+}
+
+void AstSerializer::writeIdentifier(AstNode& node)
+{
+    auto& n = static_cast<Identifier&>(node);
+    writeString(n.name.str());
+    writeNode(n.typeAnnotation);
+    writeBool(n.optional);
+}
+
+void AstSerializer::writeRegExpLiteral(AstNode& node)
+{
+    auto& n = static_cast<RegExpLiteral&>(node);
+    writeString(n.pattern);
+    writeString(n.flags);
+}
+
+void AstSerializer::writeNullLiteral(AstNode&)
+{
+}
+
+void AstSerializer::writeStringLiteral(AstNode& node)
+{
+    writeString(static_cast<StringLiteral&>(node).value.str());
+}
+
+void AstSerializer::writeBooleanLiteral(AstNode& node)
+{
+    writeBool(static_cast<BooleanLiteral&>(node).value);
+}
+
+void AstSerializer::writeNumericLiteral(AstNode& node)
+{
+    write(static_cast<NumericLiteral&>(node).value);
+}
+
+void AstSerializer::writeTemplateLiteral(AstNode& node)
+{
+    auto& n = static_cast<TemplateLiteral&>(node);
+    writeNodes(n.quasis);
+    writeNodes(n.expressions);
+}
+
+void AstSerializer::writeTemplateElement(AstNode& node)
+{
+    auto& n = static_cast<TemplateElement&>(node);
+    writeString(n.rawValue);
+    writeBool(n.tail);
+}
+
+void AstSerializer::writeTaggedTemplateExpression(AstNode& node)
+{
+    auto& n = static_cast<TaggedTemplateExpression&>(node);
+    writeNode(n.tag);
+    writeNode(n.quasi);
+}
+
+void AstSerializer::writeObjectProperty(AstNode& node)
+{
+    auto& n = static_cast<ObjectProperty&>(node);
+    writeNode(n.key);
+    writeNode(n.value);
+    writeBool(n.shorthand);
+    writeBool(n.computed);
+}
+
+void AstSerializer::writeObjectMethod(AstNode& node)
+{
+    auto& n = static_cast<ObjectMethod&>(node);
+    writeNode(n.id);
+    writeNodes(n.params);
+    writeNode(n.body);
+    writeNode(n.typeParameters);
+    writeNode(n.returnType);
+    writeNode(n.key);
+    writeEnum(n.kind);
+    writeBool(n.generator);
+    writeBool(n.async);
+    writeBool(n.computed);
+}
+
+void AstSerializer::writeExpressionStatement(AstNode& node)
+{
+    writeNode(static_cast<ExpressionStatement&>(node).expression);
+}
+
+void AstSerializer::writeBlockStatement(AstNode& node)
+{
+    writeNodes(static_cast<BlockStatement&>(node).body);
+}
+
+void AstSerializer::writeEmptyStatement(AstNode&)
+{
+}
+
+void AstSerializer::writeWithStatement(AstNode& node)
+{
+    auto& n = static_cast<WithStatement&>(node);
+    writeNode(n.object);
+    writeNode(n.body);
+}
+
+void AstSerializer::writeDebuggerStatement(AstNode&)
+{
+}
+
+void AstSerializer::writeReturnStatement(AstNode& node)
+{
+    writeNode(static_cast<ReturnStatement&>(node).argument);
+}
+
+void AstSerializer::writeLabeledStatement(AstNode& node)
+{
+    auto& n = static_cast<LabeledStatement&>(node);
+    writeNode(n.label);
+    writeNode(n.body);
+}
+
+void AstSerializer::writeBreakStatement(AstNode& node)
+{
+    writeNode(static_cast<BreakStatement&>(node).label);
+}
+
+void AstSerializer::writeContinueStatement(AstNode& node)
+{
+    writeNode(static_cast<ContinueStatement&>(node).label);
+}
+
+void AstSerializer::writeIfStatement(AstNode& node)
+{
+    auto& n = static_cast<IfStatement&>(node);
+    writeNode(n.test);
+    writeNode(n.consequent);
+    writeNode(n.alternate);
+}
+
+void AstSerializer::writeSwitchStatement(AstNode& node)
+{
+    auto& n = static_cast<SwitchStatement&>(node);
+    writeNode(n.discriminant);
+    writeNodes(n.cases);
+}
+
+void AstSerializer::writeSwitchCase(AstNode& node)
+{
+    auto& n = static_cast<SwitchCase&>(node);
+    writeNode(n.testOrDefault);
+    writeNodes(n.consequent);
+}
+
+void AstSerializer::writeThrowStatement(AstNode& node)
+{
+    writeNode(static_cast<ThrowStatement&>(node).argument);
+}
+
+void AstSerializer::writeTryStatement(AstNode& node)
+{
+    auto& n = static_cast<TryStatement&>(node);
+    writeNode(n.block);
+    writeNode(n.handler);
+    writeNode(n.finalizer);
+}
+
+void AstSerializer::writeCatchClause(AstNode& node)
+{
+    auto& n = static_cast<CatchClause&>(node);
+    writeNode(n.param);
+    writeNode(n.body);
+}
+
+void AstSerializer::writeWhileStatement(AstNode& node)
+{
+    auto& n = static_cast<WhileStatement&>(node);
+    writeNode(n.test);
+    writeNode(n.body);
+}
+
+void AstSerializer::writeDoWhileStatement(AstNode& node)
+{
+    auto& n = static_cast<DoWhileStatement&>(node);
+    writeNode(n.test);
+    writeNode(n.body);
+}
+
+void AstSerializer::writeForStatement(AstNode& node)
+{
+    auto& n = static_cast<ForStatement&>(node);
+    writeNode(n.init);
+    writeNode(n.test);
+    writeNode(n.update);
+    writeNode(n.body);
+}
+
+void AstSerializer::writeForInStatement(AstNode& node)
+{
+    auto& n = static_cast<ForInStatement&>(node);
+    writeNode(n.left);
+    writeNode(n.right);
+    writeNode(n.body);
+}
+
+void AstSerializer::writeForOfStatement(AstNode& node)
+{
+    auto& n = static_cast<ForOfStatement&>(node);
+    writeNode(n.left);
+    writeNode(n.right);
+    writeNode(n.body);
+    writeBool(n.isAwait);
+}
+
+void AstSerializer::writeSuper(AstNode&)
+{
+}
+
+void AstSerializer::writeImport(AstNode&)
+{
+}
+
+void AstSerializer::writeThisExpression(AstNode&)
+{
+}
+
+void AstSerializer::writeArrowFunctionExpression(AstNode& node)
+{
+    auto& n = static_cast<ArrowFunctionExpression&>(node);
+    writeNode(n.id);
+    writeNodes(n.params);
+    writeNode(n.body);
+    writeNode(n.typeParameters);
+    writeNode(n.returnType);
+    writeBool(n.generator);
+    writeBool(n.async);
+    writeBool(n.expression);
+}
+
+void AstSerializer::writeYieldExpression(AstNode& node)
+{
+    auto& n = static_cast<YieldExpression&>(node);
+    writeNode(n.argument);
+    writeBool(n.isDelegate);
+}
+
+void AstSerializer::writeAwaitExpression(AstNode& node)
+{
+    writeNode(static_cast<AwaitExpression&>(node).argument);
+}
+
+void AstSerializer::writeArrayExpression(AstNode& node)
+{
+    writeNodes(static_cast<ArrayExpression&>(node).elements);
+}
+
+void AstSerializer::writeObjectExpression(AstNode& node)
+{
+    writeNodes(static_cast<ObjectExpression&>(node).properties);
+}
+
+void AstSerializer::writeConditionalExpression(AstNode& node)
+{
+    auto& n = static_cast<ConditionalExpression&>(node);
+    writeNode(n.test);
+    writeNode(n.alternate);
+    writeNode(n.consequent);
+}
+
+void AstSerializer::writeFunctionExpression(AstNode& node)
+{
+    auto& n = static_cast<FunctionExpression&>(node);
+    writeNode(n.id);
+    writeNodes(n.params);
+    writeNode(n.body);
+    writeNode(n.typeParameters);
+    writeNode(n.returnType);
+    writeBool(n.generator);
+    writeBool(n.async);
+}
+
+void AstSerializer::writeUnaryExpression(AstNode& node)
+{
+    auto& n = static_cast<UnaryExpression&>(node);
+    writeNode(n.argument);
+    writeEnum(n.unaryOperator);
+    writeBool(n.isPrefix);
+}
+
+void AstSerializer::writeUpdateExpression(AstNode& node)
+{
+    auto& n = static_cast<UpdateExpression&>(node);
+    writeNode(n.argument);
+    writeEnum(n.updateOperator);
+    writeBool(n.prefix);
+}
+
+void AstSerializer::writeBinaryExpression(AstNode& node)
+{
+    auto& n = static_cast<BinaryExpression&>(node);
+    writeNode(n.left);
+    writeNode(n.right);
+    writeEnum(n.binaryOperator);
+}
+
+void AstSerializer::writeAssignmentExpression(AstNode& node)
+{
+    auto& n = static_cast<AssignmentExpression&>(node);
+    writeNode(n.left);
+    writeNode(n.right);
+    writeEnum(n.assignmentOperator);
+}
+
+void AstSerializer::writeLogicalExpression(AstNode& node)
+{
+    auto& n = static_cast<LogicalExpression&>(node);
+    writeNode(n.left);
+    writeNode(n.right);
+    writeEnum(n.logicalOperator);
+}
+
+void AstSerializer::writeMemberExpression(AstNode& node)
+{
+    auto& n = static_cast<MemberExpression&>(node);
+    writeNode(n.object);
+    writeNode(n.property);
+    writeBool(n.computed);
+}
+
+void AstSerializer::writeBindExpression(AstNode& node)
+{
+    auto& n = static_cast<BindExpression&>(node);
+    writeNode(n.object);
+    writeNode(n.callee);
+}
+
+void AstSerializer::writeCallExpression(AstNode& node)
+{
+    auto& n = static_cast<CallExpression&>(node);
+    writeNode(n.callee);
+    writeNodes(n.arguments);
+}
+
+void AstSerializer::writeNewExpression(AstNode& node)
+{
+    writeCallExpression(node);
+}
+
+void AstSerializer::writeSequenceExpression(AstNode& node)
+{
+    writeNodes(static_cast<SequenceExpression&>(node).expressions);
+}
+
+void AstSerializer::writeDoExpression(AstNode& node)
+{
+    writeNode(static_cast<DoExpression&>(node).body);
+}
+
+void AstSerializer::writeClassExpression(AstNode& node)
+{
+    auto& n = static_cast<ClassExpression&>(node);
+    writeNode(n.id);
+    writeNode(n.superClass);
+    writeNode(n.body);
+    writeNode(n.typeParameters);
+    writeNode(n.superTypeParameters);
+    writeNodes(n.implements);
+}
+
+void AstSerializer::writeClassBody(AstNode& node)
+{
+    writeNodes(static_cast<ClassBody&>(node).body);
+}
+
+void AstSerializer::writeClassMethod(AstNode& node)
+{
+    auto& n = static_cast<ClassMethod&>(node);
+    writeNode(n.id);
+    writeNodes(n.params);
+    writeNode(n.body);
+    writeNode(n.key);
+    writeNode(n.typeParameters);
+    writeNode(n.returnType);
+    writeEnum(n.kind);
+    writeBool(n.generator);
+    writeBool(n.async);
+    writeBool(n.computed);
+    writeBool(n.staticMethod);
+}
+
+void AstSerializer::writeClassPrivateMethod(AstNode& node)
+{
+    auto& n = static_cast<ClassPrivateMethod&>(node);
+    writeNode(n.id);
+    writeNodes(n.params);
+    writeNode(n.body);
+    writeNode(n.key);
+    writeNode(n.typeParameters);
+    writeNode(n.returnType);
+    writeEnum(n.kind);
+    writeBool(n.generator);
+    writeBool(n.async);
+    writeBool(n.staticMethod);
+}
+
+void AstSerializer::writeClassProperty(AstNode& node)
+{
+    auto& n = static_cast<ClassProperty&>(node);
+    writeNode(n.key);
+    writeNode(n.value);
+    writeNode(n.typeAnnotation);
+    writeBool(n.staticProp);
+    writeBool(n.computed);
+}
+
+void AstSerializer::writeClassPrivateProperty(AstNode& node)
+{
+    auto& n = static_cast<ClassPrivateProperty&>(node);
+    writeNode(n.key);
+    writeNode(n.value);
+    writeNode(n.typeAnnotation);
+    writeBool(n.staticProp);
+}
+
+void AstSerializer::writeClassDeclaration(AstNode& node)
+{
+    auto& n = static_cast<ClassDeclaration&>(node);
+    writeNode(n.id);
+    writeNode(n.superClass);
+    writeNode(n.body);
+    writeNode(n.typeParameters);
+    writeNode(n.superTypeParameters);
+    writeNodes(n.implements);
+}
+
+void AstSerializer::writeVariableDeclaration(AstNode& node)
+{
+    auto& n = static_cast<VariableDeclaration&>(node);
+    writeNodes(n.declarators);
+    writeEnum(n.kind);
+}
+
+void AstSerializer::writeFunctionDeclaration(AstNode& node)
+{
+    auto& n = static_cast<FunctionDeclaration&>(node);
+    writeNode(n.id);
+    writeNodes(n.params);
+    writeNode(n.body);
+    writeNode(n.typeParameters);
+    writeNode(n.returnType);
+    writeBool(n.generator);
+    writeBool(n.async);
+}
+
+void AstSerializer::writeVariableDeclarator(AstNode& node)
+{
+    auto& n = static_cast<VariableDeclarator&>(node);
+    writeNode(n.id);
+    writeNode(n.init);
+}
+
+void AstSerializer::writeSpreadElement(AstNode& node)
+{
+    writeNode(static_cast<SpreadElement&>(node).argument);
+}
+
+void AstSerializer::writeObjectPattern(AstNode& node)
+{
+    auto& n = static_cast<ObjectPattern&>(node);
+    writeNodes(n.properties);
+    writeNode(n.typeAnnotation);
+}
+
+void AstSerializer::writeArrayPattern(AstNode& node)
+{
+    writeNodes(static_cast<ArrayPattern&>(node).elements);
+}
+
+void AstSerializer::writeAssignmentPattern(AstNode& node)
+{
+    auto& n = static_cast<AssignmentPattern&>(node);
+    writeNode(n.left);
+    writeNode(n.right);
+}
+
+void AstSerializer::writeRestElement(AstNode& node)
+{
+    auto& n = static_cast<RestElement&>(node);
+    writeNode(n.argument);
+    writeNode(n.typeAnnotation);
+}
+
+void AstSerializer::writeMetaProperty(AstNode& node)
+{
+    auto& n = static_cast<MetaProperty&>(node);
+    writeNode(n.meta);
+    writeNode(n.property);
+}
+
+void AstSerializer::writeImportDeclaration(AstNode& node)
+{
+    auto& n = static_cast<ImportDeclaration&>(node);
+    writeNodes(n.specifiers);
+    writeNode(n.source);
+    writeEnum(n.kind);
+}
+
+void AstSerializer::writeImportSpecifier(AstNode& node)
+{
+    auto& n = static_cast<ImportSpecifier&>(node);
+    writeNode(n.local);
+    writeNode(n.imported);
+    writeBool(n.typeImport);
+}
+
+void AstSerializer::writeImportDefaultSpecifier(AstNode& node)
+{
+    writeNode(static_cast<ImportDefaultSpecifier&>(node).local);
+}
+
+void AstSerializer::writeImportNamespaceSpecifier(AstNode& node)
+{
+    writeNode(static_cast<ImportNamespaceSpecifier&>(node).local);
+}
+
+void AstSerializer::writeExportNamedDeclaration(AstNode& node)
+{
+    auto& n = static_cast<ExportNamedDeclaration&>(node);
+    writeNode(n.declaration);
+    writeNode(n.source);
+    writeNodes(n.specifiers);
+    writeEnum(n.kind);
+}
+
+void AstSerializer::writeExportDefaultDeclaration(AstNode& node)
+{
+    writeNode(static_cast<ExportDefaultDeclaration&>(node).declaration);
+}
+
+void AstSerializer::writeExportAllDeclaration(AstNode& node)
+{
+    writeNode(static_cast<ExportAllDeclaration&>(node).source);
+}
+
+void AstSerializer::writeExportSpecifier(AstNode& node)
+{
+    auto& n = static_cast<ExportSpecifier&>(node);
+    writeNode(n.local);
+    writeNode(n.exported);
+}
+
+void AstSerializer::writeExportDefaultSpecifier(AstNode& node)
+{
+    writeNode(static_cast<ExportDefaultSpecifier&>(node).exported);
+}
+
+void AstSerializer::writeTypeAnnotation(AstNode& node)
+{
+    writeNode(static_cast<TypeAnnotation&>(node).typeAnnotation);
+}
+
+void AstSerializer::writeGenericTypeAnnotation(AstNode& node)
+{
+    auto& n = static_cast<GenericTypeAnnotation&>(node);
+    writeNode(n.id);
+    writeNode(n.typeParameters);
+}
+
+void AstSerializer::writeTypeParameterInstantiation(AstNode& node)
+{
+    writeNodes(static_cast<TypeParameterInstantiation&>(node).params);
+}
+
+void AstSerializer::writeTypeParameterDeclaration(AstNode& node)
+{
+    writeNodes(static_cast<TypeParameterDeclaration&>(node).params);
+}
+
+void AstSerializer::writeTypeParameter(AstNode& node)
+{
+    auto& n = static_cast<TypeParameter&>(node);
+    writeString(n.name->getName()); // The name identifier is recreated by the constructor
+    writeNode(n.bound);
+}
+
+void AstSerializer::writeStringTypeAnnotation(AstNode&)
+{
+}
+
+void AstSerializer::writeNumberTypeAnnotation(AstNode&)
+{
+}
+
+void AstSerializer::writeBooleanTypeAnnotation(AstNode&)
+{
+}
+
+void AstSerializer::writeVoidTypeAnnotation(AstNode&)
+{
+}
+
+void AstSerializer::writeAnyTypeAnnotation(AstNode&)
+{
+}
+
+void AstSerializer::writeExistsTypeAnnotation(AstNode&)
+{
+}
+
+void AstSerializer::writeMixedTypeAnnotation(AstNode&)
+{
+}
+
+void AstSerializer::writeNullableTypeAnnotation(AstNode& node)
+{
+    writeNode(static_cast<NullableTypeAnnotation&>(node).typeAnnotation);
+}
+
+void AstSerializer::writeArrayTypeAnnotation(AstNode& node)
+{
+    writeNode(static_cast<ArrayTypeAnnotation&>(node).elementType);
+}
+
+void AstSerializer::writeTupleTypeAnnotation(AstNode& node)
+{
+    writeNodes(static_cast<TupleTypeAnnotation&>(node).types);
+}
+
+void AstSerializer::writeUnionTypeAnnotation(AstNode& node)
+{
+    writeNodes(static_cast<UnionTypeAnnotation&>(node).types);
+}
+
+void AstSerializer::writeIntersectionTypeAnnotation(AstNode& node)
+{
+    writeNodes(static_cast<IntersectionTypeAnnotation&>(node).types);
+}
+
+void AstSerializer::writeTypeofTypeAnnotation(AstNode& node)
+{
+    writeNode(static_cast<TypeofTypeAnnotation&>(node).argument);
+}
+
+void AstSerializer::writeNullLiteralTypeAnnotation(AstNode&)
+{
+}
+
+void AstSerializer::writeNumberLiteralTypeAnnotation(AstNode& node)
+{
+    write(static_cast<NumberLiteralTypeAnnotation&>(node).value);
+}
+
+void AstSerializer::writeStringLiteralTypeAnnotation(AstNode& node)
+{
+    writeString(static_cast<StringLiteralTypeAnnotation&>(node).value);
+}
+
+void AstSerializer::writeBooleanLiteralTypeAnnotation(AstNode& node)
+{
+    writeBool(static_cast<BooleanLiteralTypeAnnotation&>(node).value);
+}
+
+void AstSerializer::writeFunctionTypeAnnotation(AstNode& node)
+{
+    auto& n = static_cast<FunctionTypeAnnotation&>(node);
+    writeNodes(n.params);
+    writeNode(n.rest);
+    writeNode(n.returnType);
+}
+
+void AstSerializer::writeFunctionTypeParam(AstNode& node)
+{
+    auto& n = static_cast<FunctionTypeParam&>(node);
+    writeNode(n.name);
+    writeNode(n.typeAnnotation);
+}
+
+void AstSerializer::writeObjectTypeAnnotation(AstNode& node)
+{
+    auto& n = static_cast<ObjectTypeAnnotation&>(node);
+    writeNodes(n.properties);
+    writeNodes(n.indexers);
+    writeBool(n.exact);
+}
+
+void AstSerializer::writeObjectTypeProperty(AstNode& node)
+{
+    auto& n = static_cast<ObjectTypeProperty&>(node);
+    writeNode(n.key);
+    writeNode(n.value);
+    writeBool(n.optional);
+}
+
+void AstSerializer::writeObjectTypeIndexer(AstNode& node)
+{
+    auto& n = static_cast<ObjectTypeIndexer&>(node);
+    writeNode(n.id);
+    writeNode(n.key);
+    writeNode(n.value);
+}
+
+void AstSerializer::writeObjectTypeSpreadProperty(AstNode& node)
+{
+    writeNode(static_cast<ObjectTypeSpreadProperty&>(node).argument);
+}
+
+void AstSerializer::writeTypeAlias(AstNode& node)
+{
+    auto& n = static_cast<TypeAlias&>(node);
+    writeNode(n.id);
+    writeNode(n.typeParameters);
+    writeNode(n.right);
+}
+
+void AstSerializer::writeTypeCastExpression(AstNode& node)
+{
+    auto& n = static_cast<TypeCastExpression&>(node);
+    writeNode(n.expression);
+    writeNode(n.typeAnnotation);
+}
+
+void AstSerializer::writeClassImplements(AstNode& node)
+{
+    auto& n = static_cast<ClassImplements&>(node);
+    writeNode(n.id);
+    writeNode(n.typeParameters);
+}
+
+void AstSerializer::writeQualifiedTypeIdentifier(AstNode& node)
+{
+    auto& n = static_cast<QualifiedTypeIdentifier&>(node);
+    writeNode(n.qualification);
+    writeNode(n.id);
+}
+
+void AstSerializer::writeInterfaceDeclaration(AstNode& node)
+{
+    auto& n = static_cast<InterfaceDeclaration&>(node);
+    writeNode(n.id);
+    writeNode(n.typeParameters);
+    writeNode(n.body);
+    writeNodes(n.extends);
+    writeNodes(n.mixins);
+}
+
+void AstSerializer::writeInterfaceExtends(AstNode& node)
+{
+    auto& n = static_cast<InterfaceExtends&>(node);
+    writeNode(n.id);
+    writeNode(n.typeParameters);
+}
+
+void AstSerializer::writeDeclareVariable(AstNode& node)
+{
+    writeNode(static_cast<DeclareVariable&>(node).id);
+}
+
+void AstSerializer::writeDeclareFunction(AstNode& node)
+{
+    writeNode(static_cast<DeclareFunction&>(node).id);
+}
+
+void AstSerializer::writeDeclareTypeAlias(AstNode& node)
+{
+    auto& n = static_cast<DeclareTypeAlias&>(node);
+    writeNode(n.id);
+    writeNode(n.right);
+}
+
+void AstSerializer::writeDeclareClass(AstNode& node)
+{
+    auto& n = static_cast<DeclareClass&>(node);
+    writeNode(n.id);
+    writeNode(n.typeParameters);
+    writeNode(n.body);
+    writeNodes(n.extends);
+    writeNodes(n.mixins);
+}
+
+void AstSerializer::writeDeclareModule(AstNode& node)
+{
+    auto& n = static_cast<DeclareModule&>(node);
+    writeNode(n.id);
+    writeNode(n.body);
+}
+
+void AstSerializer::writeDeclareExportDeclaration(AstNode& node)
+{
+    writeNode(static_cast<DeclareExportDeclaration&>(node).declaration);
+}
+
+// The read functions construct nodes with braced initializers, which guarantees the fields are read left to right.
+// If the data turns out to be corrupt, the nodes read so far are freed along with the arena when the exception unwinds.
+#define X(NODE) static AstNode* read##NODE(AstReader& r, AstSourceSpan& loc);
+IMPORTED_NODE_LIST(X)
+#undef X
+
+#define X(NODE) read##NODE,
+static AstNode* (* const readFunctions[])(AstReader&, AstSourceSpan&) = {
+    IMPORTED_NODE_LIST(X)
+};
+#undef X
+
+AstRoot* deserializeAst(Module& parentModule, const uint8_t* data, size_t size)
+{
+    AstReader r{data, size};
+    if (r.read<uint32_t>() != astFormatMagic)
+        throw runtime_error("Not a serialized AST");
+    if (r.read<uint32_t>() != astFormatVersion)
+        throw runtime_error("Serialized AST has an incompatible version");
+
+    auto arena = make_unique<AstArena>();
+    AstArena::Scope arenaScope(*arena);
+    auto loc = r.readSpan();
+    auto body = r.readNodes();
+    auto comments = r.readNodes<AstComment>();
+    if (!r.atEnd())
+        throw runtime_error("Trailing data after serialized AST");
+    return new AstRoot{loc, parentModule, move(body), move(comments), move(arena)};
+}
+
+void AstReader::require(size_t size)
+{
+    if (static_cast<size_t>(end - pos) < size)
+        throw runtime_error("Serialized AST is truncated");
+}
+
+template <class T>
+T AstReader::read()
+{
+    require(sizeof(T));
+    T value;
+    memcpy(&value, pos, sizeof(T));
+    pos += sizeof(T);
+    return value;
+}
+
+string AstReader::readString()
+{
+    auto size = read<uint32_t>();
+    require(size);
+    string str{reinterpret_cast<const char*>(pos), size};
+    pos += size;
+    return str;
+}
+
+Atom AstReader::readAtom()
+{
+    auto size = read<uint32_t>();
+    require(size);
+    Atom atom{string_view{reinterpret_cast<const char*>(pos), size}};
+    pos += size;
+    return atom;
+}
+
+AstSourceSpan AstReader::readSpan()
+{
+    uint32_t values[2];
+    require(sizeof(values));
+    memcpy(values, pos, sizeof(values));
+    pos += sizeof(values);
+    return {values[0], values[1]};
+}
+
+AstNode* AstReader::readNode()
+{
+    auto tag = read<uint8_t>();
+    if (tag == nullNodeTag)
+        return nullptr;
+    if (tag <= static_cast<uint8_t>(AstNodeType::Root) || tag >= static_cast<uint8_t>(AstNodeType::Invalid))
+        throw runtime_error("Invalid node type "s + to_string(tag) + " in serialized AST");
+    auto loc = readSpan();
+    return readFunctions[tag - 1](*this, loc);
+}
+
+template <class T>
+vector<T*> AstReader::readNodes()
+{
+    auto count = read<uint32_t>();
+    require(count); // Each node takes at least one byte, this protects against huge allocations from corrupt counts
+    vector<T*> result;
+    result.reserve(count);
+    for (uint32_t i=0; i<count; ++i)
+        result.push_back(static_cast<T*>(readNode()));
+    return result;
+}
+
+AstNode* readCommentLine(AstReader& r, AstSourceSpan& loc)
+{
+    return new AstComment(loc, AstComment::Type::Line, r.readString());
+}
+
+AstNode* readCommentBlock(AstReader& r, AstSourceSpan& loc)
+{
+    return new AstComment(loc, AstComment::Type::Block, r.readString());
+}
+
+AstNode* readIdentifier(AstReader& r, AstSourceSpan& loc)
+{
+    return new Identifier{loc, r.readAtom(), (TypeAnnotation*)r.readNode(), r.readBool()};
+}
+
+AstNode* readRegExpLiteral(AstReader& r, AstSourceSpan& loc)
+{
+    return new RegExpLiteral{loc, r.readString(), r.readString()};
+}
+
+AstNode* readNullLiteral(AstReader&, AstSourceSpan& loc)
+{
+    return new NullLiteral(loc);
+}
+
+AstNode* readStringLiteral(AstReader& r, AstSourceSpan& loc)
+{
+    return new StringLiteral(loc, r.readAtom());
+}
+
+AstNode* readBooleanLiteral(AstReader& r, AstSourceSpan& loc)
+{
+    return new BooleanLiteral(loc, r.readBool());
+}
+
+AstNode* readNumericLiteral(AstReader& r, AstSourceSpan& loc)
+{
+    return new NumericLiteral(loc, r.read<double>());
+}
+
+AstNode* readTemplateLiteral(AstReader& r, AstSourceSpan& loc)
+{
+    return new TemplateLiteral{loc, r.readNodes(), r.readNodes()};
+}
+
+AstNode* readTemplateElement(AstReader& r, AstSourceSpan& loc)
+{
+    return new TemplateElement{loc, r.readString(), r.readBool()};
+}
+
+AstNode* readTaggedTemplateExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new TaggedTemplateExpression{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readObjectProperty(AstReader& r, AstSourceSpan& loc)
+{
+    return new ObjectProperty{loc, r.readNode(), r.readNode(), r.readBool(), r.readBool()};
+}
+
+AstNode* readObjectMethod(AstReader& r, AstSourceSpan& loc)
+{
+    return new ObjectMethod{loc, r.readNode(), r.readNodes(), r.readNode(),
+                            (TypeParameterDeclaration*)r.readNode(), (TypeAnnotation*)r.readNode(), r.readNode(),
+                            r.readEnum<ObjectMethod::Kind>(), r.readBool(), r.readBool(), r.readBool()};
+}
+
+AstNode* readExpressionStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new ExpressionStatement(loc, r.readNode());
+}
+
+AstNode* readBlockStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new BlockStatement(loc, r.readNodes());
+}
+
+AstNode* readEmptyStatement(AstReader&, AstSourceSpan& loc)
+{
+    return new EmptyStatement(loc);
+}
+
+AstNode* readWithStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new WithStatement{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readDebuggerStatement(AstReader&, AstSourceSpan& loc)
+{
+    return new DebuggerStatement(loc);
+}
+
+AstNode* readReturnStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new ReturnStatement(loc, r.readNode());
+}
+
+AstNode* readLabeledStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new LabeledStatement{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readBreakStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new BreakStatement(loc, r.readNode());
+}
+
+AstNode* readContinueStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new ContinueStatement(loc, r.readNode());
+}
+
+AstNode* readIfStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new IfStatement{loc, r.readNode(), r.readNode(), r.readNode()};
+}
+
+AstNode* readSwitchStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new SwitchStatement{loc, r.readNode(), r.readNodes<SwitchCase>()};
+}
+
+AstNode* readSwitchCase(AstReader& r, AstSourceSpan& loc)
+{
+    return new SwitchCase{loc, r.readNode(), r.readNodes()};
+}
+
+AstNode* readThrowStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new ThrowStatement(loc, r.readNode());
+}
+
+AstNode* readTryStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new TryStatement{loc, r.readNode(), r.readNode(), r.readNode()};
+}
+
+AstNode* readCatchClause(AstReader& r, AstSourceSpan& loc)
+{
+    return new CatchClause{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readWhileStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new WhileStatement{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readDoWhileStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new DoWhileStatement{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readForStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new ForStatement{loc, r.readNode(), r.readNode(), r.readNode(), r.readNode()};
+}
+
+AstNode* readForInStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new ForInStatement{loc, r.readNode(), r.readNode(), r.readNode()};
+}
+
+AstNode* readForOfStatement(AstReader& r, AstSourceSpan& loc)
+{
+    return new ForOfStatement{loc, r.readNode(), r.readNode(), r.readNode(), r.readBool()};
+}
+
+AstNode* readSuper(AstReader&, AstSourceSpan& loc)
+{
+    return new Super(loc);
+}
+
+AstNode* readImport(AstReader&, AstSourceSpan& loc)
+{
+    return new Import(loc);
+}
+
+AstNode* readThisExpression(AstReader&, AstSourceSpan& loc)
+{
+    return new ThisExpression(loc);
+}
+
+AstNode* readArrowFunctionExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new ArrowFunctionExpression{loc, r.readNode(), r.readNodes(), r.readNode(),
+                                       (TypeParameterDeclaration*)r.readNode(), (TypeAnnotation*)r.readNode(),
+                                       r.readBool(), r.readBool(), r.readBool()};
+}
+
+AstNode* readYieldExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new YieldExpression{loc, r.readNode(), r.readBool()};
+}
+
+AstNode* readAwaitExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new AwaitExpression(loc, r.readNode());
+}
+
+AstNode* readArrayExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new ArrayExpression(loc, r.readNodes());
+}
+
+AstNode* readObjectExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new ObjectExpression(loc, r.readNodes());
+}
+
+AstNode* readConditionalExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new ConditionalExpression{loc, r.readNode(), r.readNode(), r.readNode()};
+}
+
+AstNode* readFunctionExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new FunctionExpression{loc, r.readNode(), r.readNodes(), r.readNode(),
+                                  (TypeParameterDeclaration*)r.readNode(), (TypeAnnotation*)r.readNode(),
+                                  r.readBool(), r.readBool()};
+}
+
+AstNode* readUnaryExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new UnaryExpression{loc, r.readNode(), r.readEnum<UnaryExpression::Operator>(), r.readBool()};
+}
+
+AstNode* readUpdateExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new UpdateExpression{loc, r.readNode(), r.readEnum<UpdateExpression::Operator>(), r.readBool()};
+}
+
+AstNode* readBinaryExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new BinaryExpression{loc, r.readNode(), r.readNode(), r.readEnum<BinaryExpression::Operator>()};
+}
+
+AstNode* readAssignmentExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new AssignmentExpression{loc, r.readNode(), r.readNode(), r.readEnum<AssignmentExpression::Operator>()};
+}
+
+AstNode* readLogicalExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new LogicalExpression{loc, r.readNode(), r.readNode(), r.readEnum<LogicalExpression::Operator>()};
+}
+
+AstNode* readMemberExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new MemberExpression{loc, r.readNode(), r.readNode(), r.readBool()};
+}
+
+AstNode* readBindExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new BindExpression{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readCallExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new CallExpression{loc, r.readNode(), r.readNodes()};
+}
+
+AstNode* readNewExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new NewExpression{loc, r.readNode(), r.readNodes()};
+}
+
+AstNode* readSequenceExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new SequenceExpression(loc, r.readNodes());
+}
+
+AstNode* readDoExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new DoExpression(loc, r.readNode());
+}
+
+AstNode* readClassExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new ClassExpression{loc, r.readNode(), r.readNode(), r.readNode(),
+                               (TypeParameterDeclaration*)r.readNode(), (TypeParameterInstantiation*)r.readNode(),
+                               r.readNodes<ClassImplements>()};
+}
+
+AstNode* readClassBody(AstReader& r, AstSourceSpan& loc)
+{
+    return new ClassBody(loc, r.readNodes());
+}
+
+AstNode* readClassMethod(AstReader& r, AstSourceSpan& loc)
+{
+    return new ClassMethod{loc, r.readNode(), r.readNodes(), r.readNode(), r.readNode(),
+                           (TypeParameterDeclaration*)r.readNode(), (TypeAnnotation*)r.readNode(),
+                           r.readEnum<ClassMethod::Kind>(), r.readBool(), r.readBool(), r.readBool(), r.readBool()};
+}
+
+AstNode* readClassPrivateMethod(AstReader& r, AstSourceSpan& loc)
+{
+    return new ClassPrivateMethod{loc, r.readNode(), r.readNodes(), r.readNode(), r.readNode(),
+                                  (TypeParameterDeclaration*)r.readNode(), (TypeAnnotation*)r.readNode(),
+                                  r.readEnum<ClassPrivateMethod::Kind>(), r.readBool(), r.readBool(), r.readBool()};
+}
+
+AstNode* readClassProperty(AstReader& r, AstSourceSpan& loc)
+{
+    return new ClassProperty{loc, r.readNode(), r.readNode(), (TypeAnnotation*)r.readNode(), r.readBool(), r.readBool()};
+}
+
+AstNode* readClassPrivateProperty(AstReader& r, AstSourceSpan& loc)
+{
+    return new ClassPrivateProperty{loc, r.readNode(), r.readNode(), (TypeAnnotation*)r.readNode(), r.readBool()};
+}
+
+AstNode* readClassDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new ClassDeclaration{loc, r.readNode(), r.readNode(), r.readNode(),
+                                (TypeParameterDeclaration*)r.readNode(), (TypeParameterInstantiation*)r.readNode(),
+                                r.readNodes<ClassImplements>()};
+}
+
+AstNode* readVariableDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new VariableDeclaration{loc, r.readNodes<VariableDeclarator>(), r.readEnum<VariableDeclaration::Kind>()};
+}
+
+AstNode* readFunctionDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new FunctionDeclaration{loc, r.readNode(), r.readNodes(), r.readNode(),
+                                   (TypeParameterDeclaration*)r.readNode(), (TypeAnnotation*)r.readNode(),
+                                   r.readBool(), r.readBool()};
+}
+
+AstNode* readVariableDeclarator(AstReader& r, AstSourceSpan& loc)
+{
+    return new VariableDeclarator{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readSpreadElement(AstReader& r, AstSourceSpan& loc)
+{
+    return new SpreadElement(loc, r.readNode());
+}
+
+AstNode* readObjectPattern(AstReader& r, AstSourceSpan& loc)
+{
+    return new ObjectPattern{loc, r.readNodes(), (TypeAnnotation*)r.readNode()};
+}
+
+AstNode* readArrayPattern(AstReader& r, AstSourceSpan& loc)
+{
+    return new ArrayPattern(loc, r.readNodes());
+}
+
+AstNode* readAssignmentPattern(AstReader& r, AstSourceSpan& loc)
+{
+    return new AssignmentPattern{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readRestElement(AstReader& r, AstSourceSpan& loc)
+{
+    return new RestElement{loc, r.readNode(), (TypeAnnotation*)r.readNode()};
+}
+
+AstNode* readMetaProperty(AstReader& r, AstSourceSpan& loc)
+{
+    return new MetaProperty{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readImportDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new ImportDeclaration{loc, r.readNodes(), r.readNode(), r.readEnum<ImportDeclaration::Kind>()};
+}
+
+AstNode* readImportSpecifier(AstReader& r, AstSourceSpan& loc)
+{
+    return new ImportSpecifier{loc, r.readNode(), r.readNode(), r.readBool()};
+}
+
+AstNode* readImportDefaultSpecifier(AstReader& r, AstSourceSpan& loc)
+{
+    return new ImportDefaultSpecifier(loc, r.readNode());
+}
+
+AstNode* readImportNamespaceSpecifier(AstReader& r, AstSourceSpan& loc)
+{
+    return new ImportNamespaceSpecifier(loc, r.readNode());
+}
+
+AstNode* readExportNamedDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new ExportNamedDeclaration{loc, r.readNode(), r.readNode(), r.readNodes(), r.readEnum<ExportNamedDeclaration::Kind>()};
+}
+
+AstNode* readExportDefaultDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new ExportDefaultDeclaration(loc, r.readNode());
+}
+
+AstNode* readExportAllDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new ExportAllDeclaration(loc, r.readNode());
+}
+
+AstNode* readExportSpecifier(AstReader& r, AstSourceSpan& loc)
+{
+    return new ExportSpecifier{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readExportDefaultSpecifier(AstReader& r, AstSourceSpan& loc)
+{
+    return new ExportDefaultSpecifier(loc, r.readNode());
+}
+
+AstNode* readTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new TypeAnnotation(loc, r.readNode());
+}
+
+AstNode* readGenericTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new GenericTypeAnnotation{loc, r.readNode(), r.readNode()};
+}
+
+AstNode* readTypeParameterInstantiation(AstReader& r, AstSourceSpan& loc)
+{
+    return new TypeParameterInstantiation(loc, r.readNodes());
+}
+
+AstNode* readTypeParameterDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new TypeParameterDeclaration(loc, r.readNodes<TypeParameter>());
+}
+
+AstNode* readTypeParameter(AstReader& r, AstSourceSpan& loc)
+{
+    return new TypeParameter{loc, r.readAtom(), r.readNode()};
+}
+
+AstNode* readStringTypeAnnotation(AstReader&, AstSourceSpan& loc)
+{
+    return new StringTypeAnnotation(loc);
+}
+
+AstNode* readNumberTypeAnnotation(AstReader&, AstSourceSpan& loc)
+{
+    return new NumberTypeAnnotation(loc);
+}
+
+AstNode* readBooleanTypeAnnotation(AstReader&, AstSourceSpan& loc)
+{
+    return new BooleanTypeAnnotation(loc);
+}
+
+AstNode* readVoidTypeAnnotation(AstReader&, AstSourceSpan& loc)
+{
+    return new VoidTypeAnnotation(loc);
+}
+
+AstNode* readAnyTypeAnnotation(AstReader&, AstSourceSpan& loc)
+{
+    return new AnyTypeAnnotation(loc);
+}
+
+AstNode* readExistsTypeAnnotation(AstReader&, AstSourceSpan& loc)
+{
+    return new ExistsTypeAnnotation(loc);
+}
+
+AstNode* readMixedTypeAnnotation(AstReader&, AstSourceSpan& loc)
+{
+    return new MixedTypeAnnotation(loc);
+}
+
+AstNode* readNullableTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new NullableTypeAnnotation(loc, r.readNode());
+}
+
+AstNode* readArrayTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new ArrayTypeAnnotation(loc, r.readNode());
+}
+
+AstNode* readTupleTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new TupleTypeAnnotation(loc, r.readNodes());
+}
+
+AstNode* readUnionTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new UnionTypeAnnotation(loc, r.readNodes());
+}
+
+AstNode* readIntersectionTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new IntersectionTypeAnnotation(loc, r.readNodes());
+}
+
+AstNode* readTypeofTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new TypeofTypeAnnotation(loc, r.readNode());
+}
+
+AstNode* readNullLiteralTypeAnnotation(AstReader&, AstSourceSpan& loc)
+{
+    return new NullLiteralTypeAnnotation(loc);
+}
+
+AstNode* readNumberLiteralTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new NumberLiteralTypeAnnotation(loc, r.read<double>());
+}
+
+AstNode* readStringLiteralTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new StringLiteralTypeAnnotation(loc, r.readString());
+}
+
+AstNode* readBooleanLiteralTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new BooleanLiteralTypeAnnotation(loc, r.readBool());
+}
+
+AstNode* readFunctionTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new FunctionTypeAnnotation{loc, r.readNodes<FunctionTypeParam>(), (FunctionTypeParam*)r.readNode(), r.readNode()};
+}
+
+AstNode* readFunctionTypeParam(AstReader& r, AstSourceSpan& loc)
+{
+    return new FunctionTypeParam{loc, (Identifier*)r.readNode(), r.readNode()};
+}
+
+AstNode* readObjectTypeAnnotation(AstReader& r, AstSourceSpan& loc)
+{
+    return new ObjectTypeAnnotation{loc, r.readNodes(), r.readNodes<ObjectTypeIndexer>(), r.readBool()};
+}
+
+AstNode* readObjectTypeProperty(AstReader& r, AstSourceSpan& loc)
+{
+    return new ObjectTypeProperty{loc, (Identifier*)r.readNode(), r.readNode(), r.readBool()};
+}
+
+AstNode* readObjectTypeIndexer(AstReader& r, AstSourceSpan& loc)
+{
+    return new ObjectTypeIndexer{loc, (Identifier*)r.readNode(), r.readNode(), r.readNode()};
+}
+
+AstNode* readObjectTypeSpreadProperty(AstReader& r, AstSourceSpan& loc)
+{
+    return new ObjectTypeSpreadProperty(loc, r.readNode());
+}
+
+AstNode* readTypeAlias(AstReader& r, AstSourceSpan& loc)
+{
+    return new TypeAlias{loc, (Identifier*)r.readNode(), r.readNode(), r.readNode()};
+}
+
+AstNode* readTypeCastExpression(AstReader& r, AstSourceSpan& loc)
+{
+    return new TypeCastExpression{loc, r.readNode(), (TypeAnnotation*)r.readNode()};
+}
+
+AstNode* readClassImplements(AstReader& r, AstSourceSpan& loc)
+{
+    return new ClassImplements{loc, (Identifier*)r.readNode(), (TypeParameterInstantiation*)r.readNode()};
+}
+
+AstNode* readQualifiedTypeIdentifier(AstReader& r, AstSourceSpan& loc)
+{
+    return new QualifiedTypeIdentifier{loc, (Identifier*)r.readNode(), (Identifier*)r.readNode()};
+}
+
+AstNode* readInterfaceDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new InterfaceDeclaration{loc, (Identifier*)r.readNode(), (TypeParameterDeclaration*)r.readNode(), r.readNode(),
+                                    r.readNodes<InterfaceExtends>(), r.readNodes<InterfaceExtends>()};
+}
+
+AstNode* readInterfaceExtends(AstReader& r, AstSourceSpan& loc)
+{
+    return new InterfaceExtends{loc, (Identifier*)r.readNode(), (TypeParameterInstantiation*)r.readNode()};
+}
+
+AstNode* readDeclareVariable(AstReader& r, AstSourceSpan& loc)
+{
+    return new DeclareVariable(loc, (Identifier*)r.readNode());
+}
+
+AstNode* readDeclareFunction(AstReader& r, AstSourceSpan& loc)
+{
+    return new DeclareFunction(loc, (Identifier*)r.readNode());
+}
+
+AstNode* readDeclareTypeAlias(AstReader& r, AstSourceSpan& loc)
+{
+    return new DeclareTypeAlias{loc, (Identifier*)r.readNode(), r.readNode()};
+}
+
+AstNode* readDeclareClass(AstReader& r, AstSourceSpan& loc)
+{
+    return new DeclareClass{loc, (Identifier*)r.readNode(), (TypeParameterDeclaration*)r.readNode(), r.readNode(),
+                            r.readNodes<InterfaceExtends>(), r.readNodes<InterfaceExtends>()};
+}
+
+AstNode* readDeclareModule(AstReader& r, AstSourceSpan& loc)
+{
+    return new DeclareModule{loc, (StringLiteral*)r.readNode(), r.readNode()};
+}
+
+AstNode* readDeclareExportDeclaration(AstReader& r, AstSourceSpan& loc)
+{
+    return new DeclareExportDeclaration(loc, r.readNode());
+}
@@ -0,0 +1,21 @@
+#ifndef SERIALIZE_HPP
+#define SERIALIZE_HPP
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+
+class AstRoot;
+class Module;
+
+// Bump this whenever the binary format changes, or when a parser starts producing a different AST for the same source
+constexpr uint32_t astFormatVersion = 2;
+
+// Flat pre-order encoding of an AST. Each node is its u8 type tag (0xFF for a nullptr), its span as 2 u32 byte offsets,
+// then its fields in constructor order. Lists are a u32 count followed by their elements, strings a u32 size and UTF8 bytes.
+std::vector<uint8_t> serializeAst(AstRoot& root);
+
+// Throws a runtime_error if the data is truncated, corrupt, or from a different astFormatVersion
+AstRoot* deserializeAst(Module& parentModule, const uint8_t* data, size_t size);
+
+#endif // SERIALIZE_HPP
@@ -1,9 +1,9 @@
 #ifndef WALK_HPP
 #define WALK_HPP
 
-#include <functional>
-
-class AstNode;
+#include "ast/ast.hpp"
+#include <vector>
+#include <algorithm>
 
 enum class WalkDecision: unsigned {
     WalkInto = 0b00, // Process this node and walk into children
@@ -12,7 +12,38 @@ enum class WalkDecision: unsigned {
     SkipOver = 0b11, // Skip this node and children
 };
 
-using AstNodeCallback = std::function<void(AstNode&)>;
-void walkAst(AstNode& root, AstNodeCallback cb, std::function<WalkDecision(AstNode&)> predicate = [](auto&){return WalkDecision::WalkInto;});
+// Pre-order walk with an explicit stack, cb(AstNode&) is called for every node that the predicate doesn't skip
+template <class Callback, class Predicate>
+void walkAst(AstNode& root, Callback&& cb, Predicate&& predicate)
+{
+    std::vector<AstNode*> stack;
+    stack.reserve(64);
+    stack.push_back(&root);
+    while (!stack.empty()) {
+        AstNode& node = *stack.back();
+        stack.pop_back();
+
+        auto decision = predicate(node);
+        if (decision == WalkDecision::WalkInto || decision == WalkDecision::WalkOver)
+            cb(node);
+        if (decision == WalkDecision::WalkOver || decision == WalkDecision::SkipOver)
+            if (node.getType() != AstNodeType::Root) // Easy to forget, but we never want to skip the root's children
+                continue;
+
+        // Children are pushed in order, then reversed so the first one is popped first
+        size_t firstChild = stack.size();
+        node.applyChildren([&](AstNode* child) {
+            stack.push_back(child);
+            return true;
+        });
+        std::reverse(stack.begin() + firstChild, stack.end());
+    }
+}
+
+template <class Callback>
+void walkAst(AstNode& root, Callback&& cb)
+{
+    walkAst(root, cb, [](AstNode&) { return WalkDecision::WalkInto; });
+}
 
 #endif // WALK_HPP
@@ -0,0 +1,316 @@
+'use strict';
+// Entry point of the babel.js bundle.
+// parseToBuffer encodes the AST in the binary format of ast/serialize.hpp, so that the C++ side
+// can decode it in a single pass instead of reading every property of every node through the V8 API.
+const parser = require('@babel/parser');
+
+const astFormatMagic = 0x5441534A;
+const nullNodeTag = 0xFF;
+
+// Enum values are indices in these tables, which must follow the order of the enums in ast/ast.hpp
+const unaryOperators = ['-', '+', '!', '~', 'typeof', 'void', 'delete'];
+const updateOperators = ['++', '--'];
+const binaryOperators = ['==', '!=', '===', '!==', '<', '<=', '>', '>=', '<<', '>>', '>>>',
+                         '+', '-', '*', '/', '%', '**', '|', '^', '&', 'in', 'instanceof'];
+const assignmentOperators = ['=', '+=', '-=', '*=', '/=', '%=', '**=', '<<=', '>>=', '>>>=', '|=', '^=', '&='];
+const logicalOperators = ['||', '&&'];
+const methodKinds = ['constructor', 'method', 'get', 'set'];
+const privateMethodKinds = ['method', 'get', 'set'];
+const variableKinds = ['var', 'let', 'const'];
+const importKinds = ['value', 'type', null];
+const exportKinds = ['value', 'type'];
+
+class Writer {
+    constructor(sizeHint) {
+        this.bytes = new Uint8Array(sizeHint);
+        this.view = new DataView(this.bytes.buffer);
+        this.pos = 0;
+    }
+
+    reserve(size) {
+        if (this.pos + size <= this.bytes.length)
+            return;
+        const bytes = new Uint8Array(Math.max(this.bytes.length * 2, this.pos + size));
+        bytes.set(this.bytes.subarray(0, this.pos));
+        this.bytes = bytes;
+        this.view = new DataView(bytes.buffer);
+    }
+
+    u8(value) {
+        this.reserve(1);
+        this.bytes[this.pos++] = value;
+    }
+
+    u32(value) {
+        this.reserve(4);
+        this.view.setUint32(this.pos, value, true);
+        this.pos += 4;
+    }
+
+    f64(value) {
+        this.reserve(8);
+        this.view.setFloat64(this.pos, value, true);
+        this.pos += 8;
+    }
+
+    // UTF8, with lone surrogates replaced by U+FFFD like V8's String::Utf8Value does
+    string(str) {
+        this.reserve(4 + str.length * 3);
+        const bytes = this.bytes;
+        const start = this.pos + 4;
+        let pos = start;
+        for (let i = 0; i < str.length; ++i) {
+            let c = str.charCodeAt(i);
+            if (c < 0x80) {
+                bytes[pos++] = c;
+                continue;
+            }
+            if (c >= 0xD800 && c <= 0xDFFF) {
+                const next = i + 1 < str.length ? str.charCodeAt(i + 1) : 0;
+                if (c <= 0xDBFF && next >= 0xDC00 && next <= 0xDFFF) {
+                    c = 0x10000 + ((c - 0xD800) << 10) + (next - 0xDC00);
+                    ++i;
+                } else {
+                    c = 0xFFFD;
+                }
+            }
+            if (c < 0x800) {
+                bytes[pos++] = 0xC0 | (c >> 6);
+            } else if (c < 0x10000) {
+                bytes[pos++] = 0xE0 | (c >> 12);
+                bytes[pos++] = 0x80 | ((c >> 6) & 0x3F);
+            } else {
+                bytes[pos++] = 0xF0 | (c >> 18);
+                bytes[pos++] = 0x80 | ((c >> 12) & 0x3F);
+                bytes[pos++] = 0x80 | ((c >> 6) & 0x3F);
+            }
+            bytes[pos++] = 0x80 | (c & 0x3F);
+        }
+        this.view.setUint32(this.pos, pos - start, true);
+        this.pos = pos;
+    }
+
+    // Babel positions are UTF-16 indices, byteOffsets maps them to UTF-8 byte offsets
+    span(node) {
+        this.u32(this.byteOffsets[node.start]);
+        this.u32(this.byteOffsets[node.end]);
+    }
+}
+
+// Field encoders, each schema lists the fields of a node in the order of its C++ constructor
+const node = key => (w, n) => w.node(n[key]);
+const nodes = key => (w, n) => w.nodes(n[key]);
+const string = key => (w, n) => w.string(n[key]);
+const bool = key => (w, n) => w.u8(n[key] ? 1 : 0);
+const number = key => (w, n) => w.f64(n[key]);
+const enumOf = (key, values) => (w, n) => {
+    const value = values.indexOf(n[key] === undefined ? null : n[key]);
+    if (value < 0)
+        throw new Error('Unknown ' + key + ' ' + n[key] + ' for ' + n.type);
+    w.u8(value);
+};
+
+const functionFields = [node('id'), nodes('params'), node('body'), node('typeParameters'), node('returnType'),
+                        bool('generator'), bool('async')];
+const classFields = [node('id'), node('superClass'), node('body'), node('typeParameters'), node('superTypeParameters'),
+                     nodes('implements')];
+const interfaceFields = [node('id'), node('typeParameters'), node('body'), nodes('extends'), nodes('mixins')];
+
+const schemas = {
+    CommentLine: [string('value')],
+    CommentBlock: [string('value')],
+    Identifier: [string('name'), node('typeAnnotation'), bool('optional')],
+    RegExpLiteral: [string('pattern'), string('flags')],
+    NullLiteral: [],
+    StringLiteral: [string('value')],
+    BooleanLiteral: [bool('value')],
+    NumericLiteral: [number('value')],
+    TemplateLiteral: [nodes('quasis'), nodes('expressions')],
+    TemplateElement: [(w, n) => w.string(n.value.raw), bool('tail')],
+    TaggedTemplateExpression: [node('tag'), node('quasi')],
+    ObjectProperty: [node('key'), node('value'), bool('shorthand'), bool('computed')],
+    ObjectMethod: [node('id'), nodes('params'), node('body'), node('typeParameters'), node('returnType'), node('key'),
+                   enumOf('kind', methodKinds), bool('generator'), bool('async'), bool('computed')],
+    ExpressionStatement: [node('expression')],
+    BlockStatement: [nodes('body')],
+    EmptyStatement: [],
+    WithStatement: [node('object'), node('body')],
+    DebuggerStatement: [],
+    ReturnStatement: [node('argument')],
+    LabeledStatement: [node('label'), node('body')],
+    BreakStatement: [node('label')],
+    ContinueStatement: [node('label')],
+    IfStatement: [node('test'), node('consequent'), node('alternate')],
+    SwitchStatement: [node('discriminant'), nodes('cases')],
+    SwitchCase: [node('test'), nodes('consequent')],
+    ThrowStatement: [node('argument')],
+    TryStatement: [node('block'), node('handler'), node('finalizer')],
+    CatchClause: [node('param'), node('body')],
+    WhileStatement: [node('test'), node('body')],
+    DoWhileStatement: [node('test'), node('body')],
+    ForStatement: [node('init'), node('test'), node('update'), node('body')],
+    ForInStatement: [node('left'), node('right'), node('body')],
+    ForOfStatement: [node('left'), node('right'), node('body'), bool('await')],
+    Super: [],
+    Import: [],
+    ThisExpression: [],
+    ArrowFunctionExpression: [...functionFields, bool('expression')],
+    YieldExpression: [node('argument'), bool('delegate')],
+    AwaitExpression: [node('argument')],
+    ArrayExpression: [nodes('elements')],
+    ObjectExpression: [nodes('properties')],
+    ConditionalExpression: [node('test'), node('alternate'), node('consequent')],
+    FunctionExpression: functionFields,
+    UnaryExpression: [node('argument'), enumOf('operator', unaryOperators), bool('prefix')],
+    UpdateExpression: [node('argument'), enumOf('operator', updateOperators), bool('prefix')],
+    BinaryExpression: [node('left'), node('right'), enumOf('operator', binaryOperators)],
+    AssignmentExpression: [node('left'), node('right'), enumOf('operator', assignmentOperators)],
+    LogicalExpression: [node('left'), node('right'), enumOf('operator', logicalOperators)],
+    MemberExpression: [node('object'), node('property'), bool('computed')],
+    BindExpression: [node('object'), node('callee')],
+    CallExpression: [node('callee'), nodes('arguments')],
+    NewExpression: [node('callee'), nodes('arguments')],
+    SequenceExpression: [nodes('expressions')],
+    DoExpression: [node('body')],
+    ClassExpression: classFields,
+    ClassBody: [nodes('body')],
+    ClassMethod: [node('id'), nodes('params'), node('body'), node('key'), node('typeParameters'), node('returnType'),
+                  enumOf('kind', methodKinds), bool('generator'), bool('async'), bool('computed'), bool('static')],
+    ClassPrivateMethod: [node('id'), nodes('params'), node('body'), node('key'), node('typeParameters'), node('returnType'),
+                         enumOf('kind', privateMethodKinds), bool('generator'), bool('async'), bool('static')],
+    ClassProperty: [node('key'), node('value'), node('typeAnnotation'), bool('static'), bool('computed')],
+    ClassPrivateProperty: [node('key'), node('value'), node('typeAnnotation'), bool('static')],
+    ClassDeclaration: classFields,
+    VariableDeclaration: [nodes('declarations'), enumOf('kind', variableKinds)],
+    FunctionDeclaration: functionFields,
+    VariableDeclarator: [node('id'), node('init')],
+    SpreadElement: [node('argument')],
+    ObjectPattern: [nodes('properties'), node('typeAnnotation')],
+    ArrayPattern: [nodes('elements')],
+    AssignmentPattern: [node('left'), node('right')],
+    RestElement: [node('argument'), node('typeAnnotation')],
+    MetaProperty: [node('meta'), node('property')],
+    ImportDeclaration: [nodes('specifiers'), node('source'), enumOf('importKind', importKinds)],
+    ImportSpecifier: [node('local'), node('imported'), (w, n) => w.u8(n.importKind === 'type' ? 1 : 0)],
+    ImportDefaultSpecifier: [node('local')],
+    ImportNamespaceSpecifier: [node('local')],
+    ExportNamedDeclaration: [node('declaration'), node('source'), nodes('specifiers'), enumOf('exportKind', exportKinds)],
+    ExportDefaultDeclaration: [node('declaration')],
+    ExportAllDeclaration: [node('source')],
+    ExportSpecifier: [node('local'), node('exported')],
+    ExportDefaultSpecifier: [node('exported')],
+    TypeAnnotation: [node('typeAnnotation')],
+    GenericTypeAnnotation: [node('id'), node('typeParameters')],
+    TypeParameterInstantiation: [nodes('params')],
+    TypeParameterDeclaration: [nodes('params')],
+    TypeParameter: [string('name'), node('bound')],
+    StringTypeAnnotation: [],
+    NumberTypeAnnotation: [],
+    BooleanTypeAnnotation: [],
+    VoidTypeAnnotation: [],
+    AnyTypeAnnotation: [],
+    ExistsTypeAnnotation: [],
+    MixedTypeAnnotation: [],
+    NullableTypeAnnotation: [node('typeAnnotation')],
+    ArrayTypeAnnotation: [node('elementType')],
+    TupleTypeAnnotation: [nodes('types')],
+    UnionTypeAnnotation: [nodes('types')],
+    IntersectionTypeAnnotation: [nodes('types')],
+    TypeofTypeAnnotation: [node('argument')],
+    NullLiteralTypeAnnotation: [],
+    NumberLiteralTypeAnnotation: [number('value')],
+    StringLiteralTypeAnnotation: [string('value')],
+    BooleanLiteralTypeAnnotation: [bool('value')],
+    FunctionTypeAnnotation: [nodes('params'), node('rest'), node('returnType')],
+    FunctionTypeParam: [node('name'), node('typeAnnotation')],
+    ObjectTypeAnnotation: [nodes('properties'), nodes('indexers'), bool('exact')],
+    ObjectTypeProperty: [node('key'), node('value'), bool('optional')],
+    ObjectTypeIndexer: [node('id'), node('key'), node('value')],
+    ObjectTypeSpreadProperty: [node('argument')],
+    TypeAlias: [node('id'), node('typeParameters'), node('right')],
+    TypeCastExpression: [node('expression'), node('typeAnnotation')],
+    ClassImplements: [node('id'), node('typeParameters')],
+    QualifiedTypeIdentifier: [node('qualification'), node('id')],
+    InterfaceDeclaration: interfaceFields,
+    InterfaceExtends: [node('id'), node('typeParameters')],
+    DeclareVariable: [node('id')],
+    DeclareFunction: [node('id')],
+    DeclareTypeAlias: [node('id'), node('right')],
+    DeclareClass: interfaceFields,
+    DeclareModule: [node('id'), node('body')],
+    DeclareExportDeclaration: [node('declaration')],
+};
+
+// UTF-8 byte offset of each UTF-16 index of the source (lone surrogates are encoded as U+FFFD)
+function utf8ByteOffsets(source) {
+    const offsets = new Uint32Array(source.length + 1);
+    let bytes = 0;
+    for (let i = 0; i < source.length; ++i) {
+        offsets[i] = bytes;
+        const c = source.charCodeAt(i);
+        if (c < 0x80) {
+            bytes += 1;
+        } else if (c < 0x800) {
+            bytes += 2;
+        } else if (c >= 0xD800 && c < 0xDC00 && i + 1 < source.length
+                   && source.charCodeAt(i + 1) >= 0xDC00 && source.charCodeAt(i + 1) < 0xE000) {
+            offsets[++i] = bytes;
+            bytes += 4;
+        } else {
+            bytes += 3;
+        }
+    }
+    offsets[source.length] = bytes;
+    return offsets;
+}
+
+class AstWriter extends Writer {
+    constructor(sizeHint, nodeTypes, source) {
+        super(sizeHint);
+        this.byteOffsets = utf8ByteOffsets(source);
+        // Tags are the AstNodeType values, which start with Root
+        this.tags = new Map(nodeTypes.map((type, index) => [type, index + 1]));
+    }
+
+    node(n) {
+        if (n === null || n === undefined) {
+            this.u8(nullNodeTag);
+            return;
+        }
+        const tag = this.tags.get(n.type);
+        const schema = schemas[n.type];
+        if (tag === undefined || schema === undefined)
+            throw new Error('Unknown node of type ' + n.type + ' in Babylon AST');
+        this.u8(tag);
+        this.span(n);
+        for (const field of schema)
+            field(this, n);
+    }
+
+    nodes(list) {
+        if (!list) {
+            this.u32(0);
+            return;
+        }
+        this.u32(list.length);
+        for (const n of list)
+            this.node(n);
+    }
+}
+
+// nodeTypes lists the AstNodeType names after Root, in order
+function parseToBuffer(source, options, nodeTypes, formatVersion, keepComments) {
+    const ast = parser.parse(source, options);
+    const w = new AstWriter(source.length * 4 + 64, nodeTypes, source);
+    w.u32(astFormatMagic);
+    w.u32(formatVersion);
+    w.span(ast.program);
+    w.nodes(ast.program.body);
+    w.nodes(keepComments ? ast.comments : null);
+    return w.bytes.subarray(0, w.pos);
+}
+
+module.exports = {
+    parse: parser.parse,
+    parseToBuffer,
+};
@@ -8,7 +8,7 @@
 #include <algorithm>
 #include <vector>
 
-BasicBlock::BasicBlock(Graph &graph, uint16_t selfIndex, const LexicalBindings &scope, bool shouldHoist, std::vector<uint16_t> prevs)
+BasicBlock::BasicBlock(Graph &graph, BasicBlockIndex selfIndex, const LexicalBindings &scope, bool shouldHoist, std::vector<BasicBlockIndex> prevs)
     : prevs{prevs}, scope{scope}, graph{graph}, selfIndex{selfIndex}, next{0}, newest{0}, sealed{false}, filled{false}
 {
     // Hoist bindings in the graph
@@ -23,7 +23,7 @@ BasicBlock::BasicBlock(Graph &graph, uint16_t selfIndex, const LexicalBindings &
 
         // Functions and classes are special, they get initialized during hoisting
         AstNode* decl = declId->getParent();
-        uint16_t value;
+        GraphNodeIndex value;
         if (isFunctionNode(*decl) && ((Function*)decl)->getId() == declId)
             value = addNode({GraphNodeType::Function, decl}, false);
         else if (decl->getType() == AstNodeType::ClassDeclaration && ((ClassDeclaration*)decl)->getId() == declId)
@@ -34,22 +34,30 @@ BasicBlock::BasicBlock(Graph &graph, uint16_t selfIndex, const LexicalBindings &
     }
 }
 
-uint16_t BasicBlock::getSelfId()
+size_t BasicBlock::memoryUsage() const
+{
+    return sizeof(BasicBlock)
+            + values.size() * (sizeof(decltype(values)::value_type) + 2 * sizeof(void*)) + values.bucket_count() * sizeof(void*)
+            + prevs.capacity() * sizeof(BasicBlockIndex)
+            + incompletePhis.capacity() * sizeof(decltype(incompletePhis)::value_type);
+}
+
+BasicBlockIndex BasicBlock::getSelfId()
 {
     return selfIndex;
 }
 
-const std::vector<uint16_t>& BasicBlock::getPrevs()
+const std::vector<BasicBlockIndex>& BasicBlock::getPrevs()
 {
     return prevs;
 }
 
-uint16_t BasicBlock::getNext()
+GraphNodeIndex BasicBlock::getNext()
 {
     return next;
 }
 
-uint16_t BasicBlock::getNewest()
+GraphNodeIndex BasicBlock::getNewest()
 {
     return newest;
 }
@@ -57,15 +65,15 @@ uint16_t BasicBlock::getNewest()
 #include "ast/ast.hpp"
 #include "utils/reporting.hpp"
 
-uint16_t BasicBlock::readNonlocalVariable(Identifier &declIdentifier)
+GraphNodeIndex BasicBlock::readNonlocalVariable(Identifier &declIdentifier)
 {
-    if (uint16_t* existingVar = readVariable(&declIdentifier))
+    if (GraphNodeIndex* existingVar = readVariable(&declIdentifier))
         return *existingVar;
 
     // NOTE: This assert is overzealous, undeclared variables can trigger it (bug so will our bugs!)
     //assert(getPrevs().size());
 
-    uint16_t result;
+    GraphNodeIndex result;
     if (!isSealed()) {
         result = addIncompletePhi(declIdentifier);
     } else if (prevs.size() == 1) {
@@ -78,15 +86,15 @@ uint16_t BasicBlock::readNonlocalVariable(Identifier &declIdentifier)
 }
 
 
-uint16_t BasicBlock::completeSimplePhi(Identifier &declIdentifier)
+GraphNodeIndex BasicBlock::completeSimplePhi(Identifier &declIdentifier)
 {
     bool trivial = true;
     writeVariable(&declIdentifier, 0); // Set placeholder to break loops
-    std::vector<uint16_t> inputs;
+    std::vector<GraphNodeIndex> inputs;
     for (auto prevId : prevs) {
         BasicBlock& prevBlock = graph.getBasicBlock(prevId);
-        uint16_t newInput;
-        if (uint16_t* existingVar = prevBlock.readVariable(&declIdentifier)) {
+        GraphNodeIndex newInput;
+        if (GraphNodeIndex* existingVar = prevBlock.readVariable(&declIdentifier)) {
             newInput = *existingVar;
         } else {
             newInput = prevBlock.readNonlocalVariable(declIdentifier);
@@ -111,11 +119,11 @@ void BasicBlock::seal()
 
     for (const auto& incomplete : incompletePhis) {
         Identifier* identifierDecl = incomplete.first;
-        uint16_t phi = incomplete.second;
+        GraphNodeIndex phi = incomplete.second;
         assert(graph.getNode(phi).getType() == GraphNodeType::Phi);
 
         for (auto prev : prevs) {
-            uint16_t op = graph.getBasicBlock(prev).readNonlocalVariable(*identifierDecl);
+            GraphNodeIndex op = graph.getBasicBlock(prev).readNonlocalVariable(*identifierDecl);
             auto& phiNode = graph.getNode(phi);
             phiNode.addInput(op); // If we can't remove the phi entirely, we need to keep every input (or it breaks wrt merges)
         }
@@ -143,14 +151,14 @@ bool BasicBlock::isFilled()
     return filled;
 }
 
-void BasicBlock::addPrevBlock(uint16_t prev)
+void BasicBlock::addPrevBlock(BasicBlockIndex prev)
 {
     assert(!isSealed());
     assert(std::find(prevs.begin(), prevs.end(), prev) == prevs.end());
     prevs.push_back(prev);
 }
 
-uint16_t BasicBlock::addNode(GraphNode &&node, bool control)
+GraphNodeIndex BasicBlock::addNode(GraphNode &&node, bool control)
 {
     assert(!isFilled());
 
@@ -160,7 +168,7 @@ uint16_t BasicBlock::addNode(GraphNode &&node, bool control)
     return newest;
 }
 
-uint16_t BasicBlock::addNode(GraphNode &&node, uint16_t prev, bool control)
+GraphNodeIndex BasicBlock::addNode(GraphNode &&node, GraphNodeIndex prev, bool control)
 {
     assert(!isFilled());
 
@@ -170,7 +178,7 @@ uint16_t BasicBlock::addNode(GraphNode &&node, uint16_t prev, bool control)
     return newest;
 }
 
-uint16_t BasicBlock::addNode(GraphNode &&node, std::vector<uint16_t> &prevs, bool control)
+GraphNodeIndex BasicBlock::addNode(GraphNode &&node, std::vector<GraphNodeIndex> &prevs, bool control)
 {
     assert(!isFilled());
 
@@ -180,7 +188,7 @@ uint16_t BasicBlock::addNode(GraphNode &&node, std::vector<uint16_t> &prevs, boo
     return newest;
 }
 
-uint16_t BasicBlock::addPhi(std::vector<uint16_t>&& inputs)
+GraphNodeIndex BasicBlock::addPhi(std::vector<GraphNodeIndex>&& inputs)
 {
     assert(prevs.size() > 0);
     BasicBlock* prevBlock = &graph.getBasicBlock(prevs[0]);
@@ -189,10 +197,10 @@ uint16_t BasicBlock::addPhi(std::vector<uint16_t>&& inputs)
         assert(prevBlock->getPrevs().size() == 1);
         prevBlock = &graph.getBasicBlock(prevBlock->getPrevs()[0]);
     }
-    uint16_t merge = graph.getNode(prevBlock->getNext()).getNext(0);
+    GraphNodeIndex merge = graph.getNode(prevBlock->getNext()).getNext(0);
     assert(graph.getNode(merge).getType() == GraphNodeType::Merge);
 
-    uint16_t insertPoint = merge;
+    GraphNodeIndex insertPoint = merge;
     while (graph.getNode(insertPoint).nextCount() == 1) {
         auto nextId = graph.getNode(insertPoint).getNext(0);
         auto& next = graph.getNode(nextId);
@@ -202,13 +210,13 @@ uint16_t BasicBlock::addPhi(std::vector<uint16_t>&& inputs)
             break;
     }
 
-    uint16_t phi = graph.addNode({GraphNodeType::Phi, move(inputs)});
+    GraphNodeIndex phi = graph.addNode({GraphNodeType::Phi, move(inputs)});
     auto& prevNode = graph.getNode(insertPoint);
     auto& phiNode = graph.getNode(phi);
     phiNode.addPrev(insertPoint);
     if (prevNode.nextCount()) {
         assert(prevNode.nextCount() == 1);
-        uint16_t prevNext = prevNode.getNext(0);
+        GraphNodeIndex prevNext = prevNode.getNext(0);
         phiNode.addNext(prevNext);
         graph.getNode(prevNext).replacePrev(insertPoint, phi);
         prevNode.setNext(0, phi);
@@ -220,7 +228,7 @@ uint16_t BasicBlock::addPhi(std::vector<uint16_t>&& inputs)
     // If there's an empty block right after this one, it shares our next, so we need to update it too
     if (insertPoint == next) {
         next = newest = phi;
-        for (uint16_t blockIndex = selfIndex+1; blockIndex < graph.blockCount(); ++blockIndex) {
+        for (BasicBlockIndex blockIndex = selfIndex+1; blockIndex < graph.blockCount(); ++blockIndex) {
             auto& block = graph.getBasicBlock(blockIndex);
             if (block.next == insertPoint) {
                 assert(block.prevs.size() == 1 && block.prevs[0] == selfIndex); // Empty blocks should only ever have us as prev
@@ -231,9 +239,9 @@ uint16_t BasicBlock::addPhi(std::vector<uint16_t>&& inputs)
     return phi;
 }
 
-uint16_t BasicBlock::addIncompletePhi(Identifier& id)
+GraphNodeIndex BasicBlock::addIncompletePhi(Identifier& id)
 {
-    uint16_t phi = addPhi({});
+    GraphNodeIndex phi = addPhi({});
     incompletePhis.push_back({&id, phi});
     return phi;
 }
@@ -243,22 +251,22 @@ const LexicalBindings &BasicBlock::getScope() const
     return scope;
 }
 
-void BasicBlock::setNewest(uint16_t oldNode)
+void BasicBlock::setNewest(GraphNodeIndex oldNode)
 {
     newest = oldNode;
 }
 
-void BasicBlock::setNext(uint16_t oldNode)
+void BasicBlock::setNext(GraphNodeIndex oldNode)
 {
     next = oldNode;
 }
 
-void BasicBlock::writeVariable(Identifier *declarationIdentifier, uint16_t valueNode)
+void BasicBlock::writeVariable(Identifier *declarationIdentifier, GraphNodeIndex valueNode)
 {
     values[declarationIdentifier] = valueNode;
 }
 
-uint16_t* BasicBlock::readVariable(Identifier *declarationIdentifier)
+GraphNodeIndex* BasicBlock::readVariable(Identifier *declarationIdentifier)
 {
     auto it = values.find(declarationIdentifier);
     if (it == values.end())
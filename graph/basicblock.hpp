@@ -4,6 +4,7 @@
 #include <cstdint>
 #include <vector>
 #include <unordered_map>
+#include "graph/type.hpp"
 
 class Graph;
 class GraphNode;
@@ -15,50 +16,52 @@ struct LexicalBindings;
 class BasicBlock
 {
 public:
-    BasicBlock(Graph& graph, uint16_t selfIndex, const LexicalBindings& scope, bool shouldHoist, std::vector<uint16_t> prevs = {});
+    BasicBlock(Graph& graph, BasicBlockIndex selfIndex, const LexicalBindings& scope, bool shouldHoist, std::vector<BasicBlockIndex> prevs = {});
 
-    const std::vector<uint16_t> &getPrevs();
-    uint16_t getSelfId();
-    uint16_t getNext();
-    uint16_t getNewest();
+    const std::vector<BasicBlockIndex> &getPrevs();
+    BasicBlockIndex getSelfId();
+    GraphNodeIndex getNext();
+    GraphNodeIndex getNewest();
 
     void seal();
     bool isSealed();
     void setFilled();
     bool isFilled();
 
-    void addPrevBlock(uint16_t prev);
-    uint16_t addNode(GraphNode&& node, bool control = false);
-    uint16_t addNode(GraphNode&& node, uint16_t prev, bool control = true);
-    uint16_t addNode(GraphNode&& node, std::vector<uint16_t> &prevs, bool control = true);
-    uint16_t addPhi(std::vector<uint16_t>&& inputs);
-    uint16_t addIncompletePhi(Identifier &id);
+    void addPrevBlock(BasicBlockIndex prev);
+    GraphNodeIndex addNode(GraphNode&& node, bool control = false);
+    GraphNodeIndex addNode(GraphNode&& node, GraphNodeIndex prev, bool control = true);
+    GraphNodeIndex addNode(GraphNode&& node, std::vector<GraphNodeIndex> &prevs, bool control = true);
+    GraphNodeIndex addPhi(std::vector<GraphNodeIndex>&& inputs);
+    GraphNodeIndex addIncompletePhi(Identifier &id);
 
     const LexicalBindings& getScope() const;
 
     // Instead of adding a duplicate of a node that already exists, users may reuse an existing node and set it as newest
-    void setNewest(uint16_t oldNode);
+    void setNewest(GraphNodeIndex oldNode);
     // When a new basic block is created, it may be necessary to manually set which old node of a previous block should next nodes be added to
-    void setNext(uint16_t oldNode);
+    void setNext(GraphNodeIndex oldNode);
 
     // declarationIdentifier must be the identifier of the original declaration. A valueNode of 0 means undefined
-    void writeVariable(Identifier* declarationIdentifier, uint16_t valueNode);
+    void writeVariable(Identifier* declarationIdentifier, GraphNodeIndex valueNode);
     // declarationIdentifier must be the identifier of the original declaration. Returns nullptr if the variable doesn't exist.
-    uint16_t *readVariable(Identifier* declarationIdentifier);
+    GraphNodeIndex *readVariable(Identifier* declarationIdentifier);
 
-    uint16_t readNonlocalVariable(Identifier& declIdentifier);
-    uint16_t completeSimplePhi(Identifier& declIdentifier);
+    GraphNodeIndex readNonlocalVariable(Identifier& declIdentifier);
+    GraphNodeIndex completeSimplePhi(Identifier& declIdentifier);
+
+    size_t memoryUsage() const; //< Approximate bytes used by the block and its variables
 
 private:
-    std::unordered_map<Identifier*, uint16_t> values;
-    std::vector<uint16_t> prevs; // Index of the previous basic blocks
-    std::vector<std::pair<Identifier*, uint16_t>> incompletePhis; // Indentifiers that had a phi inserted while the block wasn't sealed
+    std::unordered_map<Identifier*, GraphNodeIndex> values;
+    std::vector<BasicBlockIndex> prevs; // Index of the previous basic blocks
+    std::vector<std::pair<Identifier*, GraphNodeIndex>> incompletePhis; // Indentifiers that had a phi inserted while the block wasn't sealed
     const LexicalBindings& scope;
 
     Graph& graph;
-    uint16_t selfIndex; // Index of the basic block in the graph's list
-    uint16_t next; // Last control node added to the block, new control nodes will have this as prev
-    uint16_t newest; // Latest node added through the block, different from next for non-control node
+    BasicBlockIndex selfIndex; // Index of the basic block in the graph's list
+    GraphNodeIndex next; // Last control node added to the block, new control nodes will have this as prev
+    GraphNodeIndex newest; // Latest node added through the block, different from next for non-control node
 
     bool sealed;
     bool filled;
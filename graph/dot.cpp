@@ -227,7 +227,7 @@ std::string makeLabel(const GraphNode& node)
     return base;
 }
 
-std::string makePrevLabel(GraphNodeType type, uint16_t j)
+std::string makePrevLabel(GraphNodeType type, size_t j)
 {
     if (type == GraphNodeType::Merge) {
         return "phi"+to_string(j);
@@ -236,7 +236,7 @@ std::string makePrevLabel(GraphNodeType type, uint16_t j)
     return {};
 }
 
-std::string makeInputLabel(GraphNodeType type, uint16_t j)
+std::string makeInputLabel(GraphNodeType type, size_t j)
 {
     if (type == GraphNodeType::StoreProperty) {
         if (j == 0)
@@ -290,18 +290,18 @@ std::string graphToDOT(const Graph& graph)
     text += "digraph ControlGraph {\n{ rank=source; 0; };\n";
 
     std::vector<bool> nodesUsed(graph.size());
-    for (uint16_t i = 0; i < graph.size(); ++i)
-        for (uint16_t input = 0; input < graph.getNode(i).inputCount(); ++input)
+    for (GraphNodeIndex i = 0; i < graph.size(); ++i)
+        for (size_t input = 0; input < graph.getNode(i).inputCount(); ++input)
             nodesUsed[graph.getNode(i).getInput(input)] = true;
 
-    for (uint16_t i = 0; i < graph.size(); ++i) {
+    for (GraphNodeIndex i = 0; i < graph.size(); ++i) {
         const GraphNode& node = graph.getNode(i);
         if (!node.prevCount() && !node.nextCount() && !nodesUsed[i])
             continue;
         text += to_string(i) + " [label=\"" + makeLabel(node) + "\"];\n";
-        for (uint16_t j = 0; j < node.prevCount(); ++j)
+        for (size_t j = 0; j < node.prevCount(); ++j)
             text += to_string(node.getPrev(j)) + " -> " + to_string(i) + " [color=red style=bold label=\""+makePrevLabel(node.getType(), j)+"\"];\n";
-        for (uint16_t j = 0; j < node.inputCount(); ++j)
+        for (size_t j = 0; j < node.inputCount(); ++j)
             text += to_string(node.getInput(j)) + " -> " + to_string(i) + " [color=blue label=\""+makeInputLabel(node.getType(), j)+"\"];\n";
     }
 
@@ -3,6 +3,8 @@
 #include <utility>
 #include <stdexcept>
 #include <cassert>
+#include <cstring>
+#include <limits>
 
 Graph::Graph(Function &fun, const LexicalBindings &scope)
     : fun{fun}
@@ -17,47 +19,64 @@ Function &Graph::getFun() const
     return fun;
 }
 
-uint16_t Graph::size() const
+GraphNodeIndex Graph::size() const
 {
-    return static_cast<uint16_t>(nodes.size());
+    return static_cast<GraphNodeIndex>(nodes.size());
 }
 
-const GraphNode &Graph::getNode(uint16_t n) const
+const GraphNode &Graph::getNode(GraphNodeIndex n) const
 {
     return nodes[n];
 }
 
-GraphNode &Graph::getNode(uint16_t n)
+GraphNode &Graph::getNode(GraphNodeIndex n)
 {
     return nodes[n];
 }
 
-uint16_t Graph::getUndefinedNode()
+GraphNodeIndex Graph::indexOf(const GraphNode &node) const
+{
+    assert(&node >= nodes.data() && &node < nodes.data() + nodes.size());
+    return static_cast<GraphNodeIndex>(&node - nodes.data());
+}
+
+GraphNodeIndex Graph::getUndefinedNode()
 {
     return 1; // We hardcode node 1 as the Undefined literal node.
 }
 
-uint16_t Graph::addNode(GraphNode &&node)
+// Graph nodes and blocks are referenced by index, running out of indices would silently link the wrong nodes
+static void checkIndexAvailable(size_t count, const char* what)
+{
+    if (count >= std::numeric_limits<GraphNodeIndex>::max())
+        throw GraphTooLargeError(std::string("Function too large to analyze, it has more than ")
+                                 +std::to_string(std::numeric_limits<GraphNodeIndex>::max())+" graph "+what);
+}
+
+GraphNodeIndex Graph::addNode(GraphNode &&node)
 {
-    uint16_t newIndex = (uint16_t)nodes.size();
+    checkIndexAvailable(nodes.size(), "nodes");
+    GraphNodeIndex newIndex = (GraphNodeIndex)nodes.size();
     nodes.emplace_back(std::move(node));
     return newIndex;
 }
 
-uint16_t Graph::addNode(GraphNode &&node, uint16_t prev)
+GraphNodeIndex Graph::addNode(GraphNode &&node, GraphNodeIndex prev)
 {
     assert(prev != 0 || !nodes[0].nextCount());
+    checkIndexAvailable(nodes.size(), "nodes");
 
-    uint16_t newIndex = (uint16_t)nodes.size();
+    GraphNodeIndex newIndex = (GraphNodeIndex)nodes.size();
     node.addPrev(prev);
     nodes.emplace_back(std::move(node));
     nodes[prev].addNext(newIndex);
     return newIndex;
 }
 
-uint16_t Graph::addNode(GraphNode &&node, const std::vector<uint16_t>& prevs)
+GraphNodeIndex Graph::addNode(GraphNode &&node, const std::vector<GraphNodeIndex>& prevs)
 {
-    uint16_t newIndex = (uint16_t)nodes.size();
+    checkIndexAvailable(nodes.size(), "nodes");
+    GraphNodeIndex newIndex = (GraphNodeIndex)nodes.size();
     for (const auto& prev : prevs) {
         node.addPrev(prev);
         nodes[prev].addNext(newIndex);
@@ -66,41 +85,212 @@ uint16_t Graph::addNode(GraphNode &&node, const std::vector<uint16_t>& prevs)
     return newIndex;
 }
 
-uint16_t Graph::blockCount() const
+BasicBlockIndex Graph::blockCount() const
 {
-    return static_cast<uint16_t>(blocks.size());
+    return static_cast<BasicBlockIndex>(blocks.size());
 }
 
-const BasicBlock &Graph::getBasicBlock(uint16_t n) const
+const BasicBlock &Graph::getBasicBlock(BasicBlockIndex n) const
 {
     return *blocks[n];
 }
 
-BasicBlock &Graph::getBasicBlock(uint16_t n)
+BasicBlock &Graph::getBasicBlock(BasicBlockIndex n)
 {
     return *blocks[n];
 }
 
-BasicBlock& Graph::addBasicBlock(std::vector<uint16_t> prevs, const LexicalBindings& scope, bool shouldHoist)
+BasicBlock& Graph::addBasicBlock(std::vector<BasicBlockIndex> prevs, const LexicalBindings& scope, bool shouldHoist)
 {
-    uint16_t newIndex = (uint16_t)blocks.size();
+    checkIndexAvailable(blocks.size(), "basic blocks");
+    BasicBlockIndex newIndex = (BasicBlockIndex)blocks.size();
     return *blocks.emplace_back(std::make_unique<BasicBlock>(*this, newIndex, scope, shouldHoist, move(prevs)));
 }
 
+size_t Graph::memoryUsage() const
+{
+    size_t usage = sizeof(Graph) + nodes.capacity() * sizeof(GraphNode) + blocks.capacity() * sizeof(blocks[0]);
+    for (const GraphNode& node : nodes)
+        usage += node.heapMemoryUsage();
+    for (const auto& block : blocks)
+        usage += block->memoryUsage();
+    std::lock_guard lock(nodeTypesMutex);
+    usage += nodeTypes.memoryUsage();
+    return usage;
+}
+
+void Graph::allocateNodeTypes()
+{
+    std::lock_guard lock(nodeTypesMutex);
+    nodeTypes.resize(size());
+}
+
+std::optional<TypeInfo> Graph::findNodeType(GraphNodeIndex n) const
+{
+    std::lock_guard lock(nodeTypesMutex);
+    if (const TypeInfo* type = nodeTypes.find(n))
+        return *type;
+    return {};
+}
+
+TypeInfo Graph::setNodeType(GraphNodeIndex n, TypeInfo type)
+{
+    std::lock_guard lock(nodeTypesMutex);
+    if (const TypeInfo* knownType = nodeTypes.find(n))
+        return *knownType;
+    return nodeTypes.set(n, std::move(type));
+}
+
 GraphNode::GraphNode(GraphNodeType type, AstNode* astReference)
     : astReference{astReference}, type{type}
 {
 }
 
-GraphNode::GraphNode(GraphNodeType type, uint16_t input, AstNode *astReference)
+GraphNode::GraphNode(GraphNodeType type, GraphNodeIndex input, AstNode *astReference)
+    : astReference{astReference}, type{type}
+{
+    addInput(input);
+}
+
+GraphNode::GraphNode(GraphNodeType type, std::vector<GraphNodeIndex>&& inputs, AstNode* astReference)
     : astReference{astReference}, type{type}
 {
-   inputs.push_back(input);
+    for (GraphNodeIndex input : inputs)
+        addInput(input);
+}
+
+GraphNode::GraphNode(GraphNode&& other)
+    : astReference{other.astReference}
+    , narrowCapacity{other.narrowCapacity}
+    , type{other.type}
+    , edgesOnHeap{other.edgesOnHeap}
+    , wideEdges{other.wideEdges}
+{
+    memcpy(narrowCounts, other.narrowCounts, sizeof(narrowCounts));
+    if (wideEdges)
+        wideHeapEdges = other.wideHeapEdges;
+    else if (edgesOnHeap)
+        narrowHeapEdges = other.narrowHeapEdges;
+    else
+        memcpy(inlineEdges, other.inlineEdges, sizeof(inlineEdges));
+    memset(other.narrowCounts, 0, sizeof(other.narrowCounts));
+    other.narrowCapacity = inlineEdgesCapacity;
+    other.edgesOnHeap = other.wideEdges = false;
+}
+
+GraphNode::~GraphNode()
+{
+    if (wideEdges)
+        delete[] wideHeapEdges;
+    else if (edgesOnHeap)
+        delete[] narrowHeapEdges;
+}
+
+size_t GraphNode::sectionCount(EdgeSection section) const
+{
+    return wideEdges ? wideHeapEdges[section] : narrowCounts[section];
 }
 
-GraphNode::GraphNode(GraphNodeType type, std::vector<uint16_t>&& inputs, AstNode* astReference)
-    : inputs{std::move(inputs)}, astReference{astReference}, type{type}
+size_t GraphNode::sectionStart(EdgeSection section) const
 {
+    size_t start = 0;
+    for (uint8_t i = 0; i < section; ++i)
+        start += sectionCount((EdgeSection)i);
+    return start;
+}
+
+size_t GraphNode::edgeCount() const
+{
+    return sectionStart(Nexts) + sectionCount(Nexts);
+}
+
+size_t GraphNode::edgeCapacity() const
+{
+    return wideEdges ? wideHeapEdges[3] : narrowCapacity;
+}
+
+GraphNodeIndex GraphNode::getEdge(size_t position) const
+{
+    if (wideEdges)
+        return wideHeapEdges[wideHeaderSize + position];
+    return edgesOnHeap ? narrowHeapEdges[position] : inlineEdges[position];
+}
+
+void GraphNode::setEdge(size_t position, GraphNodeIndex value)
+{
+    if (!wideEdges && value > std::numeric_limits<uint16_t>::max())
+        reallocateEdges(edgeCapacity(), true);
+
+    if (wideEdges)
+        wideHeapEdges[wideHeaderSize + position] = value;
+    else if (edgesOnHeap)
+        narrowHeapEdges[position] = (uint16_t)value;
+    else
+        inlineEdges[position] = (uint16_t)value;
+}
+
+void GraphNode::reallocateEdges(size_t newCapacity, bool wide)
+{
+    size_t count = edgeCount();
+    uint16_t* oldNarrowHeapEdges = edgesOnHeap && !wideEdges ? narrowHeapEdges : nullptr;
+    uint32_t* oldWideHeapEdges = wideEdges ? wideHeapEdges : nullptr;
+    if (wide) {
+        auto newEdges = new uint32_t[wideHeaderSize + newCapacity];
+        for (uint8_t i = 0; i < 3; ++i)
+            newEdges[i] = (uint32_t)sectionCount((EdgeSection)i);
+        newEdges[3] = (uint32_t)newCapacity;
+        for (size_t i = 0; i < count; ++i)
+            newEdges[wideHeaderSize + i] = getEdge(i);
+        wideHeapEdges = newEdges;
+    } else {
+        assert(!wideEdges && newCapacity <= std::numeric_limits<uint16_t>::max());
+        auto newEdges = new uint16_t[newCapacity];
+        memcpy(newEdges, edgesOnHeap ? narrowHeapEdges : inlineEdges, count * sizeof(uint16_t));
+        narrowHeapEdges = newEdges;
+        narrowCapacity = (uint16_t)newCapacity;
+    }
+    delete[] oldNarrowHeapEdges;
+    delete[] oldWideHeapEdges;
+    edgesOnHeap = true;
+    wideEdges = wide;
+}
+
+void GraphNode::addEdge(EdgeSection section, GraphNodeIndex value)
+{
+    insertEdge(sectionStart(section) + sectionCount(section), value);
+    if (wideEdges)
+        wideHeapEdges[section]++;
+    else
+        narrowCounts[section]++;
+}
+
+void GraphNode::insertEdge(size_t position, GraphNodeIndex value)
+{
+    size_t count = edgeCount();
+    size_t capacity = edgeCapacity();
+    // 16-bit counts can't go past 65535 edges in any section, so we also widen before the whole array gets there
+    bool needsWidening = !wideEdges && (value > std::numeric_limits<uint16_t>::max() || count == std::numeric_limits<uint16_t>::max());
+    if (count == capacity || needsWidening) {
+        size_t newCapacity = capacity;
+        if (count == capacity) {
+            if (capacity >= std::numeric_limits<uint32_t>::max() / 2 - wideHeaderSize)
+                throw GraphTooLargeError("Function too large to analyze, one of its graph nodes has too many edges");
+            newCapacity = capacity * 2;
+            if (!wideEdges && !needsWidening)
+                newCapacity = std::min<size_t>(newCapacity, std::numeric_limits<uint16_t>::max());
+        }
+        reallocateEdges(newCapacity, wideEdges || needsWidening);
+    }
+
+    if (wideEdges) {
+        uint32_t* edges = wideHeapEdges + wideHeaderSize;
+        memmove(edges + position + 1, edges + position, (count - position) * sizeof(uint32_t));
+    } else if (edgesOnHeap) {
+        memmove(narrowHeapEdges + position + 1, narrowHeapEdges + position, (count - position) * sizeof(uint16_t));
+    } else {
+        memmove(inlineEdges + position + 1, inlineEdges + position, (count - position) * sizeof(uint16_t));
+    }
+    setEdge(position, value);
 }
 
 const char* GraphNode::getTypeName() const {
@@ -127,66 +317,80 @@ GraphNodeType GraphNode::getType() const
 
 size_t GraphNode::inputCount() const
 {
-    return inputs.size();
+    return sectionCount(Inputs);
 }
 
 size_t GraphNode::prevCount() const
 {
-    return prevs.size();
+    return sectionCount(Prevs);
 }
 
 size_t GraphNode::nextCount() const
 {
-    return nexts.size();
+    return sectionCount(Nexts);
 }
 
-uint16_t GraphNode::getInput(uint16_t n) const
+GraphNodeIndex GraphNode::getInput(size_t n) const
 {
-    return inputs[n];
+    assert(n < inputCount());
+    return getEdge(n);
 }
 
-uint16_t GraphNode::getPrev(uint16_t n) const
+GraphNodeIndex GraphNode::getPrev(size_t n) const
 {
-    return prevs[n];
+    assert(n < prevCount());
+    return getEdge(sectionStart(Prevs) + n);
 }
 
-uint16_t GraphNode::getNext(uint16_t n) const
+GraphNodeIndex GraphNode::getNext(size_t n) const
 {
-    return nexts[n];
+    assert(n < nextCount());
+    return getEdge(sectionStart(Nexts) + n);
 }
 
-void GraphNode::addInput(uint16_t n)
+void GraphNode::addInput(GraphNodeIndex n)
 {
-    inputs.push_back(n);
+    addEdge(Inputs, n);
 }
 
-void GraphNode::addPrev(uint16_t n)
+void GraphNode::addPrev(GraphNodeIndex n)
 {
-    prevs.push_back(n);
+    addEdge(Prevs, n);
 }
 
-void GraphNode::addNext(uint16_t n)
+void GraphNode::addNext(GraphNodeIndex n)
 {
-    nexts.push_back(n);
+    addEdge(Nexts, n);
 }
 
-void GraphNode::setPrev(uint16_t idx, uint16_t newValue)
+void GraphNode::setPrev(size_t idx, GraphNodeIndex newValue)
 {
-    prevs[idx] = newValue;
+    assert(idx < prevCount());
+    setEdge(sectionStart(Prevs) + idx, newValue);
 }
 
-void GraphNode::setNext(uint16_t idx, uint16_t newValue)
+void GraphNode::setNext(size_t idx, GraphNodeIndex newValue)
 {
-    nexts[idx] = newValue;
+    assert(idx < nextCount());
+    setEdge(sectionStart(Nexts) + idx, newValue);
 }
 
-void GraphNode::replacePrev(uint16_t oldValue, uint16_t newValue)
+void GraphNode::replacePrev(GraphNodeIndex oldValue, GraphNodeIndex newValue)
 {
-    for (uint16_t& prev : prevs) {
-        if (prev == oldValue) {
-            prev = newValue;
+    for (size_t i = 0; i < prevCount(); ++i) {
+        if (getPrev(i) == oldValue) {
+            setPrev(i, newValue);
             return;
         }
     }
     assert(false && "Prev not found!");
 }
+
+size_t GraphNode::heapMemoryUsage() const
+{
+    if (wideEdges)
+        return (wideHeaderSize + edgeCapacity()) * sizeof(uint32_t);
+    if (edgesOnHeap)
+        return narrowCapacity * sizeof(uint16_t);
+    return 0;
+}
@@ -5,38 +5,57 @@
 #include <vector>
 #include <unordered_map>
 #include <memory>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
 
 #include "graph/basicblock.hpp"
 #include "queries/types.hpp"
 #include "graph/type.hpp"
+#include "graph/nodetable.hpp"
 
 class AstNode;
 class GraphNode;
 class GraphStart;
 struct LexicalBindings;
 
+// Thrown when a function is too large for the indices of its graph
+class GraphTooLargeError : public std::runtime_error
+{
+public:
+    using std::runtime_error::runtime_error;
+};
+
 class Graph
 {
 public:
     Graph(Function& fun, const LexicalBindings& scope);
     Function& getFun() const;
-    uint16_t size() const;
-    const GraphNode &getNode(uint16_t n) const;
-    GraphNode &getNode(uint16_t n);
-    uint16_t getUndefinedNode();
-    uint16_t addNode(GraphNode&& node);
-    uint16_t addNode(GraphNode&& node, uint16_t prev);
-    uint16_t addNode(GraphNode &&node, const std::vector<uint16_t> &prevs);
-
-    uint16_t blockCount() const;
-    const BasicBlock& getBasicBlock(uint16_t n) const;
-    BasicBlock& getBasicBlock(uint16_t n);
-    BasicBlock& addBasicBlock(std::vector<uint16_t> prevs, const LexicalBindings& scope, bool shouldHoist);
-
-public:
-    std::unordered_map<const GraphNode*, TypeInfo> nodeTypes;
+    GraphNodeIndex size() const;
+    const GraphNode &getNode(GraphNodeIndex n) const;
+    GraphNode &getNode(GraphNodeIndex n);
+    GraphNodeIndex indexOf(const GraphNode& node) const; //< The node must be in this graph
+    GraphNodeIndex getUndefinedNode();
+    GraphNodeIndex addNode(GraphNode&& node);
+    GraphNodeIndex addNode(GraphNode&& node, GraphNodeIndex prev);
+    GraphNodeIndex addNode(GraphNode &&node, const std::vector<GraphNodeIndex> &prevs);
+
+    BasicBlockIndex blockCount() const;
+    const BasicBlock& getBasicBlock(BasicBlockIndex n) const;
+    BasicBlock& getBasicBlock(BasicBlockIndex n);
+    BasicBlock& addBasicBlock(std::vector<BasicBlockIndex> prevs, const LexicalBindings& scope, bool shouldHoist);
+
+    size_t memoryUsage() const; //< Approximate bytes used by the graph, including the slots of its type table
+
+    // Memoized types of the nodes, see resolveNodeType. Analyses of other modules resolve our types too, so these lock.
+    void allocateNodeTypes(); //< Called once the graph is complete, so the table never grows and memoryUsage() covers it
+    std::optional<TypeInfo> findNodeType(GraphNodeIndex n) const;
+    TypeInfo setNodeType(GraphNodeIndex n, TypeInfo type); //< If another thread set this type first, returns theirs
 
 private:
+    mutable std::mutex nodeTypesMutex;
+    NodeTable<TypeInfo> nodeTypes;
+
     std::vector<GraphNode> nodes;
     std::vector<std::unique_ptr<BasicBlock>> blocks;
     Function& fun;
@@ -46,11 +65,11 @@ class GraphNode
 {
 public:
     GraphNode(GraphNodeType type, AstNode* astReference = nullptr);
-    GraphNode(GraphNodeType type, uint16_t input, AstNode* astReference = nullptr);
-    GraphNode(GraphNodeType type, std::vector<uint16_t> &&inputs, AstNode* astReference = nullptr);
+    GraphNode(GraphNodeType type, GraphNodeIndex input, AstNode* astReference = nullptr);
+    GraphNode(GraphNodeType type, std::vector<GraphNodeIndex> &&inputs, AstNode* astReference = nullptr);
     GraphNode(const GraphNode& other) = delete;
-    GraphNode(GraphNode&& other) = default;
-    virtual ~GraphNode() = default;
+    GraphNode(GraphNode&& other);
+    ~GraphNode();
 
     GraphNodeType getType() const;
     const char* getTypeName() const;
@@ -60,26 +79,57 @@ public:
     size_t prevCount() const;
     size_t nextCount() const;
 
-    uint16_t getInput(uint16_t n) const;
-    uint16_t getPrev(uint16_t n) const;
-    uint16_t getNext(uint16_t n) const;
+    GraphNodeIndex getInput(size_t n) const;
+    GraphNodeIndex getPrev(size_t n) const;
+    GraphNodeIndex getNext(size_t n) const;
+
+    void addInput(GraphNodeIndex n);
+    void addPrev(GraphNodeIndex n);
+    void addNext(GraphNodeIndex n);
 
-    void addInput(uint16_t n);
-    void addPrev(uint16_t n);
-    void addNext(uint16_t n);
+    void setPrev(size_t idx, GraphNodeIndex newValue);
+    void setNext(size_t idx, GraphNodeIndex newValue);
 
-    void setPrev(uint16_t idx, uint16_t newValue);
-    void setNext(uint16_t idx, uint16_t newValue);
+    void replacePrev(GraphNodeIndex oldValue, GraphNodeIndex newValue);
 
-    void replacePrev(uint16_t oldValue, uint16_t newValue);
+    size_t heapMemoryUsage() const; //< Bytes of edges that didn't fit inline
 
 private:
-    // TODO: Switch to small vecs, or anything else that doesn't use 24 bytes + 1 allocation per object...
-    std::vector<uint16_t> inputs; // Data dependencies
-    std::vector<uint16_t> prevs, nexts; // Control dependencies
+    enum EdgeSection : uint8_t {
+        Inputs,
+        Prevs,
+        Nexts,
+    };
+
+    size_t sectionCount(EdgeSection section) const;
+    size_t sectionStart(EdgeSection section) const;
+    size_t edgeCount() const;
+    size_t edgeCapacity() const;
+    GraphNodeIndex getEdge(size_t position) const;
+    void setEdge(size_t position, GraphNodeIndex value);
+    void addEdge(EdgeSection section, GraphNodeIndex value);
+    void insertEdge(size_t position, GraphNodeIndex value);
+    void reallocateEdges(size_t newCapacity, bool wide);
+
+private:
+    static constexpr uint16_t inlineEdgesCapacity = 8; //< Enough for nearly all nodes, so they don't allocate
+    static constexpr size_t wideHeaderSize = 4; //< The counts of each section and the capacity, before the wide edges
+
     // TODO: On x86_64 we can save 7 bytes by putting the node type in the expression pointer (canonical addresses and all).
     AstNode* astReference;
+    // All edges are in one array: the inputs (data dependencies), then the prevs and nexts (control dependencies).
+    // The array is inline until it outgrows inlineEdgesCapacity, and holds 16-bit indices with 16-bit counts.
+    // Once an index or a count doesn't fit, it moves to a 32-bit heap array that starts with the counts and capacity.
+    union {
+        uint16_t inlineEdges[inlineEdgesCapacity];
+        uint16_t* narrowHeapEdges;
+        uint32_t* wideHeapEdges;
+    };
+    uint16_t narrowCounts[3] = {}; //< Edges in each section, unused once wide
+    uint16_t narrowCapacity = inlineEdgesCapacity;
     GraphNodeType type;
+    bool edgesOnHeap = false;
+    bool wideEdges = false; //< Edges and counts are 32 bits, always on the heap
 };
 
 #endif // GRAPH_HPP
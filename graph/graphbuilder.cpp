@@ -37,8 +37,8 @@ std::unique_ptr<Graph> GraphBuilder::buildFromAst()
     if (body->getType() != AstNodeType::BlockStatement)
         block->addNode({GraphNodeType::Return, block->getNewest()}, block->getNext());
 
-    vector<uint16_t> leaves;
-    for (uint16_t i=0; i<graph->size(); ++i) {
+    vector<GraphNodeIndex> leaves;
+    for (GraphNodeIndex i=0; i<graph->size(); ++i) {
         GraphNode& node = graph->getNode(i);
         if (node.prevCount() > 0 && node.nextCount() == 0) {
             assert(node.getType() != GraphNodeType::Break); // If this happens, we forgot to tie up pending breaks
@@ -47,7 +47,7 @@ std::unique_ptr<Graph> GraphBuilder::buildFromAst()
             leaves.push_back(i);
         }
         assert(node.getType() != GraphNodeType::Phi || node.inputCount() > 0 );
-        for (uint16_t j=0; j<node.inputCount(); ++j) {
+        for (size_t j=0; j<node.inputCount(); ++j) {
             if (node.getInput(j) == 0)
                 trace(fun, "About to fail graphbuilder assert for function:\n"+fun.getSourceString());
             assert(node.getInput(j) != 0);
@@ -60,13 +60,14 @@ std::unique_ptr<Graph> GraphBuilder::buildFromAst()
     if (!leaves.empty()) // A function can have no exit control flow at all (e.g. "do {continue} while (0)")
         graph->addNode({GraphNodeType::End}, leaves);
 
-    for (uint16_t i=0; i<graph->blockCount(); ++i)
+    for (BasicBlockIndex i=0; i<graph->blockCount(); ++i)
         if (!graph->getBasicBlock(i).isSealed())
             assert(false && "Graph built but not all blocks are sealed!");
 
     assert(pendingBreakBlocks.empty());
     assert(pendingContinueBlocks.empty());
 
+    graph->allocateNodeTypes();
     return std::move(graph);
 }
 
@@ -75,13 +76,13 @@ Graph &GraphBuilder::getGraph()
     return *graph;
 }
 
-BasicBlock &GraphBuilder::addBasicBlock(std::vector<uint16_t> prevs, const LexicalBindings &scope)
+BasicBlock &GraphBuilder::addBasicBlock(std::vector<BasicBlockIndex> prevs, const LexicalBindings &scope)
 {
     bool shouldHoist = hoistedScopes.insert(&scope).second;
     return graph->addBasicBlock(move(prevs), scope, shouldHoist);
 }
 
-void GraphBuilder::writeVariableById(BasicBlock &block, Identifier &id, uint16_t value)
+void GraphBuilder::writeVariableById(BasicBlock &block, Identifier &id, GraphNodeIndex value)
 {
     const auto& resolvedIds = parentModule.getResolvedLocalIdentifiers();
     auto declarationIt = resolvedIds.find((Identifier*)&id);
@@ -257,10 +258,10 @@ BasicBlock *GraphBuilder::processIfStatement(BasicBlock *block, IfStatement &nod
 {
     block = processAstNode(block, *node.getTest());
     block->addNode({GraphNodeType::If, block->getNewest()}, block->getNext());
-    uint16_t prevNodeId = block->getNext();
-    uint16_t prevBlockId = block->getSelfId();
-    vector<uint16_t> mergePrevs;
-    vector<uint16_t> mergePrevBlocks;
+    GraphNodeIndex prevNodeId = block->getNext();
+    BasicBlockIndex prevBlockId = block->getSelfId();
+    vector<GraphNodeIndex> mergePrevs;
+    vector<BasicBlockIndex> mergePrevBlocks;
 
     // Add then block & node
     BasicBlock *consequent = &addBasicBlock({prevBlockId}, block->getScope().scopeForChildNode(node.getConsequent()));
@@ -300,13 +301,13 @@ BasicBlock *GraphBuilder::processIfStatement(BasicBlock *block, IfStatement &nod
 BasicBlock *GraphBuilder::processWhileStatement(BasicBlock *block, WhileStatement &node)
 {
     // Add new block for loop header
-    uint16_t prevNodeId = block->getNext();
+    GraphNodeIndex prevNodeId = block->getNext();
     BasicBlock *headerBlock = &addBasicBlock({block->getSelfId()}, block->getScope());
-    uint16_t headerStartBlockId = headerBlock->getSelfId();
-    uint16_t headerMergeNode = headerBlock->addNode({GraphNodeType::Merge}, prevNodeId);
+    BasicBlockIndex headerStartBlockId = headerBlock->getSelfId();
+    GraphNodeIndex headerMergeNode = headerBlock->addNode({GraphNodeType::Merge}, prevNodeId);
     headerBlock = processAstNode(headerBlock, *node.getTest());
-    uint16_t headerLoopNode = headerBlock->addNode({GraphNodeType::Loop, headerBlock->getNewest()}, headerBlock->getNext());
-    uint16_t headerEndBlockId = headerBlock->getSelfId();
+    GraphNodeIndex headerLoopNode = headerBlock->addNode({GraphNodeType::Loop, headerBlock->getNewest()}, headerBlock->getNext());
+    BasicBlockIndex headerEndBlockId = headerBlock->getSelfId();
 
     // Add body block & node
     pendingBreakBlocks.emplace_back();
@@ -326,7 +327,7 @@ BasicBlock *GraphBuilder::processWhileStatement(BasicBlock *block, WhileStatemen
     // Tie up any continue statements
     assert(!pendingContinueBlocks.empty());
     headerBlock = &graph->getBasicBlock(headerStartBlockId);
-    for (uint16_t continueBlockId : pendingContinueBlocks.back()) {
+    for (BasicBlockIndex continueBlockId : pendingContinueBlocks.back()) {
         BasicBlock* continueBlock = &graph->getBasicBlock(continueBlockId);
         graph->getNode(continueBlock->getNext()).addNext(headerMergeNode);
         graph->getNode(headerMergeNode).addPrev(continueBlock->getNext());
@@ -341,10 +342,10 @@ BasicBlock *GraphBuilder::processWhileStatement(BasicBlock *block, WhileStatemen
     exitBlock->seal();
 
     // Tie up any break statements and merge
-    vector<uint16_t> mergePrevs;
-    vector<uint16_t> mergePrevBlocks;
+    vector<GraphNodeIndex> mergePrevs;
+    vector<BasicBlockIndex> mergePrevBlocks;
     assert(!pendingBreakBlocks.empty());
-    for (uint16_t breakBlockId : pendingBreakBlocks.back()) {
+    for (BasicBlockIndex breakBlockId : pendingBreakBlocks.back()) {
         BasicBlock* breakBlock = &graph->getBasicBlock(breakBlockId);
         mergePrevBlocks.push_back(breakBlockId);
         mergePrevs.push_back(breakBlock->getNext());
@@ -369,10 +370,10 @@ BasicBlock *GraphBuilder::processDoWhileStatement(BasicBlock *block, DoWhileStat
     // Add body block & node
     pendingBreakBlocks.emplace_back();
     pendingContinueBlocks.emplace_back();
-    uint16_t prevNodeId = block->getNext();
+    GraphNodeIndex prevNodeId = block->getNext();
     BasicBlock* body = &addBasicBlock({block->getSelfId()}, block->getScope().scopeForChildNode(node.getBody()));
-    uint16_t bodyStartId = body->getSelfId();
-    uint16_t bodyMergeNode = body->addNode({GraphNodeType::Merge}, prevNodeId);
+    GraphNodeIndex bodyStartId = body->getSelfId();
+    GraphNodeIndex bodyMergeNode = body->addNode({GraphNodeType::Merge}, prevNodeId);
     body = processAstNode(body, *node.getBody());
 
     BasicBlock* preMergeBlock;
@@ -381,8 +382,8 @@ BasicBlock *GraphBuilder::processDoWhileStatement(BasicBlock *block, DoWhileStat
     } else {
         // Loop test
         body = processAstNode(body, *node.getTest());
-        uint16_t loopNode = body->addNode({GraphNodeType::Loop, body->getNewest()}, body->getNext());
-        uint16_t testEndBlockId = body->getSelfId();
+        GraphNodeIndex loopNode = body->addNode({GraphNodeType::Loop, body->getNewest()}, body->getNext());
+        BasicBlockIndex testEndBlockId = body->getSelfId();
 
         // Need a whole block just to jump back to body
         BasicBlock* ifTrueBlock = &addBasicBlock({testEndBlockId}, body->getScope());
@@ -402,7 +403,7 @@ BasicBlock *GraphBuilder::processDoWhileStatement(BasicBlock *block, DoWhileStat
     // Tie up any continue statements
     assert(!pendingContinueBlocks.empty());
     body = &graph->getBasicBlock(bodyStartId);
-    for (uint16_t continueBlockId : pendingContinueBlocks.back()) {
+    for (BasicBlockIndex continueBlockId : pendingContinueBlocks.back()) {
         BasicBlock* continueBlock = &graph->getBasicBlock(continueBlockId);
         graph->getNode(continueBlock->getNext()).addNext(bodyMergeNode);
         graph->getNode(bodyMergeNode).addPrev(continueBlock->getNext());
@@ -412,10 +413,10 @@ BasicBlock *GraphBuilder::processDoWhileStatement(BasicBlock *block, DoWhileStat
     body->seal();
 
     // Tie up any break statements and merge
-    vector<uint16_t> mergePrevs;
-    vector<uint16_t> mergePrevBlocks;
+    vector<GraphNodeIndex> mergePrevs;
+    vector<BasicBlockIndex> mergePrevBlocks;
     assert(!pendingBreakBlocks.empty());
-    for (uint16_t breakBlockId : pendingBreakBlocks.back()) {
+    for (BasicBlockIndex breakBlockId : pendingBreakBlocks.back()) {
         BasicBlock* breakBlock = &graph->getBasicBlock(breakBlockId);
         mergePrevBlocks.push_back(breakBlockId);
         mergePrevs.push_back(breakBlock->getNext());
@@ -460,9 +461,9 @@ BasicBlock *GraphBuilder::processForStatement(BasicBlock *block, ForStatement &n
 
     // Add new block for loop merge and test
     BasicBlock *headerBlock = &addBasicBlock({initBlock->getSelfId()}, forScope);
-    uint16_t headerStartBlockId = headerBlock->getSelfId();
-    uint16_t headerMergeNode = headerBlock->addNode({GraphNodeType::Merge}, initBlock->getNext());
-    uint16_t headerLoopNode;
+    BasicBlockIndex headerStartBlockId = headerBlock->getSelfId();
+    GraphNodeIndex headerMergeNode = headerBlock->addNode({GraphNodeType::Merge}, initBlock->getNext());
+    GraphNodeIndex headerLoopNode;
     if (AstNode* test = node.getTest()) {
         headerBlock = processAstNode(headerBlock, *test);
         headerLoopNode = headerBlock->addNode({GraphNodeType::Loop, headerBlock->getNewest()}, headerBlock->getNext());
@@ -491,7 +492,7 @@ BasicBlock *GraphBuilder::processForStatement(BasicBlock *block, ForStatement &n
     // Tie up any continue statements
     assert(!pendingContinueBlocks.empty());
     headerBlock = &graph->getBasicBlock(headerStartBlockId);
-    for (uint16_t continueBlockId : pendingContinueBlocks.back()) {
+    for (BasicBlockIndex continueBlockId : pendingContinueBlocks.back()) {
         BasicBlock* continueBlock = &graph->getBasicBlock(continueBlockId);
         graph->getNode(continueBlock->getNext()).addNext(headerMergeNode);
         graph->getNode(headerMergeNode).addPrev(continueBlock->getNext());
@@ -506,10 +507,10 @@ BasicBlock *GraphBuilder::processForStatement(BasicBlock *block, ForStatement &n
     exitBlock->seal();
 
     // Tie up any break statements and merge
-    vector<uint16_t> mergePrevs;
-    vector<uint16_t> mergePrevBlocks;
+    vector<GraphNodeIndex> mergePrevs;
+    vector<BasicBlockIndex> mergePrevBlocks;
     assert(!pendingBreakBlocks.empty());
-    for (uint16_t breakBlockId : pendingBreakBlocks.back()) {
+    for (BasicBlockIndex breakBlockId : pendingBreakBlocks.back()) {
         BasicBlock* breakBlock = &graph->getBasicBlock(breakBlockId);
         mergePrevBlocks.push_back(breakBlockId);
         mergePrevs.push_back(breakBlock->getNext());
@@ -533,10 +534,10 @@ BasicBlock *GraphBuilder::processForOfStatement(BasicBlock *block, ForOfStatemen
 {
     // Add new block for loop header
     BasicBlock *headerBlock = &addBasicBlock({block->getSelfId()}, block->getScope().scopeForChildNode(&node));
-    uint16_t headerStartBlockId = headerBlock->getSelfId();
-    uint16_t headerMergeNode = headerBlock->addNode({GraphNodeType::Merge}, block->getNext());
+    BasicBlockIndex headerStartBlockId = headerBlock->getSelfId();
+    GraphNodeIndex headerMergeNode = headerBlock->addNode({GraphNodeType::Merge}, block->getNext());
     headerBlock = processAstNode(headerBlock, *node.getRight());
-    uint16_t headerLoopNode = headerBlock->addNode({GraphNodeType::ForOfLoop, headerBlock->getNewest()}, headerBlock->getNext());
+    GraphNodeIndex headerLoopNode = headerBlock->addNode({GraphNodeType::ForOfLoop, headerBlock->getNewest()}, headerBlock->getNext());
 
     // Add body block
     pendingBreakBlocks.emplace_back();
@@ -589,7 +590,7 @@ BasicBlock *GraphBuilder::processForOfStatement(BasicBlock *block, ForOfStatemen
     // Tie up any continue statements
     assert(!pendingContinueBlocks.empty());
     headerBlock = &graph->getBasicBlock(headerStartBlockId);
-    for (uint16_t continueBlockId : pendingContinueBlocks.back()) {
+    for (BasicBlockIndex continueBlockId : pendingContinueBlocks.back()) {
         BasicBlock* continueBlock = &graph->getBasicBlock(continueBlockId);
         graph->getNode(continueBlock->getNext()).addNext(headerMergeNode);
         graph->getNode(headerMergeNode).addPrev(continueBlock->getNext());
@@ -604,10 +605,10 @@ BasicBlock *GraphBuilder::processForOfStatement(BasicBlock *block, ForOfStatemen
     exitBlock->seal();
 
     // Tie up any break statements and merge
-    vector<uint16_t> mergePrevs;
-    vector<uint16_t> mergePrevBlocks;
+    vector<GraphNodeIndex> mergePrevs;
+    vector<BasicBlockIndex> mergePrevBlocks;
     assert(!pendingBreakBlocks.empty());
-    for (uint16_t breakBlockId : pendingBreakBlocks.back()) {
+    for (BasicBlockIndex breakBlockId : pendingBreakBlocks.back()) {
         BasicBlock* breakBlock = &graph->getBasicBlock(breakBlockId);
         mergePrevBlocks.push_back(breakBlockId);
         mergePrevs.push_back(breakBlock->getNext());
@@ -631,17 +632,17 @@ BasicBlock *GraphBuilder::processConditionalExpression(BasicBlock *block, Condit
 {
     block = processAstNode(block, *node.getTest());
     block->addNode({GraphNodeType::If, block->getNewest()}, block->getNext());
-    vector<uint16_t> mergePrevs;
+    vector<GraphNodeIndex> mergePrevs;
 
     // Add then block & node
     BasicBlock *consequent = &addBasicBlock({block->getSelfId()}, block->getScope().scopeForChildNode(node.getConsequent()));
     consequent->seal();
     consequent->addNode({GraphNodeType::IfTrue}, block->getNext());
     consequent = processAstNode(consequent, *node.getConsequent());
-    uint16_t consequentId = consequent->getSelfId();
+    GraphNodeIndex consequentId = consequent->getSelfId();
     assert(!consequent->isFilled());
     mergePrevs.push_back(consequent->getNext());
-    uint16_t consequentNewest = consequent->getNewest();
+    GraphNodeIndex consequentNewest = consequent->getNewest();
 
     // Add alternate block (and node, if any)
     AstNode* alternateNode = node.getAlternate();
@@ -650,10 +651,10 @@ BasicBlock *GraphBuilder::processConditionalExpression(BasicBlock *block, Condit
     alternate->addNode({GraphNodeType::IfFalse}, block->getNext());
     assert(alternateNode);
     alternate = processAstNode(alternate, *alternateNode);
-    uint16_t alternateId = alternate->getSelfId();
+    GraphNodeIndex alternateId = alternate->getSelfId();
     assert(!alternate->isFilled());
     mergePrevs.push_back(alternate->getNext());
-    uint16_t alternateNewest = alternate->getNewest();
+    GraphNodeIndex alternateNewest = alternate->getNewest();
 
     // Create block for merge and add merge node + phi
     BasicBlock *mergeBlock = &addBasicBlock({consequentId, alternateId}, block->getScope());
@@ -668,13 +669,13 @@ BasicBlock *GraphBuilder::processConditionalExpression(BasicBlock *block, Condit
 BasicBlock *GraphBuilder::processTryStatement(BasicBlock *block, TryStatement &node)
 {
     BasicBlock *tryBlock = &addBasicBlock({block->getSelfId()}, block->getScope().scopeForChildNode(node.getBlock()));
-    uint16_t tryNodeId = tryBlock->addNode({GraphNodeType::Try, &node}, block->getNext());
+    GraphNodeIndex tryNodeId = tryBlock->addNode({GraphNodeType::Try, &node}, block->getNext());
     tryBlock->seal();
 
     BasicBlock *catchBlock = nullptr;
     BasicBlock *mergeBlock = nullptr;
-    vector<uint16_t> mergePrevs;
-    vector<uint16_t> mergePrevBlocks;
+    vector<GraphNodeIndex> mergePrevs;
+    vector<BasicBlockIndex> mergePrevBlocks;
 
     if (auto handler = node.getHandler()) {
         if (node.getFinalizer()) { // Both cactch and finally
@@ -731,7 +732,7 @@ BasicBlock *GraphBuilder::processThrowStatement(BasicBlock *block, ThrowStatemen
 {
     block = processAstNode(block, *node.getArgument());
     block->addNode({GraphNodeType::PrepareException, block->getNewest(), &node}, block->getNext());
-    uint16_t prepareNode = block->getNext();
+    GraphNodeIndex prepareNode = block->getNext();
 
     if (catchStack.empty()) {
         block->addNode({GraphNodeType::Throw, &node}, block->getNext());
@@ -754,7 +755,7 @@ BasicBlock *GraphBuilder::processIdentifierNode(BasicBlock *block, Identifier &n
         trace(*declarationIdentifier, "Read "+node.getName());
     else
         trace(node, "Unknown declaration identifier Read "+node.getName());
-    if (uint16_t* existingVar = block->readVariable(declarationIdentifier)) {
+    if (GraphNodeIndex* existingVar = block->readVariable(declarationIdentifier)) {
         block->setNewest(*existingVar);
     } else if (isChildOf(declarationIdentifier, *fun.getBody())) {
         // The variable isn't local to this basic block, we need to run global value numbering
@@ -788,7 +789,7 @@ BasicBlock *GraphBuilder::processAssignmentExprNode(BasicBlock *block, Assignmen
             block = processAstNode(block, *node.getRight());
         } else {
             block = processAstNode(block, *left);
-            uint16_t leftValue = block->getNewest();
+            GraphNodeIndex leftValue = block->getNewest();
             block = processAstNode(block, *node.getRight());
             block->addNode({GraphNodeType::BinaryOperator, {leftValue, block->getNewest()}, &node});
         }
@@ -796,22 +797,22 @@ BasicBlock *GraphBuilder::processAssignmentExprNode(BasicBlock *block, Assignmen
     } else if (left->getType() == AstNodeType::MemberExpression) {
         auto leftExpr = (MemberExpression*)left;
         block = processAstNode(block, *leftExpr->getObject());
-        uint16_t object = block->getNewest();
+        GraphNodeIndex object = block->getNewest();
 
         auto propNode = leftExpr->getProperty();
         if (leftExpr->isComputed()) {
             block = processAstNode(block, *propNode);
-            uint16_t prop = block->getNewest();
+            GraphNodeIndex prop = block->getNewest();
 
             block = processAstNode(block, *node.getRight());
-            uint16_t value = block->getNewest();
+            GraphNodeIndex value = block->getNewest();
 
             block->addNode({GraphNodeType::StoreProperty, {object, prop, value}, propNode}, block->getNext());
         } else {
             assert(propNode->getType() == AstNodeType::Identifier);
 
             block = processAstNode(block, *node.getRight());
-            uint16_t value = block->getNewest();
+            GraphNodeIndex value = block->getNewest();
 
             block->addNode({GraphNodeType::StoreNamedProperty, {object, value}, propNode}, block->getNext());
         }
@@ -825,9 +826,9 @@ BasicBlock *GraphBuilder::processAssignmentExprNode(BasicBlock *block, Assignmen
 BasicBlock *GraphBuilder::processCallExprNode(BasicBlock *block, CallExpression &node)
 {
     block = processAstNode(block, *node.getCallee());
-    uint16_t calleeNode = block->getNewest();
+    GraphNodeIndex calleeNode = block->getNewest();
 
-    vector<uint16_t> inputs = {calleeNode};
+    vector<GraphNodeIndex> inputs = {calleeNode};
     auto args = node.getArguments();
     for (AstNode* arg : args) {
         block = processAstNode(block, *arg);
@@ -844,7 +845,7 @@ BasicBlock *GraphBuilder::processCallExprNode(BasicBlock *block, CallExpression
 
 BasicBlock *GraphBuilder::processArrayExprNode(BasicBlock *block, ArrayExpression &node)
 {
-    vector<uint16_t> elemNodes;
+    vector<GraphNodeIndex> elemNodes;
     for (auto elem : node.getElements()) {
         if (!elem) {
             block->setNewest(graph->getUndefinedNode());
@@ -860,7 +861,7 @@ BasicBlock *GraphBuilder::processArrayExprNode(BasicBlock *block, ArrayExpressio
 
 BasicBlock *GraphBuilder::processObjectExprNode(BasicBlock *block, ObjectExpression &node)
 {
-    vector<uint16_t> elemNodes;
+    vector<GraphNodeIndex> elemNodes;
     const auto& props = node.getProperties();
     for (auto& prop : props) {
         block = processAstNode(block, *prop);
@@ -875,7 +876,7 @@ BasicBlock *GraphBuilder::processObjectPropNode(BasicBlock *block, ObjectPropert
 {
     if (node.isComputed()) {
         block = processAstNode(block, *node.getKey());
-        uint16_t keyNode = block->getNewest();
+        GraphNodeIndex keyNode = block->getNewest();
         block = processAstNode(block, *node.getValue());
         block->addNode({GraphNodeType::ObjectProperty, {block->getNewest(), keyNode}, &node});
     } else {
@@ -898,7 +899,7 @@ BasicBlock *GraphBuilder::processSpreadElemNode(BasicBlock *block, SpreadElement
 
 BasicBlock *GraphBuilder::processTemplateLiteralNode(BasicBlock *block, TemplateLiteral &node)
 {
-    vector<uint16_t> inputs;
+    vector<GraphNodeIndex> inputs;
     for (auto expr : node.getExpressions()) {
         block = processAstNode(block, *expr);
         inputs.push_back(block->getNewest());
@@ -931,7 +932,7 @@ BasicBlock* GraphBuilder::processVariableDeclarationNode(BasicBlock* block, Vari
     return block;
 }
 
-BasicBlock *GraphBuilder::processObjectPatternNode(BasicBlock *block, ObjectPattern &node, uint16_t object)
+BasicBlock *GraphBuilder::processObjectPatternNode(BasicBlock *block, ObjectPattern &node, GraphNodeIndex object)
 {
     for (AstNode* prop : node.getProperties()) {
         if (prop->getType() == AstNodeType::ObjectProperty) {
@@ -943,7 +944,7 @@ BasicBlock *GraphBuilder::processObjectPatternNode(BasicBlock *block, ObjectPatt
                 assert(objProp->getKey()->getType() == AstNodeType::Identifier);
                 block->addNode({GraphNodeType::LoadNamedProperty, object, objProp->getKey()}, block->getNext());
             }
-            uint16_t loadedKey = block->getNewest();
+            GraphNodeIndex loadedKey = block->getNewest();
 
             AstNode* value = objProp->getValue();
             if (value->getType() == AstNodeType::Identifier) {
@@ -966,7 +967,7 @@ BasicBlock *GraphBuilder::processObjectPatternNode(BasicBlock *block, ObjectPatt
 BasicBlock *GraphBuilder::processMemberExprNode(BasicBlock *block, MemberExpression &node)
 {
     block = processAstNode(block, *node.getObject());
-    uint16_t object = block->getNewest();
+    GraphNodeIndex object = block->getNewest();
 
     auto prop = node.getProperty();
     if (node.isComputed()) {
@@ -1005,16 +1006,16 @@ BasicBlock *GraphBuilder::processUnaryExprNode(BasicBlock *block, UnaryExpressio
 BasicBlock* GraphBuilder::processBinaryExprNode(BasicBlock* block, BinaryExpression &node)
 {
     block = processAstNode(block, *node.getLeft());
-    uint16_t left = block->getNewest();
+    GraphNodeIndex left = block->getNewest();
     block = processAstNode(block, *node.getRight());
-    uint16_t right = block->getNewest();
+    GraphNodeIndex right = block->getNewest();
     block->addNode({GraphNodeType::BinaryOperator, {left, right}, &node});
     return block;
 }
 
 BasicBlock *GraphBuilder::processUpdateExprNode(BasicBlock *block, UpdateExpression &node)
 {
-    uint16_t argValue;
+    GraphNodeIndex argValue;
     AstNode* arg = node.getArgument();
     trace(*arg, "Write update expr");
 
@@ -1030,7 +1031,7 @@ BasicBlock *GraphBuilder::processUpdateExprNode(BasicBlock *block, UpdateExpress
     } else if (arg->getType() == AstNodeType::MemberExpression) {
         auto leftExpr = (MemberExpression*)arg;
         block = processAstNode(block, *leftExpr->getObject());
-        uint16_t object = block->getNewest();
+        GraphNodeIndex object = block->getNewest();
 
         auto propNode = leftExpr->getProperty();
         if (leftExpr->isComputed()) {
@@ -1038,7 +1039,7 @@ BasicBlock *GraphBuilder::processUpdateExprNode(BasicBlock *block, UpdateExpress
             argValue = block->getNewest();
 
             block->addNode({GraphNodeType::UnaryOperator, argValue, &node});
-            uint16_t value = block->getNewest();
+            GraphNodeIndex value = block->getNewest();
 
             block->addNode({GraphNodeType::StoreProperty, {object, argValue, value}, propNode}, block->getNext());
         } else {
@@ -1047,7 +1048,7 @@ BasicBlock *GraphBuilder::processUpdateExprNode(BasicBlock *block, UpdateExpress
             argValue = block->getNewest();
 
             block->addNode({GraphNodeType::UnaryOperator, argValue, &node});
-            uint16_t value = block->getNewest();
+            GraphNodeIndex value = block->getNewest();
 
             block->addNode({GraphNodeType::StoreNamedProperty, {object, value}, propNode}, block->getNext());
         }
@@ -1061,9 +1062,9 @@ BasicBlock *GraphBuilder::processUpdateExprNode(BasicBlock *block, UpdateExpress
 BasicBlock *GraphBuilder::processLogicalExprNode(BasicBlock *block, LogicalExpression &node)
 {
     block = processAstNode(block, *node.getLeft());
-    uint16_t left = block->getNewest();
+    GraphNodeIndex left = block->getNewest();
     block = processAstNode(block, *node.getRight());
-    uint16_t right = block->getNewest();
+    GraphNodeIndex right = block->getNewest();
     block->addNode({GraphNodeType::BinaryOperator, {left, right}, &node});
     return block;
 }
@@ -1082,14 +1083,14 @@ BasicBlock *GraphBuilder::processSwitchStatement(BasicBlock *block, SwitchStatem
     tryBlock->setNext(block->getNext());
     tryBlock->seal();
     tryBlock = processAstNode(tryBlock, *node.getDiscriminant());
-    uint16_t discriminantNode = tryBlock->getNewest();
+    GraphNodeIndex discriminantNode = tryBlock->getNewest();
 
     tryBlock->addNode({GraphNodeType::Switch, discriminantNode}, tryBlock->getNext());
     tryBlock->setFilled();
-    uint16_t switchNodeId = tryBlock->getNext();
-    uint16_t prevBlockId = tryBlock->getSelfId();
-    vector<uint16_t> mergePrevs;
-    vector<uint16_t> mergePrevBlocks;
+    GraphNodeIndex switchNodeId = tryBlock->getNext();
+    BasicBlockIndex prevBlockId = tryBlock->getSelfId();
+    vector<GraphNodeIndex> mergePrevs;
+    vector<BasicBlockIndex> mergePrevBlocks;
 
     if (node.getCases().empty()) {
         BasicBlock* exitBlock = &addBasicBlock({prevBlockId}, block->getScope());
@@ -1098,7 +1099,7 @@ BasicBlock *GraphBuilder::processSwitchStatement(BasicBlock *block, SwitchStatem
     }
 
     pendingBreakBlocks.emplace_back();
-    uint16_t prevCaseBlockId = 0;
+    BasicBlockIndex prevCaseBlockId = 0;
     for (SwitchCase* caseNode : node.getCases()) {
         BasicBlock *caseBlock = &addBasicBlock({prevBlockId}, tryBlock->getScope().scopeForChildNode(&node));
         caseBlock->setNext(switchNodeId);
@@ -1131,7 +1132,7 @@ BasicBlock *GraphBuilder::processSwitchStatement(BasicBlock *block, SwitchStatem
 
     // Tie up any break statements
     assert(!pendingBreakBlocks.empty());
-    for (uint16_t breakBlockId : pendingBreakBlocks.back()) {
+    for (BasicBlockIndex breakBlockId : pendingBreakBlocks.back()) {
         BasicBlock* breakBlock = &graph->getBasicBlock(breakBlockId);
         mergePrevBlocks.push_back(breakBlockId);
         mergePrevs.push_back(breakBlock->getNext());
@@ -18,8 +18,8 @@ public:
     Graph& getGraph();
 
 private:
-    BasicBlock& addBasicBlock(std::vector<uint16_t> prevs, const LexicalBindings& scope);
-    void writeVariableById(BasicBlock& block, Identifier& id, uint16_t value);
+    BasicBlock& addBasicBlock(std::vector<BasicBlockIndex> prevs, const LexicalBindings& scope);
+    void writeVariableById(BasicBlock& block, Identifier& id, GraphNodeIndex value);
 
     BasicBlock* processArgument(BasicBlock* block, AstNode& node);
     // Returns the basic block where next nodes should be added
@@ -39,7 +39,7 @@ private:
     BasicBlock* processTemplateLiteralNode(BasicBlock* block, TemplateLiteral &node);
     BasicBlock* processVariableDeclarationNode(BasicBlock* block, VariableDeclaration &node);
     BasicBlock* processIdentifierNode(BasicBlock* block, Identifier &node);
-    BasicBlock* processObjectPatternNode(BasicBlock* block, ObjectPattern &node, uint16_t object);
+    BasicBlock* processObjectPatternNode(BasicBlock* block, ObjectPattern &node, GraphNodeIndex object);
     BasicBlock* processIfStatement(BasicBlock* block, IfStatement& node);
     BasicBlock* processWhileStatement(BasicBlock* block, WhileStatement& node);
     BasicBlock* processDoWhileStatement(BasicBlock* block, DoWhileStatement& node);
@@ -55,9 +55,9 @@ private:
 
 private:
     std::unique_ptr<Graph> graph;
-    std::vector<uint16_t> catchStack; // Nodes able to catch an exception thrown in the current block (last has priority)
-    std::vector<std::vector<uint16_t>> pendingBreakBlocks; // Blocks of break nodes that haven't been tied up into a merge by their parent yet, one vector per parent scope.
-    std::vector<std::vector<uint16_t>> pendingContinueBlocks; // Blocks of continue nodes that haven't been tied up into a merge by their parent yet, one vector per parent scope.
+    std::vector<GraphNodeIndex> catchStack; // Nodes able to catch an exception thrown in the current block (last has priority)
+    std::vector<std::vector<BasicBlockIndex>> pendingBreakBlocks; // Blocks of break nodes that haven't been tied up into a merge by their parent yet, one vector per parent scope.
+    std::vector<std::vector<BasicBlockIndex>> pendingContinueBlocks; // Blocks of continue nodes that haven't been tied up into a merge by their parent yet, one vector per parent scope.
     std::unordered_set<const LexicalBindings*> hoistedScopes; // Scopes for which a basic block has already performed hoisting
     Function& fun;
     Module& parentModule;
@@ -0,0 +1,117 @@
+#include "graphcache.hpp"
+#include "graph/graph.hpp"
+#include "graph/graphbuilder.hpp"
+#include "ast/ast.hpp"
+#include "utils/reporting.hpp"
+#include <chrono>
+#include <stdexcept>
+
+using namespace std;
+
+static atomic_size_t budget = 0;
+static GraphCacheStats stats;
+
+// Lock order is a graph mutex, then the LRU mutex. Eviction already holds the LRU mutex, so it only try_locks its victims.
+static mutex lruMutex;
+static list<CachedGraph*> lru; //< Most recently used first, only the graphs currently built are in there
+
+void setGraphCacheBudget(size_t bytes)
+{
+    budget = bytes;
+}
+
+const GraphCacheStats& getGraphCacheStatistics()
+{
+    return stats;
+}
+
+CachedGraph::~CachedGraph()
+{
+    lock_guard lock(lruMutex);
+    if (inLru) {
+        lru.erase(lruPosition);
+        stats.cachedBytes -= memoryUsage;
+    }
+}
+
+shared_ptr<Graph> CachedGraph::get(Function& fun)
+{
+    lock_guard lock(graphMutex);
+    if (graph) {
+        stats.hits++;
+        touch();
+        return graph;
+    }
+    if (failed) {
+        stats.hits++;
+        return nullptr;
+    }
+
+    auto start = chrono::steady_clock::now();
+    try {
+        graph = GraphBuilder(fun).buildFromAst();
+    } catch (const GraphTooLargeError& e) {
+        warn(fun, e.what());
+        stats.builds++;
+        failed = true;
+        return nullptr;
+    } catch (const runtime_error& e) {
+        trace(fun, "Failed to build function graph: "s+e.what());
+        stats.builds++;
+        failed = true;
+        return nullptr;
+    }
+    if (built) {
+        stats.rebuilds++;
+        stats.rebuildNs += static_cast<uint64_t>(chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count());
+    } else {
+        stats.builds++;
+        built = true;
+    }
+
+    shared_ptr<Graph> result = graph;
+    insert();
+    return result;
+}
+
+void CachedGraph::touch()
+{
+    if (!budget)
+        return; // Nothing is ever evicted, so don't contend on the LRU mutex
+    lock_guard lock(lruMutex);
+    if (inLru)
+        lru.splice(lru.begin(), lru, lruPosition);
+}
+
+void CachedGraph::insert()
+{
+    memoryUsage = graph->memoryUsage();
+    uint64_t cachedBytes = stats.cachedBytes += memoryUsage;
+    for (uint64_t peak = stats.peakCachedBytes; cachedBytes > peak && !stats.peakCachedBytes.compare_exchange_weak(peak, cachedBytes);)
+        ;
+
+    lock_guard lock(lruMutex);
+    lruPosition = lru.insert(lru.begin(), this);
+    inLru = true;
+    if (budget && cachedBytes > budget)
+        evictIdleGraphs(this);
+}
+
+void CachedGraph::evictIdleGraphs(CachedGraph* newest)
+{
+    // The LRU mutex is locked. We never evict the newest graph, so a graph bigger than the whole budget still gets used
+    for (auto it = lru.end(); it != lru.begin() && stats.cachedBytes > budget;) {
+        CachedGraph* victim = *--it;
+        if (victim == newest || !victim->graphMutex.try_lock())
+            continue;
+        // Copies of the graph pointer are only made with its mutex locked, so nobody else can start using it now
+        if (victim->graph.use_count() == 1) {
+            victim->graph.reset();
+            victim->inLru = false;
+            stats.cachedBytes -= victim->memoryUsage;
+            stats.evictions++;
+            it = lru.erase(it);
+        }
+        victim->graphMutex.unlock();
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef GRAPHCACHE_HPP
+#define GRAPHCACHE_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+
+class Function;
+class Graph;
+
+// The function graphs of all modules share one memory budget. Past it, the least recently used graphs that nobody holds are freed,
+// and rebuilt the next time they're asked for. Set the budget before starting analyses, 0 (the default) keeps every graph.
+void setGraphCacheBudget(size_t bytes);
+
+struct GraphCacheStats {
+    std::atomic_uint64_t hits = 0;
+    std::atomic_uint64_t builds = 0; //< First builds, including the graphs that failed to build
+    std::atomic_uint64_t rebuilds = 0; //< Builds of graphs that were evicted
+    std::atomic_uint64_t rebuildNs = 0; //< Total time spent rebuilding evicted graphs
+    std::atomic_uint64_t evictions = 0;
+    std::atomic_uint64_t cachedBytes = 0; //< Estimated size of the graphs currently cached
+    std::atomic_uint64_t peakCachedBytes = 0;
+};
+
+const GraphCacheStats& getGraphCacheStatistics();
+
+// The graph of one function, built on demand
+class CachedGraph {
+public:
+    CachedGraph() = default;
+    CachedGraph(const CachedGraph& other) = delete;
+    ~CachedGraph();
+
+    // Builds the graph if it was never built or was evicted. May return nullptr if the graph could not be built!
+    // Holding the returned pointer keeps the graph from being evicted.
+    std::shared_ptr<Graph> get(Function& fun);
+
+private:
+    void touch(); //< Moves us to the front of the LRU list, the graph mutex is locked
+    void insert(); //< Adds our new graph to the LRU list and evicts others if we're over budget, the graph mutex is locked
+    static void evictIdleGraphs(CachedGraph* newest);
+
+private:
+    std::mutex graphMutex;
+    std::shared_ptr<Graph> graph;
+    bool built = false;
+    bool failed = false;
+    size_t memoryUsage = 0;
+    bool inLru = false;
+    std::list<CachedGraph*>::iterator lruPosition; //< Protected by the LRU mutex
+};
+
+#endif // GRAPHCACHE_HPP
@@ -0,0 +1,46 @@
+#ifndef NODETABLE_HPP
+#define NODETABLE_HPP
+
+#include "graph/type.hpp"
+#include <vector>
+#include <optional>
+#include <cassert>
+
+// Per-node analysis results of a graph, indexed by node. Node indices are dense, so this is a flat array instead of a hash map.
+// Nodes whose result wasn't computed yet have no value. Resizing invalidates references to the values.
+template <class T>
+class NodeTable
+{
+public:
+    NodeTable() = default;
+    explicit NodeTable(GraphNodeIndex size) : values(size) {}
+
+    GraphNodeIndex size() const { return static_cast<GraphNodeIndex>(values.size()); }
+    void resize(GraphNodeIndex size) { values.resize(size); }
+
+    // Returns nullptr if this node's result wasn't computed yet
+    const T* find(GraphNodeIndex n) const
+    {
+        assert(n < values.size());
+        return values[n] ? &*values[n] : nullptr;
+    }
+
+    T* find(GraphNodeIndex n)
+    {
+        assert(n < values.size());
+        return values[n] ? &*values[n] : nullptr;
+    }
+
+    T& set(GraphNodeIndex n, T value)
+    {
+        assert(n < values.size());
+        return values[n].emplace(std::move(value));
+    }
+
+    size_t memoryUsage() const { return values.capacity() * sizeof(std::optional<T>); } //< Not counting what the values point to
+
+private:
+    std::vector<std::optional<T>> values;
+};
+
+#endif // NODETABLE_HPP
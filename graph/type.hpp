@@ -56,4 +56,9 @@ enum class GraphNodeType : uint8_t {
 };
 #undef X
 
+// Functions generated by bundlers can have well over 65535 nodes, so indices are 32 bits.
+// GraphNode still stores its edges in 16 bits while they fit, see GraphNode::wideEdges.
+using GraphNodeIndex = uint32_t;
+using BasicBlockIndex = uint32_t;
+
 #endif // TYPE_H
@@ -1,4 +1,7 @@
 #include "module/moduleresolver.hpp"
+#include "module/analysis.hpp"
+#include "module/fscache.hpp"
+#include "graph/graphcache.hpp"
 #include "v8/isolatewrapper.hpp"
 #include "ast/parse.hpp"
 #include "utils/utils.hpp"
@@ -28,6 +31,10 @@ void helpAndDie(const char* selfPath, bool fullHelp = false)
     cout << "  -h               Show this help message\n";
     cout << "  -s               Show suggestions. Not recommended, as it may include many false positives\n";
     cout << "  -d               Show debug output\n";
+    cout << "  -p <parser>      Use the 'native' (default) or 'babel' parser. The native parser falls back to Babel when needed\n";
+    cout << "  -j <N|auto>      Number of parse worker threads. 'auto' (default) sizes the pool from the CPU quota and available memory\n";
+    cout << "  -a <N|auto>      Number of import discovery, analysis and graph building threads. 'auto' (default) uses one per available CPU, 1 analyzes the modules in order\n";
+    cout << "  -m <MiB>         Memory budget for function graphs. Idle graphs past it are freed and rebuilt when needed, by default all are kept\n";
     exit(EXIT_SUCCESS);
 }
 
@@ -39,7 +46,8 @@ int main(int argc, char* argv[])
 
     bool debug = false;
     bool suggest = false;
-    for (int c; (c = getopt(argc, argv, "dsh")) != -1;) {
+    unsigned threads = 0;
+    for (int c; (c = getopt(argc, argv, "dshp:j:a:m:")) != -1;) {
         switch (c) {
         case 'd':
             debug = true;
@@ -47,10 +55,48 @@ int main(int argc, char* argv[])
         case 's':
             suggest = true;
             break;
+        case 'p':
+            if (optarg == "babel"s)
+                setParserBackend(ParserBackend::Babel);
+            else if (optarg == "native"s)
+                setParserBackend(ParserBackend::Native);
+            else
+                helpAndDie(argv[0]);
+            break;
+        case 'j':
+            if (optarg == "auto"s) {
+                setParseWorkersCount(0);
+            } else {
+                char* end;
+                long count = strtol(optarg, &end, 10);
+                if (*end || count <= 0)
+                    helpAndDie(argv[0]);
+                setParseWorkersCount(static_cast<unsigned>(count));
+            }
+            break;
+        case 'a':
+            if (optarg == "auto"s) {
+                threads = 0;
+            } else {
+                char* end;
+                long count = strtol(optarg, &end, 10);
+                if (*end || count <= 0)
+                    helpAndDie(argv[0]);
+                threads = static_cast<unsigned>(count);
+            }
+            break;
+        case 'm': {
+            char* end;
+            long megabytes = strtol(optarg, &end, 10);
+            if (*end || megabytes <= 0)
+                helpAndDie(argv[0]);
+            setGraphCacheBudget(static_cast<size_t>(megabytes) * 1024 * 1024);
+            break;
+        }
         case 'h':
             helpAndDie(argv[0], true);
         case '?':
-            if (optopt == 'c')
+            if (optopt == 'p' || optopt == 'j' || optopt == 'a' || optopt == 'm')
                 fprintf(stderr, "Option -%c requires an argument.\n", optopt);
             else if (isprint(optopt))
                 fprintf(stderr, "Unknown option `-%c'.\n", optopt);
@@ -63,6 +109,8 @@ int main(int argc, char* argv[])
     }
     setDebug(debug);
     setSuggest(suggest);
+    if (!threads)
+        threads = availableCpuCount();
 
     // Start real work
     IsolateWrapper isolateWrapper;
@@ -82,19 +130,31 @@ int main(int argc, char* argv[])
         ModuleResolver::getProjectMainFile(argPath.remove_filename());
         cout << "Resolving project imports..." << endl;
         Module& mainModule = (Module&)ModuleResolver::getModule(isolateWrapper, fs::current_path(), argPath, true);
-        mainModule.resolveProjectImports(argPath); // Loads all the project modules (and other dependencies)
+        discoverProjectModules(mainModule, argPath, threads); // Loads all the project modules (and other dependencies)
         modulesToAnalyze = ModuleResolver::getLoadedProjectModules(argPath);
     } else {
         modulesToAnalyze.push_back((Module*)&ModuleResolver::getModule(isolateWrapper, fs::current_path(), argPath, true));
     }
 
     cout << "Starting analysis..." << endl;
-    for (Module* module : modulesToAnalyze)
-        module->analyze();
+    analyzeModules(modulesToAnalyze, threads);
 
     const auto& report = getReportingStatistics();
     cout << "Found " << report.errors << " error(s), " << report.warnings << " warning(s) and " << report.suggestions << " suggestion(s)." << endl;
 
+    const auto& parseStats = getParseQueueStatistics();
+    if (parseStats.packages)
+        trace("Parse queue: "+to_string(parseStats.packages)+" package(s), average wait "+to_string(parseStats.totalWaitNs / parseStats.packages / 1000)
+              +"us, max "+to_string(parseStats.maxWaitNs / 1000)+"us, "+to_string(parseStats.stolen)+" stolen, "+to_string(parseStats.prioritized)+" prioritized");
+    const auto& resolutionStats = ModuleResolver::getResolutionStatistics();
+    const auto& fsStats = getFsCacheStatistics();
+    trace("Module resolution: "+to_string(resolutionStats.hits)+" cache hit(s), "+to_string(resolutionStats.misses)+" miss(es), "
+          +to_string(fsStats.lookups)+" file lookup(s) ("+to_string(fsStats.negativeLookups)+" negative) over "+to_string(fsStats.directoriesListed)+" directory listing(s), "
+          +to_string(fsStats.canonicalHits)+" canonical path hit(s), "+to_string(fsStats.canonicalMisses)+" miss(es)");
+    const auto& graphStats = getGraphCacheStatistics();
+    trace("Function graphs: "+to_string(graphStats.builds)+" built, "+to_string(graphStats.hits)+" cache hit(s), "+to_string(graphStats.evictions)+" eviction(s), "
+          +to_string(graphStats.rebuilds)+" rebuild(s) taking "+to_string(graphStats.rebuildNs / 1000000)+"ms, peak "+to_string(graphStats.peakCachedBytes / 1024)+"KiB cached");
+
     // Cleanup
     stopParsingThreads();
 
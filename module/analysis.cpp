@@ -0,0 +1,127 @@
+#include "analysis.hpp"
+#include "module.hpp"
+#include "v8/isolatewrapper.hpp"
+#include "utils/reporting.hpp"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+
+using namespace std;
+
+void discoverProjectModules(Module& entryModule, const filesystem::path& projectDir, unsigned threadsCount)
+{
+    mutex frontierMutex;
+    condition_variable frontierCondvar;
+    deque<Module*> frontier{&entryModule}; //< Loaded modules whose imports we haven't looked at, their parses are already queued
+    unordered_set<Module*> discovered{&entryModule};
+    unsigned busyThreads = 0;
+    exception_ptr error;
+
+    auto discover = [&] {
+        unique_lock lock(frontierMutex);
+        for (;;) {
+            // When nobody is busy and the frontier is empty, no one can find more modules
+            frontierCondvar.wait(lock, [&] { return !frontier.empty() || !busyThreads || error; });
+            if (frontier.empty() || error)
+                break;
+            Module* module = frontier.front();
+            frontier.pop_front();
+            busyThreads++;
+            lock.unlock();
+
+            vector<Module*> imports;
+            exception_ptr moduleError;
+            try {
+                imports = module->findProjectImports(projectDir); // Waits for this module's AST
+            } catch (...) {
+                moduleError = current_exception();
+            }
+
+            lock.lock();
+            busyThreads--;
+            if (moduleError && !error)
+                error = moduleError;
+            for (Module* import : imports)
+                if (discovered.insert(import).second)
+                    frontier.push_back(import);
+            frontierCondvar.notify_all();
+        }
+    };
+
+    if (threadsCount <= 1) {
+        discover();
+    } else {
+        // Loading modules locks the isolate, see ModuleResolver::getModule
+        v8::Unlocker unlocker(*entryModule.getIsolateWrapper());
+        vector<thread> threads;
+        for (unsigned i = 0; i < threadsCount; ++i)
+            threads.emplace_back(discover);
+        for (auto& thread : threads)
+            thread.join();
+    }
+    if (error)
+        rethrow_exception(error);
+}
+
+struct ModuleReports {
+    string output;
+    exception_ptr error;
+};
+
+void analyzeModules(const vector<Module*>& modules, unsigned threadsCount)
+{
+    // When there are fewer modules than threads, the spare threads help build each module's function graphs
+    unsigned graphThreadsCount = max(1u, threadsCount / static_cast<unsigned>(max<size_t>(modules.size(), 1)));
+    threadsCount = static_cast<unsigned>(min<size_t>(threadsCount, modules.size()));
+    if (threadsCount <= 1) {
+        for (Module* module : modules)
+            module->analyze(graphThreadsCount);
+        return;
+    }
+
+    // Analyses only lock the isolate when they need V8, mostly to resolve identifiers and load imports
+    v8::Unlocker unlocker(*modules.front()->getIsolateWrapper());
+
+    vector<promise<ModuleReports>> reports(modules.size());
+    atomic_size_t nextModule = 0;
+    auto analyzeNextModules = [&] {
+        for (size_t i; (i = nextModule++) < modules.size();) {
+            BufferedReports buffer;
+            exception_ptr error;
+            try {
+                modules[i]->analyze(graphThreadsCount);
+            } catch (...) {
+                error = current_exception();
+            }
+            reports[i].set_value({buffer.take(), error});
+        }
+    };
+
+    vector<thread> threads;
+    for (unsigned i = 0; i < threadsCount; ++i)
+        threads.emplace_back(analyzeNextModules);
+
+    // Print each module's reports as soon as it and all the modules before it are done.
+    // Like a serial analysis, we stop reporting at the first module that throws.
+    exception_ptr error;
+    for (auto& report : reports) {
+        ModuleReports result = report.get_future().get();
+        if (error)
+            continue;
+        cout << result.output << flush;
+        error = result.error;
+        if (error)
+            nextModule = modules.size();
+    }
+
+    for (auto& thread : threads)
+        thread.join();
+    if (error)
+        rethrow_exception(error);
+}
@@ -0,0 +1,17 @@
+#ifndef ANALYSIS_HPP
+#define ANALYSIS_HPP
+
+#include <vector>
+#include <filesystem>
+
+class Module;
+
+// Loads every project module reachable from the entry module through imports and static require()s.
+// Modules are processed breadth-first by that many threads as their parses complete, so the parse workers always have the whole frontier queued.
+void discoverProjectModules(Module& entryModule, const std::filesystem::path& projectDir, unsigned threadsCount);
+
+// Analyzes the modules on that many threads, or in order on this thread if it's 1.
+// Reports are printed in the order of the modules either way. Call this from the thread that created the modules' isolate.
+void analyzeModules(const std::vector<Module*>& modules, unsigned threadsCount);
+
+#endif // ANALYSIS_HPP
@@ -0,0 +1,106 @@
+#include "module/fscache.hpp"
+#include "utils/concurrentmap.hpp"
+#include <unordered_map>
+#include <string>
+
+using namespace std;
+namespace fs = filesystem;
+
+struct DirectoryListing {
+    unordered_map<string, FileKind> entries;
+};
+
+static FsCacheStats stats;
+static ConcurrentMap<string, DirectoryListing> listings; //< Keyed by absolute normalized path
+static ConcurrentMap<string, fs::path> canonicalPaths;
+
+static const DirectoryListing& getListing(const fs::path& dir)
+{
+    if (DirectoryListing* listing = listings.find(dir))
+        return *listing;
+
+    return listings.getOrCreate(dir, [&] {
+        stats.directoriesListed++;
+        auto listing = make_unique<DirectoryListing>();
+        // The parent's listing tells us if there's anything to list, so we don't try every missing node_modules
+        if (cachedFileKind(dir) != FileKind::Directory)
+            return listing;
+
+        error_code ec;
+        for (fs::directory_iterator it(dir, ec), end; !ec && it != end; it.increment(ec)) {
+            // The entry usually knows its type from readdir, so this only stats symlinks
+            error_code entryEc;
+            FileKind kind = FileKind::None;
+            if (it->is_regular_file(entryEc))
+                kind = FileKind::File;
+            else if (it->is_directory(entryEc))
+                kind = FileKind::Directory;
+            listing->entries.emplace(it->path().filename(), kind);
+        }
+        return listing;
+    });
+}
+
+// Like the OS, and unlike lexically_normal, we don't accept "file/.."
+static bool isDotDotValid(const fs::path& absolutePath)
+{
+    fs::path prefix;
+    for (const fs::path& part : absolutePath) {
+        if (part == ".." && cachedFileKind(prefix) != FileKind::Directory)
+            return false;
+        prefix /= part;
+    }
+    return true;
+}
+
+FileKind cachedFileKind(const fs::path& path)
+{
+    fs::path absolutePath = fs::absolute(path);
+    if (absolutePath.string().find("..") != string::npos && !isDotDotValid(absolutePath))
+        return FileKind::None;
+    fs::path normalized = absolutePath.lexically_normal();
+    fs::path parent = normalized.parent_path();
+    if (!normalized.has_filename()) {
+        // The root, or a path with a trailing slash that must be a directory
+        if (parent == normalized)
+            return FileKind::Directory;
+        return cachedFileKind(parent) == FileKind::Directory ? FileKind::Directory : FileKind::None;
+    }
+
+    stats.lookups++;
+    const DirectoryListing& listing = getListing(parent);
+    auto it = listing.entries.find(normalized.filename());
+    if (it == listing.entries.end() || it->second == FileKind::None) {
+        stats.negativeLookups++;
+        return FileKind::None;
+    }
+    return it->second;
+}
+
+bool cachedIsRegularFile(const fs::path& path)
+{
+    return cachedFileKind(path) == FileKind::File;
+}
+
+bool cachedIsDirectory(const fs::path& path)
+{
+    return cachedFileKind(path) == FileKind::Directory;
+}
+
+fs::path cachedCanonical(const fs::path& path)
+{
+    if (fs::path* canonical = canonicalPaths.find(path)) {
+        stats.canonicalHits++;
+        return *canonical;
+    }
+
+    return canonicalPaths.getOrCreate(path, [&] {
+        stats.canonicalMisses++;
+        return make_unique<fs::path>(fs::canonical(path));
+    });
+}
+
+const FsCacheStats& getFsCacheStatistics()
+{
+    return stats;
+}
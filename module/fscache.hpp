@@ -0,0 +1,32 @@
+#ifndef FSCACHE_HPP
+#define FSCACHE_HPP
+
+#include <filesystem>
+#include <atomic>
+#include <cstdint>
+
+// Memoized filesystem queries for module resolution, safe to use from any thread.
+// Each directory is listed at most once, then lookups of its entries (including missing ones) are answered from the listing.
+// This assumes the files we analyze don't change while we run.
+enum class FileKind : uint8_t {
+    None,
+    File,
+    Directory,
+};
+
+FileKind cachedFileKind(const std::filesystem::path& path); //< Follows symlinks, like fs::status
+bool cachedIsRegularFile(const std::filesystem::path& path);
+bool cachedIsDirectory(const std::filesystem::path& path);
+std::filesystem::path cachedCanonical(const std::filesystem::path& path); //< Throws like fs::canonical if the path doesn't exist
+
+struct FsCacheStats {
+    std::atomic_uint64_t lookups = 0;
+    std::atomic_uint64_t negativeLookups = 0; //< Lookups of paths that don't exist
+    std::atomic_uint64_t directoriesListed = 0; //< Including the empty listings of missing directories
+    std::atomic_uint64_t canonicalHits = 0;
+    std::atomic_uint64_t canonicalMisses = 0;
+};
+
+const FsCacheStats& getFsCacheStatistics();
+
+#endif // FSCACHE_HPP
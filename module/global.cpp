@@ -2,52 +2,78 @@
 #include "v8/isolatewrapper.hpp"
 #include "module/nativemodule.hpp"
 #include "module/moduleresolver.hpp"
-#include <unordered_map>
+#include <vector>
 #include <string>
 
 using namespace std;
 using namespace v8;
 
-Local<Context> prepareGlobalContext(IsolateWrapper& isolateWrapper)
+// Exports of every native module, generated once. Only used with the isolate locked.
+static vector<unique_ptr<Persistent<Object>>> nativeExports;
+static size_t bufferModuleIndex;
+
+static void getNativeExports(Local<Name>, const PropertyCallbackInfo<Value>& info)
+{
+    auto index = static_cast<size_t>(info.Data().As<Integer>()->Value());
+    info.GetReturnValue().Set(nativeExports[index]->Get(info.GetIsolate()));
+}
+
+// Buffer is the only global class that Node injects...
+// (yes, even though it's also available through the global buffer.Buffer)
+static void getBufferClass(Local<Name> name, const PropertyCallbackInfo<Value>& info)
+{
+    Isolate* isolate = info.GetIsolate();
+    Local<Object> bufferExports = nativeExports[bufferModuleIndex]->Get(isolate);
+    info.GetReturnValue().Set(bufferExports->Get(isolate->GetCurrentContext(), name).ToLocalChecked());
+}
+
+// Every module context is instantiated from this template, so we don't set each native module on each global.
+// Templates can't hold objects, so the native modules are lazy data properties: the first read in a context
+// calls the getter, then the value is stored in the global like a normal property.
+static Local<ObjectTemplate> getGlobalTemplate(IsolateWrapper& isolateWrapper)
 {
     Isolate* isolate = *isolateWrapper;
-    Isolate::Scope isolateScope(isolate);
     EscapableHandleScope handleScope(isolate);
 
-    static unordered_map<string, unique_ptr<v8::Persistent<v8::Object>>> persistentNativeExports;
+    static Persistent<ObjectTemplate> persistentGlobalTemplate;
+    if (!persistentGlobalTemplate.IsEmpty())
+        return handleScope.Escape(persistentGlobalTemplate.Get(isolate));
 
-    if (persistentNativeExports.empty()) {
-        // Generate all native module exports once
-        vector nativeModules = NativeModule::getNativeModuleNames();
-        for (string name : nativeModules) {
-            NativeModule mod(isolateWrapper, name);
-            Local<Object> exports = mod.getExports();
-            persistentNativeExports.insert({name, make_unique<Persistent<Object>>(isolate, exports)});
-        }
+    // Generate all native module exports once
+    Local<ObjectTemplate> globalTemplate = ObjectTemplate::New(isolate);
+    vector nativeModules = NativeModule::getNativeModuleNames();
+    for (string name : nativeModules) {
+        NativeModule mod(isolateWrapper, name);
+        if (name == "buffer")
+            bufferModuleIndex = nativeExports.size();
+        globalTemplate->SetLazyDataProperty(String::NewFromUtf8(isolate, name.c_str()), getNativeExports,
+                                            Integer::NewFromUnsigned(isolate, static_cast<uint32_t>(nativeExports.size())));
+        nativeExports.push_back(make_unique<Persistent<Object>>(isolate, mod.getExports()));
     }
+    globalTemplate->SetLazyDataProperty(String::NewFromUtf8(isolate, "Buffer"), getBufferClass);
 
-    Local<ObjectTemplate> globalTemplate = ObjectTemplate::New(isolate);
-    Local<Context> context = Context::New(isolate, {}, globalTemplate);
+    persistentGlobalTemplate.Reset(isolate, globalTemplate);
+    return handleScope.Escape(globalTemplate);
+}
+
+Local<Context> prepareGlobalContext(IsolateWrapper& isolateWrapper)
+{
+    Isolate* isolate = *isolateWrapper;
+    Isolate::Scope isolateScope(isolate);
+    EscapableHandleScope handleScope(isolate);
+
+    Local<Context> context = Context::New(isolate, {}, getGlobalTemplate(isolateWrapper));
     Context::Scope contextScope(context);
     Local<Object> global = context->Global();
 
     global->Set(String::NewFromUtf8(isolate, "global"), global);
 
-    // Set up exports and module.exports
+    // Set up exports and module.exports, they must be the same object so it can't come from the template
     Local<Object> exportsObj = Object::New(isolate);
     Local<Object> moduleObj = Object::New(isolate);
     moduleObj->Set(String::NewFromUtf8(isolate, "exports"), exportsObj);
     global->Set(String::NewFromUtf8(isolate, "exports"), exportsObj);
     global->Set(String::NewFromUtf8(isolate, "module"), moduleObj);
 
-    // Add all native modules into global
-    for (const auto& elem : persistentNativeExports)
-        global->Set(String::NewFromUtf8(isolate, elem.first.c_str()), elem.second->Get(isolate));
-
-    // Load Buffer, the only global class that Node injects...
-    // (yes, even though it's also available through the global buffer.Buffer)
-    auto bufferClassStr = String::NewFromUtf8(isolate, "Buffer");
-    global->Set(bufferClassStr, global->Get(String::NewFromUtf8(isolate, "buffer")).As<Object>()->Get(bufferClassStr));
-
     return handleScope.Escape(context);
 }
@@ -0,0 +1,104 @@
+#include "module/manifest.hpp"
+#include "utils/concurrentmap.hpp"
+#include "utils/utils.hpp"
+#include <json.hpp>
+#include <stdexcept>
+
+using namespace std;
+namespace fs = filesystem;
+using json = nlohmann::json;
+
+static ConcurrentMap<string, PackageManifest> manifests; //< Keyed by path and mtime
+
+// Picks the top-level fields we want out of the parser's events, without building a DOM.
+// Returning false stops the parse, which we do as soon as we have everything.
+class ManifestExtractor
+{
+public:
+    explicit ManifestExtractor(PackageManifest& manifest) : manifest{manifest} {}
+
+    bool isDone() const { return done; }
+    const std::string& getError() const { return errorMessage; }
+
+    bool null() { return value(); }
+    bool boolean(bool) { return value(); }
+    bool number_integer(json::number_integer_t) { return value(); }
+    bool number_unsigned(json::number_unsigned_t) { return value(); }
+    bool number_float(json::number_float_t, const std::string&) { return value(); }
+    template <class Binary>
+    bool binary(Binary&) { return value(); }
+    bool string(std::string& str)
+    {
+        if (depth == 1) {
+            if (currentKey == Key::Main)
+                manifest.main = str;
+            else if (currentKey == Key::Module)
+                manifest.module = str;
+            foundKeys |= currentKey;
+        }
+        if (foundKeys == (Key::Main | Key::Module))
+            done = true;
+        return value();
+    }
+
+    bool start_object(size_t) { return start(); }
+    bool end_object() { return end(); }
+    bool start_array(size_t) { return start(); }
+    bool end_array() { return end(); }
+    bool key(std::string& key)
+    {
+        if (depth == 1)
+            currentKey = key == "main" ? Key::Main : key == "module" ? Key::Module : Key::None;
+        return true;
+    }
+
+    template <class Exception>
+    bool parse_error(size_t, const std::string&, const Exception& e)
+    {
+        errorMessage = e.what();
+        return false;
+    }
+
+private:
+    enum Key : unsigned { None = 0, Main = 1, Module = 2 };
+
+    bool value()
+    {
+        if (depth == 1)
+            currentKey = Key::None;
+        return !done;
+    }
+    bool start()
+    {
+        depth++;
+        return true;
+    }
+    bool end()
+    {
+        depth--;
+        return value();
+    }
+
+    PackageManifest& manifest;
+    unsigned depth = 0;
+    Key currentKey = Key::None;
+    unsigned foundKeys = Key::None;
+    bool done = false;
+    std::string errorMessage;
+};
+
+const PackageManifest& getPackageManifest(const fs::path& packageFilePath)
+{
+    auto mtime = fs::last_write_time(packageFilePath).time_since_epoch().count();
+    string key = packageFilePath.string() + '\0' + to_string(mtime);
+    if (PackageManifest* manifest = manifests.find(key))
+        return *manifest;
+
+    return manifests.getOrCreate(key, [&] {
+        auto manifest = make_unique<PackageManifest>();
+        ManifestExtractor extractor(*manifest);
+        if (!json::sax_parse(readFileStr(packageFilePath.c_str()), &extractor) && !extractor.isDone())
+            throw runtime_error("Failed to parse "+packageFilePath.string()+": "+extractor.getError());
+        return manifest;
+    });
+}
@@ -0,0 +1,17 @@
+#ifndef MANIFEST_HPP
+#define MANIFEST_HPP
+
+#include <filesystem>
+#include <string>
+
+// The fields of a package.json that module resolution cares about, the rest is never stored
+struct PackageManifest {
+    std::string main;
+    std::string module; //< ES module entry point, used by bundlers
+};
+
+// Parses each manifest once per path and modification time, safe to call from any thread.
+// Throws if the file can't be read or isn't valid JSON.
+const PackageManifest& getPackageManifest(const std::filesystem::path& packageFilePath);
+
+#endif // MANIFEST_HPP
@@ -1,32 +1,36 @@
 #include "module.hpp"
 #include "ast/ast.hpp"
 #include "ast/parse.hpp"
-#include "ast/walk.hpp"
 #include "analyze/identresolution.hpp"
 #include "analyze/unused.hpp"
 #include "analyze/conditionals.hpp"
 #include "analyze/typecheck.hpp"
 #include "passes/function/list.hpp"
 #include "graph/graph.hpp"
-#include "graph/graphbuilder.hpp"
 #include "transform/flow.hpp"
 #include "global.hpp"
 #include "moduleresolver.hpp"
 #include "utils/reporting.hpp"
 #include "utils/utils.hpp"
+#include "utils/hash.hpp"
+#include "analyze/astqueries.hpp"
 #include <limits>
 #include <cassert>
+#include <thread>
 #include <v8.h>
 
 using namespace std;
 namespace fs = filesystem;
 
+// Compiling a module from a code cache needs UnboundModuleScript, which V8 added in 7.4
+#define V8_HAS_MODULE_CODE_CACHE (V8_MAJOR_VERSION > 7 || (V8_MAJOR_VERSION == 7 && V8_MINOR_VERSION >= 4))
+
 Module::Module(IsolateWrapper& isolateWrapper, fs::path path)
     : BasicModule(isolateWrapper)
     , path{ path }
 {
     originalSource = readFileStr(path.c_str());
-    astFuture = parseSourceScriptAsync(*this, originalSource);
+    pendingAst = parseSourceScriptAsync(*this, originalSource);
 
     v8::Isolate::Scope isolateScope(isolate);
     v8::HandleScope handleScope(isolate);
@@ -40,26 +44,30 @@ Module::Module(IsolateWrapper& isolateWrapper, fs::path path)
 
 AstRoot& Module::getAst()
 {
-    if (!ast) {
-        assert(astFuture.valid());
-        ast.reset(astFuture.get());
-    }
+    call_once(astFlag, [this]{
+        assert(pendingAst.valid());
+        ast.reset(pendingAst.get());
+        trace("Parse of module "+path.string()+" waited "+to_string(pendingAst.getQueueWaitTime().count() / 1000)+"us in the queue");
+    });
 
     return *ast;
 }
 
-void Module::analyze()
+void Module::analyze(unsigned graphThreadsCount)
 {
     resolveLocalIdentifiers();
     resolveLocalXRefs();
     resolveImportedIdentifiers();
+    buildFunctionGraphs(graphThreadsCount);
     runTypechecks(*this);
 
-    for (const auto& funGraph : functionGraphs) {
-        if (!funGraph.second)
+    // Other modules' analyses may be adding graphs concurrently, so don't iterate the map
+    for (AstNode* fun : findFunctionNodes(getAst())) {
+        shared_ptr<Graph> graph = getFunctionGraph((Function&)*fun);
+        if (!graph)
             continue;
         for (auto pass : functionPassList)
-            pass(*this, *funGraph.second);
+            pass(*this, *graph);
     }
 
     findUnusedLocalDeclarations(*this);
@@ -70,9 +78,13 @@ void Module::resolveLocalIdentifiers()
 {
     using namespace v8;
 
-    if (localIdentifierResolutionDone)
+    if (localIdentifierResolutionDone.load(memory_order_acquire))
         return;
-    localIdentifierResolutionDone = true;
+    // The isolate lock is recursive, the started flag stops us from recursing into our own resolution
+    Locker locker(isolate);
+    if (localIdentifierResolutionStarted)
+        return;
+    localIdentifierResolutionStarted = true;
 
     trace("Resolving local identifiers for module "+path.string());
     Isolate::Scope isolateScope(isolate);
@@ -97,18 +109,17 @@ void Module::resolveLocalIdentifiers()
         Module& importedModule = reinterpret_cast<Module&>(ModuleResolver::getModule(*this, *importNameStr, true));
         missingContextIdentifiers.insert(missingContextIdentifiers.end(), importedModule.missingContextIdentifiers.begin(), importedModule.missingContextIdentifiers.end());
     }
+    localIdentifierResolutionDone.store(true, memory_order_release);
 }
 
 void Module::resolveLocalXRefs()
 {
-    if (localXRefsDone)
-        return;
-    localXRefsDone = true;
-
-    for (auto idToDecl : getResolvedLocalIdentifiers()) {
-        auto& usages = localXRefs[idToDecl.second];
-        usages.push_back(idToDecl.first);
-    }
+    call_once(localXRefsFlag, [this]{
+        for (auto idToDecl : getResolvedLocalIdentifiers()) {
+            auto& usages = localXRefs[idToDecl.second];
+            usages.push_back(idToDecl.first);
+        }
+    });
 }
 
 void Module::resolveImportedIdentifiers()
@@ -119,16 +130,8 @@ void Module::resolveImportedIdentifiers()
         return;
     importedIdentifierResolutionDone = true;
 
-    walkAst(getAst(), [&](AstNode& node){
-        resolveImportedIdentifierDeclaration(node);
-    }, [&](AstNode& node) {
-        if (node.getType() == AstNodeType::ImportDeclaration)
-            return WalkDecision::SkipInto;
-        else if (node.getType() == AstNodeType::ImportSpecifier || node.getType() == AstNodeType::ImportDefaultSpecifier)
-            return WalkDecision::WalkInto;
-        else
-            return WalkDecision::SkipOver;
-    });
+    for (AstNode* specifier : getAst().getNodesOfTypes({AstNodeType::ImportSpecifier, AstNodeType::ImportDefaultSpecifier}))
+        resolveImportedIdentifierDeclaration(*specifier);
 }
 
 v8::Local<v8::Module> Module::compileModuleFromSource(const string& filename, const string& source)
@@ -154,12 +157,36 @@ v8::Local<v8::Module> Module::compileModuleFromSource(const string& filename, co
         False(isolate),
         True(isolate));
 
+#if V8_HAS_MODULE_CODE_CACHE
+    // The code cache only depends on the source and the V8 build, so the same thunk or file shares it between projects
+    string cacheFileName = "code/" + stableHashHex(source.data(), source.size()) + "_" + to_string(ScriptCompiler::CachedDataVersionTag()) + ".bin";
+    optional<vector<uint8_t>> cachedData = tryReadCacheFile(cacheFileName.c_str());
+    ScriptCompiler::CachedData* moduleCachedData = nullptr; //< Owned by moduleSource, but the buffer stays ours
+    if (cachedData)
+        moduleCachedData = new ScriptCompiler::CachedData(cachedData->data(), static_cast<int>(cachedData->size()));
+    ScriptCompiler::Source moduleSource(sourceStr, origin, moduleCachedData);
+    auto compileOptions = cachedData ? ScriptCompiler::kConsumeCodeCache : ScriptCompiler::kNoCompileOptions;
+    MaybeLocal<v8::Module> maybeModule = ScriptCompiler::CompileModule(isolate, &moduleSource, compileOptions);
+#else
+    // Older V8s can't compile modules from a code cache
     ScriptCompiler::Source moduleSource(sourceStr, origin);
+    MaybeLocal<v8::Module> maybeModule = ScriptCompiler::CompileModule(isolate, &moduleSource);
+#endif
     Local<v8::Module> module;
-    if (!ScriptCompiler::CompileModule(isolate, &moduleSource).ToLocal(&module)) {
+    if (!maybeModule.ToLocal(&module)) {
         reportV8Exception(isolate, &trycatch);
         throw runtime_error("Failed to compile module");
     }
+
+#if V8_HAS_MODULE_CODE_CACHE
+    if (cachedData && moduleSource.GetCachedData()->rejected)
+        trace("Invalidating code cache for "+filename);
+    if (!cachedData || moduleSource.GetCachedData()->rejected) {
+        unique_ptr<ScriptCompiler::CachedData> newCachedData{ScriptCompiler::CreateCodeCache(module->GetUnboundModuleScript())};
+        if (newCachedData)
+            tryWriteCacheFile(cacheFileName.c_str(), vector<uint8_t>(newCachedData->data, newCachedData->data + newCachedData->length));
+    }
+#endif
     return handleScope.Escape(module);
 }
 
@@ -210,13 +237,20 @@ v8::Local<v8::Module> Module::getExecutableES6Module()
         auto thunkSource = "const _m=require('"s+path.c_str()+"');export default _m;\n";
         string exportsStr;
 
-        auto exports = getExports();
-        auto exportedProps = exports->GetOwnPropertyNames(context).ToLocalChecked();
-        //cout << "Got "<<exportedProps->Length()<<" properties"<<endl;
-        for (uint32_t i=0; i<exportedProps->Length(); ++i) {
-            auto nameStr = std::string(*v8::String::Utf8Value(isolate, exportedProps->Get(i).As<String>()));
-            //cout <<nameStr<<endl;
+        // Running the module is slow and can have side effects, so we only do it if the AST doesn't tell us the exports
+        vector<string> exportNames;
+        if (findCommonJsExports(getAst(), exportNames)) {
+            trace("Found the exports of module "+path.string()+" statically");
+        } else {
+            trace("Evaluating module "+path.string()+" to find its exports");
+            auto exports = getExports();
+            auto exportedProps = exports->GetOwnPropertyNames(context).ToLocalChecked();
+            for (uint32_t i=0; i<exportedProps->Length(); ++i)
+                exportNames.push_back(*v8::String::Utf8Value(isolate, exportedProps->Get(i).As<String>()));
+        }
 
+        for (size_t i=0; i<exportNames.size(); ++i) {
+            const string& nameStr = exportNames[i];
             string tmpName = "_"+to_string(i);
             thunkSource += "const "+tmpName+"=_m."+nameStr+";";
             exportsStr += tmpName +" as "+nameStr+",";
@@ -229,25 +263,59 @@ v8::Local<v8::Module> Module::getExecutableES6Module()
     return handleScope.Escape(compiledThunkModule.Get(isolate));
 }
 
-Graph *Module::getFunctionGraph(Function &fun)
+shared_ptr<Graph> Module::getFunctionGraph(Function &fun)
+{
+    CachedGraph* cachedGraph = functionGraphs.find(&fun);
+    if (!cachedGraph)
+        cachedGraph = &functionGraphs.getOrCreate(&fun, [] { return make_unique<CachedGraph>(); });
+    return cachedGraph->get(fun);
+}
+
+void Module::buildFunctionGraphs(unsigned threadsCount)
 {
-    auto it = functionGraphs.find(&fun);
-    if (it != functionGraphs.end())
-        return it->second.get();
-
-    GraphBuilder builder(fun);
-    try {
-        const auto& result = functionGraphs.insert({&fun, builder.buildFromAst()});
-        return result.first->second.get();
-    } catch (const runtime_error& e) {
-        trace(fun, "Failed to build function graph: "s+e.what());
-        functionGraphs.insert({&fun, nullptr});
-        return nullptr;
+    vector<AstNode*> funs = findFunctionNodes(getAst());
+    threadsCount = static_cast<unsigned>(min<size_t>(threadsCount, funs.size()));
+    if (threadsCount <= 1) {
+        for (AstNode* fun : funs)
+            getFunctionGraph((Function&)*fun);
+        return;
+    }
+
+    // Graph builders only read our resolved identifiers and scope chain, the rest of the resolution needs V8
+    resolveLocalIdentifiers();
+
+    vector<string> reports(funs.size());
+    vector<exception_ptr> errors(funs.size());
+    atomic_size_t nextFunction = 0;
+    auto buildNextGraphs = [&] {
+        for (size_t i; (i = nextFunction++) < funs.size();) {
+            BufferedReports buffer;
+            try {
+                getFunctionGraph((Function&)*funs[i]);
+            } catch (...) {
+                errors[i] = current_exception();
+                nextFunction = funs.size();
+            }
+            reports[i] = buffer.take();
+        }
+    };
+
+    vector<thread> threads;
+    for (unsigned i = 0; i < threadsCount; ++i)
+        threads.emplace_back(buildNextGraphs);
+    for (auto& thread : threads)
+        thread.join();
+
+    for (size_t i = 0; i < funs.size(); ++i) {
+        printReports(reports[i]);
+        if (errors[i])
+            rethrow_exception(errors[i]);
     }
 }
 
 shared_ptr<ClassTypeInfo> Module::getClassExtraTypeInfo(Class &c)
 {
+    lock_guard lock(classExtraTypeInfosMutex);
     auto it = classExtraTypeInfos.find(&c);
     if (it != classExtraTypeInfos.end())
         return it->second;
@@ -265,6 +333,12 @@ const string &Module::getOriginalSource() const
     return originalSource;
 }
 
+const LineTable& Module::getLineTable() const
+{
+    call_once(lineTableFlag, [this]{ lineTable = make_unique<LineTable>(originalSource); });
+    return *lineTable;
+}
+
 string Module::getPath() const
 {
     return path;
@@ -337,70 +411,54 @@ bool Module::isES6Module()
     return false;
 }
 
-void Module::resolveProjectImports(const fs::path& projectDir)
+vector<Module*> Module::findProjectImports(const fs::path& projectDir)
 {
-    using namespace v8;
-
-    if (importsResolved)
-        return;
-    importsResolved = true;
-
     trace("Resolving imports of module "+path.string());
 
-    Isolate::Scope isolateScope(isolate);
-    HandleScope handleScope(isolate);
-
-    vector<Module*> modulesToResolve;
+    vector<Module*> imports;
 
-    // Resolve ES6 imports
-    auto module = getCompiledModule();
-    for (int i=0; i<module->GetModuleRequestsLength(); ++i) {
-        auto importName = module->GetModuleRequest(i);
-        String::Utf8Value importNameStr(isolate, importName);
-        if (NativeModule::hasModule(*importNameStr))
+    // Resolve ES6 imports, straight from the AST so we don't have to compile the module
+    for (const string& importName : findModuleRequests(getAst())) {
+        if (NativeModule::hasModule(importName))
             continue;
-        if (ModuleResolver::isProjectModule(projectDir, getPath(), *importNameStr)) {
-            Module& importedModule = reinterpret_cast<Module&>(ModuleResolver::getModule(*this, *importNameStr, false));
-            modulesToResolve.push_back(&importedModule);
+        if (ModuleResolver::isProjectModule(projectDir, getPath(), importName)) {
+            Module& importedModule = reinterpret_cast<Module&>(ModuleResolver::getModule(*this, importName, false));
+            imports.push_back(&importedModule);
         }
     }
 
     // Resolve imports through require() calls
     // TODO: We only resolve require calls taking a literal now, we should try to get possibly values if it takes an identifier!
     // For example if there's an if/else assigning a variable, and we import that variable, at some point we should aim to resolve that!
-    walkAst(getAst(), [&](AstNode& node){
-        auto parent = (CallExpression*)node.getParent();
-        const auto& args = parent->getArguments();
+    for (AstNode* node : getAst().getNodesOfType(AstNodeType::CallExpression)) {
+        auto call = (CallExpression*)node;
+        if (call->getCallee()->getType() != AstNodeType::Identifier)
+            continue;
+        auto callee = (Identifier*)call->getCallee();
+        if (callee->getName() != "require" || resolvedLocalIdentifiers.find(callee) != resolvedLocalIdentifiers.end())
+            continue;
+        const auto& args = call->getArguments();
         if (args.size() < 1 || args[0]->getType() != AstNodeType::StringLiteral)
-            return;
+            continue;
         auto arg = ((StringLiteral*)args[0])->getValue();
 
         // TODO: v8 gives parse errors if we import a .json directly, we need to autogenerate a wrapper of some sort for json modules
         // (This shows again that JSON is not JS!)
         if (fs::path(arg).extension() == ".json")
-            return;
+            continue;
 
         if (NativeModule::hasModule(arg))
-            return;
+            continue;
         try {
             if (ModuleResolver::isProjectModule(projectDir, getPath(), arg)) {
                 Module& importedModule = reinterpret_cast<Module&>(ModuleResolver::getModule(*this, arg, false));
-                modulesToResolve.push_back(&importedModule);
+                imports.push_back(&importedModule);
             }
         } catch (std::runtime_error&) {
             // This is fine. We're trying to resolve every require() everywhere,
             // not just those reachable from the global scope, so some are expected to fail...
         }
-    }, [&](AstNode& node) {
-        if (node.getType() != AstNodeType::Identifier
-                || node.getParent()->getType() != AstNodeType::CallExpression)
-            return WalkDecision::SkipInto;
-        auto& id = (Identifier&)node;
-        if (id.getName() == "require" && resolvedLocalIdentifiers.find(&id) == resolvedLocalIdentifiers.end())
-            return WalkDecision::WalkInto;
-        return WalkDecision::SkipInto;
-    });
+    }
 
-    for (auto module : modulesToResolve)
-        module->resolveProjectImports(projectDir);
+    return imports;
 }
@@ -5,10 +5,16 @@
 #include <string>
 #include <unordered_map>
 #include <future>
+#include <mutex>
+#include <atomic>
 #include <v8.h>
 #include "basicmodule.hpp"
+#include "ast/parse.hpp"
+#include "ast/location.hpp"
 #include "analyze/identresolution.hpp"
 #include "graph/graph.hpp"
+#include "graph/graphcache.hpp"
+#include "utils/concurrentmap.hpp"
 
 class IsolateWrapper;
 class AstRoot;
@@ -19,16 +25,24 @@ class Function;
 class Module final : public BasicModule {
 public:
     Module(IsolateWrapper& isolateWrapper, std::filesystem::path path);
-    // This instantiates modules recursively imported or statically require()'d by this one if they are part of the project
-    void resolveProjectImports(const std::filesystem::path &projectDir);
-    void analyze(); //< Performs analysis and reports result to the user
+    // Loads the modules imported or statically require()'d by this one if they are part of the project, and returns them.
+    // Their parses start right away, see discoverProjectModules to load the whole project.
+    std::vector<Module*> findProjectImports(const std::filesystem::path &projectDir);
+    // Performs analysis and reports result to the user. Different modules can be analyzed in parallel.
+    // The function graphs are built on graphThreadsCount threads, see buildFunctionGraphs.
+    void analyze(unsigned graphThreadsCount = 1);
     AstRoot& getAst();
     v8::Local<v8::Module> getExecutableModule();
     v8::Local<v8::Module> getExecutableES6Module();
-    Graph* getFunctionGraph(Function& fun); // May return nullptr if the graph could not be built!
+    // May return nullptr if the graph could not be built! Hold on to the graph while using it, idle graphs can be evicted.
+    std::shared_ptr<Graph> getFunctionGraph(Function& fun);
+    // Builds the graphs of all our functions on that many threads, so getFunctionGraph returns them right away.
+    // Reports are printed in the order of the functions, like when building them one at a time.
+    void buildFunctionGraphs(unsigned threadsCount);
     std::shared_ptr<ClassTypeInfo> getClassExtraTypeInfo(Class& c);
     int getCompiledModuleIdentityHash();
     const std::string& getOriginalSource() const;
+    const LineTable& getLineTable() const; //< Built on first use, for line/column positions in the original source
     virtual std::string getPath() const override;
 
     const std::unordered_map<Identifier*, std::vector<Identifier*>>& getLocalXRefs();
@@ -53,24 +67,29 @@ private:
 private:
     std::filesystem::path path;
     std::string originalSource;
-    std::future<AstRoot*> astFuture;
+    mutable std::once_flag lineTableFlag;
+    mutable std::unique_ptr<LineTable> lineTable;
+    PendingAst pendingAst;
+    std::once_flag astFlag;
     std::unique_ptr<AstRoot> ast;
     v8::Persistent<v8::Module> compiledModule;
     v8::Persistent<v8::Module> compiledThunkModule; //< ES6 thunk generated if this module doesn't use ES6 import/exports
     std::vector<std::string> missingContextIdentifiers;
 
-    std::unordered_map<Function*, std::unique_ptr<Graph>> functionGraphs;
+    // Analyses of other modules can look at our functions and classes, so these are locked
+    ConcurrentMap<Function*, CachedGraph> functionGraphs; //< Graphs of different functions are built concurrently
+    std::mutex classExtraTypeInfosMutex;
     std::unordered_map<Class*, std::shared_ptr<ClassTypeInfo>> classExtraTypeInfos;
 
     std::unordered_map<Identifier*, Identifier*> resolvedLocalIdentifiers; //< Maps identifiers to their local declaration
     std::unordered_map<ImportSpecifier*, Identifier*> resolvedImportedIdentifiers; //< Maps named imports to their declaration in the imported module
     std::unordered_map<Identifier*, std::vector<Identifier*>> localXRefs; //< Maps local declarations to their previously resolved uses
     std::unique_ptr<LexicalBindings> scopeChain; //< The scope chain maps bound names to their declaration in each lexical scope
-    bool localIdentifierResolutionDone = false; //< True after we've run the identifiers resolution pass
-    bool importedIdentifierResolutionDone = false; //< True after we're run the imported identifiers resolution pass
-    bool localXRefsDone = false;
-
-    bool importsResolved = false; //< Breaks cycles when manually instantiating all imports
+    // Local identifier resolution needs V8, it runs with the isolate locked
+    bool localIdentifierResolutionStarted = false;
+    std::atomic_bool localIdentifierResolutionDone = false; //< True after we've run the identifiers resolution pass
+    bool importedIdentifierResolutionDone = false; //< True after we're run the imported identifiers resolution pass. Only done by our own analysis.
+    std::once_flag localXRefsFlag;
 };
 
 #endif // MODULE_HPP
@@ -1,20 +1,23 @@
 #include "moduleresolver.hpp"
+#include "fscache.hpp"
+#include "manifest.hpp"
 #include "ast/ast.hpp"
 #include "v8/isolatewrapper.hpp"
 #include "utils/utils.hpp"
 #include "utils/reporting.hpp"
 #include "analyze/identresolution.hpp"
 #include <filesystem>
-#include <json.hpp>
+#include <algorithm>
 #include <v8.h>
 
 using namespace std;
 namespace fs = filesystem;
-using json = nlohmann::json;
 
-unordered_map<std::string, NativeModule> ModuleResolver::nativeModuleMap;
-unordered_map<std::string, Module> ModuleResolver::moduleMap;
+ConcurrentMap<std::string, NativeModule> ModuleResolver::nativeModuleMap;
+ConcurrentMap<std::string, Module> ModuleResolver::moduleMap;
 unordered_map<int, Module&> ModuleResolver::compiledModuleMap;
+ConcurrentMap<std::string, fs::path> ModuleResolver::resolutionCache;
+ModuleResolver::ResolutionStats ModuleResolver::resolutionStats;
 
 BasicModule& ModuleResolver::getModule(const BasicModule& from, string requestedName, bool isImport)
 {
@@ -24,7 +27,7 @@ BasicModule& ModuleResolver::getModule(const BasicModule& from, string requested
 BasicModule& ModuleResolver::getModule(IsolateWrapper& isolateWrapper, std::filesystem::path basePath, std::string requestedName, bool isImport)
 {
     if (!isImport && NativeModule::hasModule(requestedName))
-        return nativeModuleMap.try_emplace(requestedName, isolateWrapper, requestedName).first->second;
+        return getNativeModule(isolateWrapper, requestedName);
 
     if (basePath == "<builtin>") {
         throw runtime_error("Trying to import a non-native module from a builtin native module!");
@@ -34,9 +37,35 @@ BasicModule& ModuleResolver::getModule(IsolateWrapper& isolateWrapper, std::file
     if (fullPath.empty())
         throw runtime_error("Cannot find module " + requestedName + " imported from " + basePath.c_str());
 
+    fullPath = cachedCanonical(fullPath);
+    if (Module* module = moduleMap.find(fullPath))
+        return *module;
+
+    // Constructing a module needs V8. We always lock the isolate first, so a thread that already holds it
+    // (e.g. while evaluating an import) never waits for another thread's construction that is waiting for the isolate.
+    // Parallel analyses can get here from other threads, which haven't entered the default context.
+    v8::Locker locker(*isolateWrapper);
+    v8::Isolate::Scope isolateScope(*isolateWrapper);
+    v8::HandleScope scope(*isolateWrapper);
+    v8::Context::Scope contextScope(isolateWrapper.getDefaultContext());
+    return moduleMap.getOrCreate(fullPath, [&] {
+        return make_unique<Module>(isolateWrapper, fullPath);
+    });
+}
+
+NativeModule& ModuleResolver::getNativeModule(IsolateWrapper& isolateWrapper, const string& name)
+{
+    if (NativeModule* module = nativeModuleMap.find(name))
+        return *module;
+
+    // Same locking as for other modules in getModule
+    v8::Locker locker(*isolateWrapper);
+    v8::Isolate::Scope isolateScope(*isolateWrapper);
     v8::HandleScope scope(*isolateWrapper);
-    fullPath = fs::canonical(fullPath);
-    return moduleMap.try_emplace(fullPath, isolateWrapper, fullPath).first->second;
+    v8::Context::Scope contextScope(isolateWrapper.getDefaultContext());
+    return nativeModuleMap.getOrCreate(name, [&] {
+        return make_unique<NativeModule>(isolateWrapper, name);
+    });
 }
 
 fs::path ModuleResolver::getProjectMainFile(fs::path projectDir)
@@ -49,7 +78,8 @@ fs::path ModuleResolver::getProjectMainFile(fs::path projectDir)
 
 bool ModuleResolver::isProjectModule(fs::path projectDir, fs::path filePath)
 {
-    fs::path relative = std::filesystem::relative(filePath, projectDir);
+    // Both exist, and their canonical paths are memoized, unlike fs::relative's
+    fs::path relative = cachedCanonical(filePath).lexically_relative(cachedCanonical(projectDir));
     return relative.begin()->string() != ".."
             && relative.string().find("node_modules") == string::npos;
 }
@@ -68,12 +98,14 @@ bool ModuleResolver::isProjectModule(fs::path projectDir, fs::path basePath, str
 std::vector<Module *> ModuleResolver::getLoadedProjectModules(fs::path projectDir)
 {
     vector<Module*> projectMods;
-    for (auto& elem : moduleMap) {
-        auto& mod = elem.second;
-        if (!isProjectModule(projectDir, mod.getPath()))
-            continue;
-        projectMods.push_back(&mod);
-    }
+    moduleMap.forEach([&](const string&, Module& mod) {
+        if (isProjectModule(projectDir, mod.getPath()))
+            projectMods.push_back(&mod);
+    });
+    // The map's order depends on which thread loaded what first
+    sort(projectMods.begin(), projectMods.end(), [](Module* a, Module* b) {
+        return a->getPath() < b->getPath();
+    });
     return projectMods;
 }
 
@@ -83,11 +115,31 @@ ModuleResolver::ResolveImportCallbackType ModuleResolver::getResolveImportCallba
     return &resolveImportCallback;
 }
 
+const ModuleResolver::ResolutionStats& ModuleResolver::getResolutionStatistics()
+{
+    return resolutionStats;
+}
+
 fs::path ModuleResolver::resolve(fs::path fromPath, string requestedName)
 {
     fs::path basePath = fromPath;
-    if (fs::is_regular_file(fromPath))
+    if (cachedIsRegularFile(fromPath))
             basePath = basePath.remove_filename();
+
+    // Every module in a directory shares the results, and imports of common packages look the same everywhere
+    string key = basePath.string() + '\0' + requestedName;
+    if (fs::path* cached = resolutionCache.find(key)) {
+        resolutionStats.hits++;
+        return *cached;
+    }
+    return resolutionCache.getOrCreate(key, [&] {
+        resolutionStats.misses++;
+        return make_unique<fs::path>(resolveFromDirectory(basePath, requestedName));
+    });
+}
+
+fs::path ModuleResolver::resolveFromDirectory(fs::path basePath, string requestedName)
+{
     fs::path fullPath;
 
     if (requestedName[0] == '/')
@@ -108,7 +160,7 @@ fs::path ModuleResolver::resolve(fs::path fromPath, string requestedName)
 fs::path ModuleResolver::resolveNodeModule(fs::path basePath, string requestedName)
 {
     fs::path modulesDirPath = basePath / "node_modules";
-    if (fs::is_directory(modulesDirPath)) {
+    if (cachedIsDirectory(modulesDirPath)) {
         fs::path modulePath = modulesDirPath / requestedName;
         if (auto fullPath = resolveAsFile(modulePath); !fullPath.empty())
             return fullPath;
@@ -125,9 +177,9 @@ fs::path ModuleResolver::resolveNodeModule(fs::path basePath, string requestedNa
 
 fs::path ModuleResolver::resolveAsFile(fs::path path)
 {
-    if (fs::is_regular_file(path))
+    if (cachedIsRegularFile(path))
         return path;
-    else if (fs::is_regular_file((string)path + ".js"))
+    else if (cachedIsRegularFile((string)path + ".js"))
         return (string)path + ".js";
     else
         return fs::path();
@@ -136,7 +188,7 @@ fs::path ModuleResolver::resolveAsFile(fs::path path)
 fs::path ModuleResolver::resolveAsDirectory(fs::path path)
 {
     fs::path basePath;
-    if (fs::is_regular_file(path / "package.json")) {
+    if (cachedIsRegularFile(path / "package.json")) {
         basePath = path / getNodeModuleMainFile(path / "package.json");
         if (auto path = resolveAsFile(basePath); !path.empty())
             return path;
@@ -144,7 +196,7 @@ fs::path ModuleResolver::resolveAsDirectory(fs::path path)
         basePath = path;
     }
 
-    if (fs::is_regular_file(basePath / "index.js"))
+    if (cachedIsRegularFile(basePath / "index.js"))
         return basePath / "index.js";
     else
         return fs::path();
@@ -152,11 +204,7 @@ fs::path ModuleResolver::resolveAsDirectory(fs::path path)
 
 string ModuleResolver::getNodeModuleMainFile(fs::path packageFilePath)
 {
-    json contents = json::parse(readFileStr(packageFilePath.c_str()));
-    auto it = contents.find("main");
-    if (it == contents.end())
-        return {};
-    return *it;
+    return getPackageManifest(packageFilePath).main;
 }
 
 void ModuleResolver::requireFunction(const v8::FunctionCallbackInfo<v8::Value>& args)
@@ -171,10 +219,12 @@ void ModuleResolver::requireFunction(const v8::FunctionCallbackInfo<v8::Value>&
     v8::String::Utf8Value modulePath(isolate, args.Data());
     trace("require() from "s+*modulePath+" for module \""+*requested+"\"");
 
-    Module& module = moduleMap.at(*modulePath);
+    Module* module = moduleMap.find(*modulePath);
+    if (!module)
+        throw runtime_error("require() called from a module that isn't loaded: "s+*modulePath);
     BasicModule* importedModule;
     try {
-        importedModule = &getModule(module, *requested);
+        importedModule = &getModule(*module, *requested);
     } catch (const std::runtime_error& e) {
         auto errorStr = std::string("Cannot find module '")+*requested+"': "+e.what();
         isolate->ThrowException(v8::Exception::Error(v8::String::NewFromUtf8(isolate, errorStr.c_str())));
@@ -206,7 +256,7 @@ v8::MaybeLocal<v8::Module> ModuleResolver::resolveImportCallback(v8::Local<v8::C
     trace("import from "s+referrerPath+" for module \""+*specifierStr+"\"");
 
     if (NativeModule::hasModule(*specifierStr))
-        return nativeModuleMap.try_emplace(*specifierStr, referrerModule.getIsolateWrapper(), *specifierStr).first->second.getWrapperModule();
+        return getNativeModule(referrerModule.getIsolateWrapper(), *specifierStr).getWrapperModule();
 
     Module& importedModule = reinterpret_cast<Module&>(getModule(referrerModule, *specifierStr, true));
     compiledModuleMap.try_emplace(importedModule.getCompiledModuleIdentityHash(), importedModule);
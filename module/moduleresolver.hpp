@@ -3,6 +3,7 @@
 
 #include "module.hpp"
 #include "nativemodule.hpp"
+#include "utils/concurrentmap.hpp"
 #include <filesystem>
 #include <string>
 #include <v8.h>
@@ -11,31 +12,43 @@ class IsolateWrapper;
 
 class ModuleResolver {
 public:
+    struct ResolutionStats {
+        std::atomic_uint64_t hits = 0;
+        std::atomic_uint64_t misses = 0;
+    };
+
     static BasicModule& getModule(const BasicModule& from, std::string requestedName, bool isImport = false);
     static BasicModule& getModule(IsolateWrapper& isolateWrapper, std::filesystem::path basePath, std::string requestedName, bool isImport = false);
     static std::filesystem::path getProjectMainFile(std::filesystem::path projectDir);
     static bool isProjectModule(std::filesystem::path projectDir, std::filesystem::path filePath);
     static bool isProjectModule(std::filesystem::path projectDir, std::filesystem::path basePath, std::string requestedName);
     static std::vector<Module*> getLoadedProjectModules(std::filesystem::path projectDir);
+    static const ResolutionStats& getResolutionStatistics();
 
     using ResolveImportCallbackType = v8::MaybeLocal<v8::Module>(*)(v8::Local<v8::Context> context, v8::Local<v8::String> specifier, v8::Local<v8::Module> referrer);
     static ResolveImportCallbackType getResolveImportCallback(Module& importingModule);
     static void requireFunction(const v8::FunctionCallbackInfo<v8::Value>& args);
 
 private:
-    static std::filesystem::path resolve(std::filesystem::path fromPath, std::string requestedName);
+    static std::filesystem::path resolve(std::filesystem::path fromPath, std::string requestedName); //< Cached
+    static std::filesystem::path resolveFromDirectory(std::filesystem::path basePath, std::string requestedName);
     static std::filesystem::path resolveAsFile(std::filesystem::path path);
     static std::filesystem::path resolveAsDirectory(std::filesystem::path path);
     static std::filesystem::path resolveNodeModule(std::filesystem::path basePath, std::string requestedName);
     static std::string getNodeModuleMainFile(std::filesystem::path packageFilePath);
     // This must not be called before adding an importing module to the compiledModuleMap!
     static v8::MaybeLocal<v8::Module> resolveImportCallback(v8::Local<v8::Context> context, v8::Local<v8::String> specifier, v8::Local<v8::Module> referrer);
+    static NativeModule& getNativeModule(IsolateWrapper& isolateWrapper, const std::string& name);
 
 private:
-    static std::unordered_map<std::string, NativeModule> nativeModuleMap;
-    static std::unordered_map<std::string, Module> moduleMap;
-    // Maps from the v8 identity hash of a v8 module to our Module class
+    // Keyed by canonical path, so any thread can ask for a module and it is only ever loaded once
+    static ConcurrentMap<std::string, NativeModule> nativeModuleMap;
+    static ConcurrentMap<std::string, Module> moduleMap;
+    // Maps from the v8 identity hash of a v8 module to our Module class. Only accessed with the isolate locked.
     static std::unordered_map<int, Module&> compiledModuleMap;
+    // Maps a base directory and requested name to the resolved path, or an empty path if it wasn't found
+    static ConcurrentMap<std::string, std::filesystem::path> resolutionCache;
+    static ResolutionStats resolutionStats;
 };
 
 #endif // MODULERESOLVER_HPP
@@ -12,7 +12,7 @@ using namespace std;
 
 void missingAwaitFunctionPass(Module &module, Graph& graph)
 {
-    for (uint16_t i=0; i<graph.size(); ++i) {
+    for (GraphNodeIndex i=0; i<graph.size(); ++i) {
         GraphNode& node = graph.getNode(i);
         if (node.getType() != GraphNodeType::Call)
             continue;
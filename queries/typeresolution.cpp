@@ -187,7 +187,7 @@ static TypeInfo resolveCatchType(Graph& graph, const GraphNode* catchNode)
     auto prevCount = catchNode->prevCount();
 
     vector<TypeInfo> types;
-    for (uint16_t i=0; i<prevCount; ++i) {
+    for (size_t i=0; i<prevCount; ++i) {
         GraphNode& node = graph.getNode(catchNode->getPrev(i));
         TypeInfo newType = resolveNodeType(graph, &node);
 
@@ -212,7 +212,7 @@ static TypeInfo resolveCatchType(Graph& graph, const GraphNode* catchNode)
 
 TypeInfo resolveReturnType(Function &fun)
 {
-    Graph* graph = fun.getParentModule().getFunctionGraph(fun);
+    shared_ptr<Graph> graph = fun.getParentModule().getFunctionGraph(fun);
     if (!graph) {
         if (fun.isAsync())
             return TypeInfo::makePromise({});
@@ -222,10 +222,10 @@ TypeInfo resolveReturnType(Function &fun)
     const GraphNode& end = graph->getNode(graph->size()-1);
     if (end.getType() != GraphNodeType::End)
         return {}; // A graph without an End at all is noreturn, that can happen
-    const uint16_t exits = static_cast<uint16_t>(end.prevCount());
+    const size_t exits = end.prevCount();
 
     vector<TypeInfo> types;
-    for (uint16_t i=0; i<exits; ++i) {
+    for (size_t i=0; i<exits; ++i) {
         GraphNode& node = graph->getNode(end.getPrev(i));
         TypeInfo newType;
         if (node.getType() == GraphNodeType::Return) {
@@ -259,8 +259,10 @@ TypeInfo resolveReturnType(Function &fun)
 
 TypeInfo resolveNodeType(Graph& graph, const GraphNode* node)
 {
-    if (auto it = graph.nodeTypes.find(node); it != graph.nodeTypes.end())
-        return it->second;
+    // Resolving a type can resolve the types of other graphs, so the graph's type table is only locked to look it up and store it
+    GraphNodeIndex index = graph.indexOf(*node);
+    if (optional<TypeInfo> knownType = graph.findNodeType(index))
+        return *knownType;
 
     TypeInfo type;
 
@@ -301,7 +303,7 @@ TypeInfo resolveNodeType(Graph& graph, const GraphNode* node)
         std::unordered_map<std::string, TypeInfo> propTypes;
         bool strict = true;
 
-        for (uint16_t i = 0; i<node->inputCount(); ++i) {
+        for (size_t i = 0; i<node->inputCount(); ++i) {
             bool propKeysKnown = true;
 
             auto& input = graph.getNode(node->getInput(i));
@@ -395,5 +397,5 @@ TypeInfo resolveNodeType(Graph& graph, const GraphNode* node)
         type = resolveCatchType(graph, node);
     }
 
-    return graph.nodeTypes.insert(pair{node, move(type)}).first->second;
+    return graph.setNodeType(index, move(type));
 }
@@ -8,9 +8,14 @@
 #include <cstring>
 #include <cassert>
 #include <algorithm>
+#include <mutex>
 
 using namespace std;
 
+// Lazy inits can recurse into each other across modules, so there's one lock for all of them to avoid lock order problems.
+// Once an init is done, reading it doesn't take the lock.
+static recursive_mutex lazyInitMutex;
+
 TypeInfo::TypeInfo()
     : baseType{ BaseType::Unknown }
 {
@@ -92,13 +97,13 @@ TypeInfo::TypeInfo(BaseType baseType, std::shared_ptr<ExtraTypeInfo>&& extra)
 }
 
 FunctionTypeInfo::FunctionTypeInfo(Function& decl)
-    : staticDefinition { &decl }, lazyInitDone{false}
+    : staticDefinition { &decl }, lazyInitStarted{false}, lazyInitDone{false}
 {
     // Actual init is done lazily
 }
 
 FunctionTypeInfo::FunctionTypeInfo(std::vector<TypeInfo> &&argumentTypes, TypeInfo returnType, bool variadic)
-    : staticDefinition { nullptr }, argumentTypes{move(argumentTypes)}, returnType{returnType}, variadic{variadic}, lazyInitDone{true}
+    : staticDefinition { nullptr }, argumentTypes{move(argumentTypes)}, returnType{returnType}, variadic{variadic}, lazyInitStarted{true}, lazyInitDone{true}
 {
     GenericHash gh;
     for (const auto& arg : argumentTypes)
@@ -110,9 +115,12 @@ FunctionTypeInfo::FunctionTypeInfo(std::vector<TypeInfo> &&argumentTypes, TypeIn
 
 FunctionTypeInfo *FunctionTypeInfo::ensureLazyInit()
 {
-    if (lazyInitDone)
+    if (lazyInitDone.load(memory_order_acquire))
+        return this;
+    lock_guard lock(lazyInitMutex);
+    if (lazyInitStarted)
         return this;
-    lazyInitDone = true;
+    lazyInitStarted = true;
 
     if (staticDefinition) {
         for (auto param : staticDefinition->getParams()) {
@@ -146,20 +154,24 @@ FunctionTypeInfo *FunctionTypeInfo::ensureLazyInit()
     gh.update(&variadic, sizeof(variadic));
     gh.final(hash);
 
+    lazyInitDone.store(true, memory_order_release);
     return this;
 }
 
 ClassTypeInfo::ClassTypeInfo(Class &decl)
-    : staticDefinition { &decl }, lazyInitDone{false}
+    : staticDefinition { &decl }, lazyInitStarted{false}, lazyInitDone{false}
 {
     // Actual init is done lazily
 }
 
 ClassTypeInfo *ClassTypeInfo::ensureLazyInit()
 {
-    if (lazyInitDone)
+    if (lazyInitDone.load(memory_order_acquire))
+        return this;
+    lock_guard lock(lazyInitMutex);
+    if (lazyInitStarted)
         return this;
-    lazyInitDone = true;
+    lazyInitStarted = true;
 
     strict = false;
     // TODO: Implement resolution of more static properties
@@ -224,6 +236,7 @@ ClassTypeInfo *ClassTypeInfo::ensureLazyInit()
     gh.update(&strict, sizeof(strict));
     gh.final(hash);
 
+    lazyInitDone.store(true, memory_order_release);
     return this;
 }
 
@@ -4,6 +4,7 @@
 #include <memory>
 #include <vector>
 #include <unordered_map>
+#include <atomic>
 #include "utils/hash.hpp"
 
 class AstNode;
@@ -105,7 +106,8 @@ struct FunctionTypeInfo : public ExtraTypeInfo
     bool variadic;
 
 private:
-    bool lazyInitDone;
+    bool lazyInitStarted; //< Guarded by the lazy init lock, a recursive call during init sees a partial result
+    std::atomic_bool lazyInitDone;
 };
 
 struct ClassTypeInfo : public ExtraTypeInfo
@@ -119,7 +121,8 @@ struct ClassTypeInfo : public ExtraTypeInfo
     bool strict; // If false, the object value may have extra properties not described in the type
 
 private:
-    bool lazyInitDone;
+    bool lazyInitStarted; //< Guarded by the lazy init lock, a recursive call during init sees a partial result
+    std::atomic_bool lazyInitDone;
 };
 
 struct PromiseTypeInfo : public ExtraTypeInfo
@@ -0,0 +1,3 @@
+// exports unknown
+const key = 'a';
+module.exports = { [key]: 1 };
@@ -0,0 +1,4 @@
+// exports unknown
+exports.a = 1;
+if (process.env.EXTRA)
+    exports.b = 2;
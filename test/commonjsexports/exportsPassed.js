@@ -0,0 +1,3 @@
+// exports unknown
+exports.a = 1;
+Object.assign(exports, { b: 2 });
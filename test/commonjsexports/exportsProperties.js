@@ -0,0 +1,4 @@
+// exports x y z
+module.exports.x = 1;
+module.exports['y'] = 2;
+exports.z = 3;
@@ -0,0 +1,6 @@
+// exports before a
+// Assigning module.exports replaces everything exported so far, and leaves exports pointing to the old object
+exports.ignored = 0;
+module.exports = { before: 1 };
+exports.after = 2;
+module.exports.a = 3;
@@ -0,0 +1,8 @@
+// exports a b-c d e
+const e = 3;
+module.exports = {
+    a: 1,
+    'b-c': 2,
+    d() {},
+    e,
+};
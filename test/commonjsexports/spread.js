@@ -0,0 +1,3 @@
+// exports unknown
+const other = { a: 1 };
+module.exports = { b: 2, ...other };
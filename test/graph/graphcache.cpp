@@ -0,0 +1,83 @@
+#include <catch.hpp>
+#include <string>
+#include <vector>
+#include <memory>
+#include <fstream>
+#include <filesystem>
+#include <unistd.h>
+
+#include "test.hpp"
+#include "ast/ast.hpp"
+#include "ast/parse.hpp"
+#include "analyze/astqueries.hpp"
+#include "graph/graph.hpp"
+#include "graph/graphcache.hpp"
+#include "module/module.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+static const char* source = R"(
+function first(a) {
+    return a + 1;
+}
+
+function second(b) {
+    if (b)
+        return first(b);
+    return 0;
+}
+
+function third(c) {
+    let total = 0;
+    for (let i = 0; i < c; ++i)
+        total += second(i);
+    return total;
+}
+)";
+
+TEST_CASE("Graph cache evicts idle graphs and keeps held ones", "[graph]")
+{
+    auto path = fs::temp_directory_path() / ("jsre_graphcache_test_" + to_string(getpid()) + ".js");
+    ofstream(path, ios::binary) << source;
+    startParsingThreads();
+    Module module(getIsolateWrapper(), path);
+    stopParsingThreads();
+    fs::remove(path);
+
+    vector<AstNode*> funs = findFunctionNodes(module.getAst());
+    REQUIRE(funs.size() == 3);
+    auto& firstFun = (Function&)*funs[0];
+    auto& secondFun = (Function&)*funs[1];
+    auto& thirdFun = (Function&)*funs[2];
+    CachedGraph first, second, third;
+    const GraphCacheStats& stats = getGraphCacheStatistics();
+
+    // Every graph is over this budget, so each new graph evicts all the idle ones
+    setGraphCacheBudget(1);
+    struct BudgetReset {
+        ~BudgetReset() { setGraphCacheBudget(0); }
+    } budgetReset;
+
+    shared_ptr<Graph> heldGraph = first.get(firstFun);
+    REQUIRE(heldGraph);
+    REQUIRE(second.get(secondFun));
+    REQUIRE(third.get(thirdFun));
+
+    // The second graph was idle, so building the third evicted it, and asking for it again rebuilds it
+    uint64_t rebuilds = stats.rebuilds;
+    REQUIRE(second.get(secondFun));
+    CHECK(stats.rebuilds == rebuilds + 1);
+
+    // The first graph is held, so it was never evicted
+    rebuilds = stats.rebuilds;
+    CHECK(first.get(firstFun) == heldGraph);
+    CHECK(stats.rebuilds == rebuilds);
+
+    // Once released, it can be evicted like the others
+    heldGraph.reset();
+    REQUIRE(third.get(thirdFun)); // Rebuilt, which evicts the first graph
+    rebuilds = stats.rebuilds;
+    REQUIRE(first.get(firstFun));
+    CHECK(stats.rebuilds == rebuilds + 1);
+}
@@ -0,0 +1,134 @@
+#include <catch.hpp>
+#include <vector>
+#include <cstdint>
+
+#include "graph/graph.hpp"
+
+using namespace std;
+
+// The edges we expect in each section of a node, in order
+struct ExpectedEdges {
+    vector<GraphNodeIndex> inputs;
+    vector<GraphNodeIndex> prevs;
+    vector<GraphNodeIndex> nexts;
+
+    void addInput(GraphNode& node, GraphNodeIndex n) { node.addInput(n); inputs.push_back(n); }
+    void addPrev(GraphNode& node, GraphNodeIndex n) { node.addPrev(n); prevs.push_back(n); }
+    void addNext(GraphNode& node, GraphNodeIndex n) { node.addNext(n); nexts.push_back(n); }
+
+    void check(const GraphNode& node) const
+    {
+        REQUIRE(node.inputCount() == inputs.size());
+        REQUIRE(node.prevCount() == prevs.size());
+        REQUIRE(node.nextCount() == nexts.size());
+        for (size_t i = 0; i < inputs.size(); ++i)
+            REQUIRE(node.getInput(i) == inputs[i]);
+        for (size_t i = 0; i < prevs.size(); ++i)
+            REQUIRE(node.getPrev(i) == prevs[i]);
+        for (size_t i = 0; i < nexts.size(); ++i)
+            REQUIRE(node.getNext(i) == nexts[i]);
+    }
+};
+
+static constexpr GraphNodeIndex wideIndex = 100000; //< Doesn't fit in 16 bits
+
+TEST_CASE("GraphNode edges move to the heap past 8 edges", "[graph]")
+{
+    GraphNode node(GraphNodeType::Start);
+    ExpectedEdges expected;
+    for (GraphNodeIndex i = 1; i <= 2; ++i) {
+        expected.addNext(node, 30 + i);
+        expected.addInput(node, 10 + i);
+        expected.addPrev(node, 20 + i);
+        expected.check(node);
+    }
+    expected.addInput(node, 13);
+    expected.addNext(node, 33);
+    expected.check(node);
+    CHECK(node.heapMemoryUsage() == 0);
+
+    expected.addPrev(node, 23);
+    expected.check(node);
+    CHECK(node.heapMemoryUsage() > 0);
+
+    for (GraphNodeIndex i = 0; i < 100; ++i) {
+        expected.addInput(node, 1000 + i);
+        expected.addNext(node, 2000 + i);
+    }
+    expected.check(node);
+}
+
+TEST_CASE("GraphNode edges widen for large indices while inline", "[graph]")
+{
+    GraphNode node(GraphNodeType::Start);
+    ExpectedEdges expected;
+    expected.addInput(node, 1);
+    expected.addPrev(node, 2);
+    expected.addNext(node, 3);
+    REQUIRE(node.heapMemoryUsage() == 0);
+
+    expected.addPrev(node, wideIndex);
+    expected.check(node);
+    CHECK(node.heapMemoryUsage() > 0);
+
+    expected.addInput(node, wideIndex + 1);
+    expected.addNext(node, 4);
+    expected.check(node);
+}
+
+TEST_CASE("GraphNode edges widen for large indices while on the heap", "[graph]")
+{
+    GraphNode node(GraphNodeType::Start);
+    ExpectedEdges expected;
+    for (GraphNodeIndex i = 0; i < 10; ++i) {
+        expected.addInput(node, i);
+        expected.addPrev(node, 100 + i);
+        expected.addNext(node, 200 + i);
+    }
+    size_t narrowUsage = node.heapMemoryUsage();
+    REQUIRE(narrowUsage > 0);
+
+    expected.addInput(node, wideIndex);
+    expected.check(node);
+    CHECK(node.heapMemoryUsage() > narrowUsage);
+
+    // Existing edges can be replaced by wide indices too
+    node.setPrev(3, wideIndex + 1);
+    expected.prevs[3] = wideIndex + 1;
+    node.setNext(9, wideIndex + 2);
+    expected.nexts[9] = wideIndex + 2;
+    expected.check(node);
+
+    GraphNode movedNode(move(node));
+    expected.check(movedNode);
+    CHECK(node.inputCount() == 0);
+}
+
+TEST_CASE("GraphNode setting a large index on narrow edges widens them", "[graph]")
+{
+    GraphNode node(GraphNodeType::Start);
+    ExpectedEdges expected;
+    expected.addInput(node, 1);
+    expected.addPrev(node, 2);
+    expected.addNext(node, 3);
+
+    node.setNext(0, wideIndex);
+    expected.nexts[0] = wideIndex;
+    expected.check(node);
+
+    node.replacePrev(2, wideIndex + 1);
+    expected.prevs[0] = wideIndex + 1;
+    expected.check(node);
+}
+
+TEST_CASE("GraphNode can have more than 65535 edges", "[graph]")
+{
+    GraphNode node(GraphNodeType::Start);
+    ExpectedEdges expected;
+    expected.addPrev(node, 1);
+    expected.addNext(node, 2);
+    for (GraphNodeIndex i = 0; i < 70000; ++i)
+        expected.addInput(node, i % 1000);
+    expected.addPrev(node, 3);
+    expected.check(node);
+}
@@ -0,0 +1,69 @@
+#include <catch.hpp>
+#include <string>
+#include <fstream>
+#include <filesystem>
+#include <unistd.h>
+
+#include "module/manifest.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Writes the manifest to its own directory, since manifests are cached by path
+static const PackageManifest& parseManifest(const string& name, const string& contents)
+{
+    auto dir = fs::temp_directory_path() / ("jsre_manifest_test_" + to_string(getpid())) / name;
+    fs::create_directories(dir);
+    auto path = dir / "package.json";
+    ofstream(path, ios::binary) << contents;
+    struct Cleanup {
+        fs::path dir;
+        ~Cleanup() { error_code ec; fs::remove_all(dir, ec); }
+    } cleanup{dir.parent_path()};
+    return getPackageManifest(path);
+}
+
+TEST_CASE("Manifest fields are found after nested objects and arrays", "[manifest]")
+{
+    auto& manifest = parseManifest("nested", R"({
+        "name": "pkg",
+        "files": ["lib", {"main": "files.js"}, [["module"]]],
+        "exports": {".": {"main": "exports.js", "module": "exports.mjs"}},
+        "main": "lib/index.js"
+    })");
+    CHECK(manifest.main == "lib/index.js");
+    CHECK(manifest.module.empty());
+}
+
+TEST_CASE("Manifest non-string main is ignored", "[manifest]")
+{
+    auto& manifest = parseManifest("nonstring", R"({
+        "main": {"module": "inner.mjs"},
+        "module": ["array.mjs"],
+        "version": 1
+    })");
+    CHECK(manifest.main.empty());
+    CHECK(manifest.module.empty());
+
+    auto& numberManifest = parseManifest("number", R"({"main": 42, "module": "index.mjs"})");
+    CHECK(numberManifest.main.empty());
+    CHECK(numberManifest.module == "index.mjs");
+}
+
+TEST_CASE("Manifest missing main is left empty", "[manifest]")
+{
+    auto& manifest = parseManifest("missing", R"({"name": "pkg", "module": "index.mjs", "dependencies": {}})");
+    CHECK(manifest.main.empty());
+    CHECK(manifest.module == "index.mjs");
+}
+
+TEST_CASE("Manifest parsing stops once main and module are found", "[manifest]")
+{
+    // Anything after both fields is never parsed, so it doesn't matter that it's not valid JSON
+    auto& manifest = parseManifest("earlystop", R"({"module": "index.mjs", "main": "index.js", "main": "ignored.js", })");
+    CHECK(manifest.main == "index.js");
+    CHECK(manifest.module == "index.mjs");
+
+    // The same error before both fields are found fails the whole parse
+    CHECK_THROWS(parseManifest("invalid", R"({"main": "index.js", })"));
+}
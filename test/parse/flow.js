@@ -0,0 +1,44 @@
+// @flow
+import type { Type } from './types';
+import { type Other, value } from './types';
+
+type Alias<T: Object = {}> = {| +key: T, -opt?: ?string |};
+type Callback = (error: ?Error, ...results: Array<number>) => void;
+type Union = | 'a' | 'b' | 42;
+type Shorthand = string => number;
+type Indexed = { [key: string]: number, method(x: number): string };
+type Generic = Map<string, Array<Set<number>>>;
+
+interface Shape extends Base<string> {
+    area(): number;
+}
+
+declare class Declared<T> extends Base mixins Mixin {
+    static create(): Declared<T>;
+    prop: T;
+}
+declare function declared<T>(x: T, y: number): T;
+declare var declaredVar: number;
+declare type DeclaredType = [string, number];
+declare module 'module' {
+    declare var exported: number;
+}
+declare export function exportedDeclaration(): void;
+
+export type { Alias };
+export interface ExportedInterface {}
+
+function annotated<T>(x: T, { y }: { y: number }, [z]: Array<T>, ...rest: Array<T>): Promise<T> {
+    const casted = ((x: any): string);
+    return Promise.resolve(x);
+}
+
+class Typed<T> extends Base<T> implements Shape {
+    prop: number = 1;
+    method(): Typed<T> { return this; }
+}
+
+const arrowWithReturn = (x: number): number => x;
+const conditional = a ? (b) : c;
+const genericArrow = <T>(x: T): T => x;
+const nested: (x: number) => (y: number) => number = x => y => x + y;
@@ -0,0 +1,71 @@
+'use strict';
+// Covers the plain ES2018 syntax the native parser must import exactly like Babel
+import def, { named as renamed, other } from './other';
+import * as everything from "./everything";
+
+const answer = 42, hex = 0x2A, str = 'a\'b\u{1F600}';
+let [first, , ...rest] = [1, 2, 3];
+var { a, b: { c = 1 }, ...others } = { a: 1, b: { c: 2 }, d: 3 };
+
+/* Block comment */
+function* generator(x = 1, { y }, ...z) {
+    yield x;
+    yield* z;
+}
+
+async function asyncFunction(value) {
+    for await (const item of value)
+        await item;
+    return (value, answer);
+}
+
+class Base {}
+class Derived extends Base {
+    static count = 0;
+    constructor(value) {
+        super();
+        this.value = value;
+    }
+    get doubled() { return this.value * 2; }
+    async *[Symbol.iterator]() {}
+}
+
+const arrow = (p, q) => p ** q ** 2;
+const concise = async x => ({ x });
+const object = { arrow, method() {}, get prop() { return 1; }, ['computed' + 1]: 2, ...others };
+const template = `line ${answer + 1} and ${`nested ${str}`}`;
+const tagged = String.raw`\n`;
+const regex = /[/\]]+/gi.test(str) ? a / 2 / hex : !a && (b || c);
+
+label: for (let i = 0; i < 10; i++) {
+    if (i % 2)
+        continue label;
+    else
+        break;
+}
+
+for (const key in object) {}
+[a, others.d] = [others.d, a];
+({ a } = object);
+
+switch (typeof a) {
+case 'number':
+    a += 1;
+    // falls through
+default:
+    a = void 0;
+}
+
+try {
+    throw new Error('oops');
+} catch ({ message }) {
+    new Derived;
+} finally {
+    delete object.arrow;
+}
+
+do a--; while (a > 0)
+export default class {}
+export { first as firstElement, rest };
+export * from './reexported';
+export const exported = function named() { return new.target; };
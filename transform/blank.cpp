@@ -1,27 +1,24 @@
 #include "blank.hpp"
 #include "ast/ast.hpp"
-#include "utf8/utf8.h"
 #include <cassert>
-#include <cstring>
 
 void blankNodeFromSource(std::string &source, AstNode &node)
 {
     auto loc = node.getLocation();
-    assert(loc.start.offset <= loc.end.offset);
-    assert(loc.end.offset < source.size());
+    assert(loc.start <= loc.end);
+    assert(loc.end <= source.size());
 
-    blankRange(source, loc.start.offset, loc.end.offset - loc.start.offset);
+    blankRange(source, loc.start, loc.end - loc.start);
 }
 
 void blankNextComma(std::string &source, AstNode &node)
 {
-    blankNextComma(source, node.getLocation().end.offset);
+    blankNextComma(source, node.getLocation().end);
 }
 
 void blankNextComma(std::string &source, size_t position)
 {
-    char* ptr = source.data();
-    utf8::unchecked::advance(ptr, position);
+    char* ptr = source.data() + position;
     while (isspace(*ptr))
         ptr++;
     if (*ptr == ',')
@@ -30,39 +27,29 @@ void blankNextComma(std::string &source, size_t position)
 
 void blankRange(std::string &source, size_t position, size_t count)
 {
-    char* beg_ptr = source.data();
-    utf8::unchecked::advance(beg_ptr, position);
-    char* end_ptr = beg_ptr;
-    utf8::unchecked::advance(end_ptr, count);
-
-    size_t bytes_start_pos = static_cast<size_t>(beg_ptr-source.data());
-    size_t bytes_count = static_cast<size_t>(end_ptr - beg_ptr);
-    size_t extra_bytes = bytes_count - count;
-
-    source.erase(bytes_start_pos, extra_bytes);
-    memset(beg_ptr, ' ', count);
+    // Line breaks are kept, so that lines and columns in the blanked source still match the original
+    char* end = source.data() + position + count;
+    for (char* ptr = source.data() + position; ptr < end; ++ptr) {
+        if (*ptr == '\n' || *ptr == '\r')
+            continue;
+        if (*ptr == '\xE2' && end - ptr >= 3 && ptr[1] == '\x80' && (ptr[2] == '\xA8' || ptr[2] == '\xA9')) {
+            ptr += 2; // U+2028 and U+2029 are line breaks too
+            continue;
+        }
+        *ptr = ' ';
+    }
 }
 
 void blankNext(std::string &source, size_t start, char byte)
 {
-    char* ptr = source.data();
-    utf8::unchecked::advance(ptr, start);
-
-    while (*ptr != byte)
-        utf8::unchecked::next(ptr);
-    *ptr = ' ';
+    size_t pos = source.find(byte, start);
+    assert(pos != std::string::npos);
+    source[pos] = ' ';
 }
 
 void blankUntil(std::string &source, size_t start, char byte)
 {
-    char* ptr = source.data();
-    utf8::unchecked::advance(ptr, start);
-
-    size_t char_count = 0;
-    while (*ptr != byte) {
-        utf8::unchecked::next(ptr);
-        char_count++;
-    }
-
-    blankRange(source, start, char_count);
+    size_t end = source.find(byte, start);
+    assert(end != std::string::npos);
+    blankRange(source, start, end - start);
 }
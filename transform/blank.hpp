@@ -5,8 +5,8 @@
 
 class AstNode;
 
-// Functions in this file preserve the AST offset locations
-// (counted in UTF8 characters), but not the line numbers
+// Functions in this file preserve the AST byte offsets and line numbers,
+// blanked characters are replaced by as many spaces as they had bytes, except line breaks which are kept
 
 // Replaces an entire AST node with spaces in the source code.
 void blankNodeFromSource(std::string& source, AstNode& node);
@@ -17,7 +17,7 @@ void blankNextComma(std::string& source, AstNode& node);
 // If the next non-whitespace character is a ',' we blank it
 void blankNextComma(std::string& source, size_t position);
 
-// Replaces the entire range with spaces
+// Replaces the entire range with spaces, except for line breaks
 void blankRange(std::string& source, size_t position, size_t count);
 
 // Replaces the next occurence of this byte with a space
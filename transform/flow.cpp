@@ -50,12 +50,12 @@ std::string stripFlowTypes(const std::string &source, AstNode &ast)
 
     walkAst(ast, [&](AstNode& node){
         if (isOptionalIdentifier(node)) {
-            blankNext(transformed, node.getLocation().start.offset, '?'); // Optional identifiers have a trailing '?'
+            blankNext(transformed, node.getLocation().start, '?'); // Optional identifiers have a trailing '?'
         } else if (isTypeImportSpecifier(node)) {
             blankNodeFromSource(transformed, node);
             blankNextComma(transformed, node); // The ',' following the specifier needs to be removed, if any
         } else if (isClassWithImplements(node)) {
-            size_t startPos = ((ClassDeclaration&)node).getId()->getLocation().end.offset;
+            size_t startPos = ((ClassDeclaration&)node).getId()->getLocation().end;
             blankUntil(transformed, startPos, '{');
         } else if (isTypeAnnotation(node)
                    || isTypeAliasOrInterface(node)
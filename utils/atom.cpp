@@ -0,0 +1,75 @@
+#include "atom.hpp"
+#include <unordered_map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <cassert>
+#include <stdexcept>
+
+using namespace std;
+
+// Strings live in fixed-size segments that never move, so str() doesn't need a lock.
+// Someone can only hold an atom's ID after interning synchronized with the thread that created it.
+static constexpr size_t segmentBits = 14;
+static constexpr size_t segmentSize = 1 << segmentBits;
+static constexpr size_t maxSegments = 1 << 14;
+static constexpr size_t shardsCount = 64; //< Interning locks one shard, picked by hash
+
+struct AtomShard
+{
+    mutex shardMutex;
+    unordered_map<string_view, uint32_t> atoms; //< Keys point into the segments
+};
+
+static atomic<string*> segments[maxSegments];
+static atomic_uint32_t nextAtomId{1}; //< 0 is the empty string
+static AtomShard shards[shardsCount];
+
+static string& atomSlot(uint32_t id)
+{
+    auto segmentIndex = id >> segmentBits;
+    assert(segmentIndex < maxSegments);
+    string* segment = segments[segmentIndex].load(memory_order_acquire);
+    if (!segment) {
+        auto newSegment = make_unique<string[]>(segmentSize);
+        if (segments[segmentIndex].compare_exchange_strong(segment, newSegment.get(), memory_order_acq_rel))
+            segment = newSegment.release();
+    }
+    return segment[id & (segmentSize - 1)];
+}
+
+Atom::Atom()
+    : atomId{0}
+{
+}
+
+Atom::Atom(string_view str)
+{
+    if (str.empty()) {
+        atomId = 0;
+        return;
+    }
+
+    size_t hash = std::hash<string_view>{}(str);
+    AtomShard& shard = shards[hash % shardsCount];
+    lock_guard lock(shard.shardMutex);
+    if (auto it = shard.atoms.find(str); it != shard.atoms.end()) {
+        atomId = it->second;
+        return;
+    }
+
+    atomId = nextAtomId++;
+    if ((atomId >> segmentBits) >= maxSegments)
+        throw runtime_error("Too many distinct atoms");
+    string& slot = atomSlot(atomId);
+    slot = str;
+    shard.atoms.emplace(slot, atomId);
+}
+
+const string& Atom::str() const
+{
+    static const string emptyString;
+    if (atomId == 0)
+        return emptyString;
+    return segments[atomId >> segmentBits].load(memory_order_acquire)[atomId & (segmentSize - 1)];
+}
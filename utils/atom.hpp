@@ -0,0 +1,37 @@
+#ifndef ATOM_HPP
+#define ATOM_HPP
+
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <functional>
+
+// Interned string, as cheap to copy, hash and compare as an integer.
+// Equal strings always give the same atom, in every module and thread. Atoms are never freed.
+class Atom
+{
+public:
+    Atom(); //< The empty string
+    Atom(std::string_view str);
+    Atom(const std::string& str) : Atom(std::string_view{str}) {}
+    Atom(const char* str) : Atom(std::string_view{str}) {}
+
+    uint32_t id() const { return atomId; }
+    const std::string& str() const;
+    operator const std::string&() const { return str(); }
+    bool empty() const { return atomId == 0; }
+
+    bool operator==(Atom other) const { return atomId == other.atomId; }
+    bool operator!=(Atom other) const { return atomId != other.atomId; }
+
+private:
+    uint32_t atomId;
+};
+
+namespace std {
+template <> struct hash<Atom> {
+    size_t operator()(Atom atom) const { return atom.id(); }
+};
+}
+
+#endif // ATOM_HPP
@@ -0,0 +1,89 @@
+#ifndef CONCURRENTMAP_HPP
+#define CONCURRENTMAP_HPP
+
+#include <unordered_map>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <functional>
+#include <cstdint>
+
+// Map of values constructed at most once per key, even when many threads ask for the same key at the same time.
+// Lookups and insertions only lock one shard, picked by hash. Values never move and are never removed.
+template <class Key, class Value, class Hash = std::hash<Key>>
+class ConcurrentMap
+{
+public:
+    ConcurrentMap() = default;
+    ConcurrentMap(const ConcurrentMap& other) = delete;
+
+    // Returns nullptr if there is no value for this key yet, or if it is still being constructed
+    Value* find(const Key& key)
+    {
+        Shard& shard = shardFor(key);
+        std::lock_guard lock(shard.shardMutex);
+        auto it = shard.entries.find(key);
+        if (it == shard.entries.end() || !it->second.ready.load(std::memory_order_acquire))
+            return nullptr;
+        return it->second.value.get();
+    }
+
+    // Calls construct() to make the value if there is none yet, other threads asking for this key wait for it.
+    // If construct() throws, the exception is propagated and the next caller tries again.
+    template <class F>
+    Value& getOrCreate(const Key& key, F&& construct)
+    {
+        Entry* entry;
+        {
+            Shard& shard = shardFor(key);
+            std::lock_guard lock(shard.shardMutex);
+            entry = &shard.entries.try_emplace(key).first->second;
+        }
+        if (!entry->ready.load(std::memory_order_acquire)) {
+            std::call_once(entry->constructFlag, [&] {
+                entry->value = construct();
+                entry->ready.store(true, std::memory_order_release);
+            });
+        }
+        return *entry->value;
+    }
+
+    // Calls cb(key, value) for the values constructed so far, in no particular order
+    template <class F>
+    void forEach(F&& cb)
+    {
+        for (Shard& shard : shards) {
+            std::lock_guard lock(shard.shardMutex);
+            for (auto& [key, entry] : shard.entries)
+                if (entry.ready.load(std::memory_order_acquire))
+                    cb(key, *entry.value);
+        }
+    }
+
+private:
+    struct Entry {
+        std::once_flag constructFlag;
+        std::atomic_bool ready{false};
+        std::unique_ptr<Value> value;
+    };
+
+    struct Shard {
+        std::mutex shardMutex;
+        std::unordered_map<Key, Entry, Hash> entries; //< Nodes don't move on rehash, so entries can be used unlocked
+    };
+
+    static constexpr unsigned shardBits = 6;
+    static constexpr size_t shardsCount = 1 << shardBits;
+
+    // std::hash of a pointer or integer is the identity, and aligned pointers would all land in a few shards.
+    // Multiplying by 2^64/phi mixes every bit of the hash into the top bits, which pick the shard.
+    Shard& shardFor(const Key& key)
+    {
+        uint64_t hash = static_cast<uint64_t>(Hash{}(key)) * 0x9E3779B97F4A7C15ull;
+        return shards[hash >> (64 - shardBits)];
+    }
+
+    Shard shards[shardsCount];
+};
+
+#endif // CONCURRENTMAP_HPP
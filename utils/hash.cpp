@@ -18,3 +18,22 @@ void GenericHash::final(uint8_t* hash)
 {
     crypto_generichash_final(&state, hash, hashsize);
 }
+
+void stableHash(const void* data, size_t size, uint8_t* hash)
+{
+    crypto_generichash(hash, stableHashSize, (const uint8_t*)data, size, nullptr, 0);
+}
+
+std::string stableHashHex(const void* data, size_t size)
+{
+    uint8_t hash[stableHashSize];
+    stableHash(data, size, hash);
+
+    static const char hexDigits[] = "0123456789abcdef";
+    std::string hex;
+    for (uint8_t byte : hash) {
+        hex += hexDigits[byte >> 4];
+        hex += hexDigits[byte & 0xF];
+    }
+    return hex;
+}
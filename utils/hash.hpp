@@ -2,6 +2,7 @@
 #define HASH_HPP
 
 #include <sodium/crypto_generichash.h>
+#include <string>
 
 class GenericHash
 {
@@ -17,4 +18,9 @@ private:
     crypto_generichash_state state;
 };
 
+// Unlike GenericHash this is unkeyed, so the result is stable across runs and can be persisted
+constexpr size_t stableHashSize = 16;
+void stableHash(const void* data, size_t size, uint8_t hash[stableHashSize]);
+std::string stableHashHex(const void* data, size_t size); //< For cache file names
+
 #endif // HASH_HPP
@@ -11,6 +11,12 @@ static bool debugEnabled = false;
 static bool suggestEnabled = false;
 
 static ReportingStats globalStats;
+static thread_local ostream* reportStream = nullptr; //< The current thread's BufferedReports, if any
+
+static ostream& out()
+{
+    return reportStream ? *reportStream : cout;
+}
 
 void setDebug(bool enable)
 {
@@ -26,15 +32,15 @@ static void printLocation(const AstNode& node)
 {
     Module& mod = node.getParentModule();
     string relativePath = filesystem::relative(mod.getPath());
-    auto loc = node.getLocation().start;
-    cout << relativePath << ':' << loc.line << ':' <<loc.column << ": ";
+    auto loc = node.getStartPosition();
+    out() << relativePath << ':' << loc.line << ':' <<loc.column << ": ";
 }
 
 void trace(const string &msg)
 {
     if (!debugEnabled)
         return;
-    cout << "debug: " << msg << endl;
+    out() << "debug: " << msg << endl;
     globalStats.traces++;
 }
 
@@ -51,7 +57,7 @@ void suggest(const string &msg)
     globalStats.suggestions++;
     if (!suggestEnabled)
         return;
-    cout << "suggest: " << msg << endl;
+    out() << "suggest: " << msg << endl;
 }
 
 void suggest(const AstNode &node, const string &msg)
@@ -64,7 +70,7 @@ void suggest(const AstNode &node, const string &msg)
 void warn(const std::string &msg)
 {
     globalStats.warnings++;
-    cout << "warning: " << msg << endl;
+    out() << "warning: " << msg << endl;
 }
 
 void warn(const AstNode &node, const string &msg)
@@ -76,7 +82,7 @@ void warn(const AstNode &node, const string &msg)
 void error(const string &msg)
 {
     globalStats.errors++;
-    cout << "error: " << msg << endl;
+    out() << "error: " << msg << endl;
 }
 
 void error(const AstNode &node, const string &msg)
@@ -85,6 +91,11 @@ void error(const AstNode &node, const string &msg)
     error(msg);
 }
 
+void printReports(const string &reports)
+{
+    out() << reports << flush;
+}
+
 void fatal(const string &msg)
 {
     cout << "Error: " << msg << endl;
@@ -93,6 +104,7 @@ void fatal(const string &msg)
 
 void fatal(const AstNode &node, const string &msg)
 {
+    reportStream = nullptr; // Don't lose the last words in a buffer
     printLocation(node);
     fatal(msg);
 }
@@ -109,3 +121,21 @@ void resetReportingStatistics()
     globalStats.suggestions = 0;
     globalStats.traces = 0;
 }
+
+BufferedReports::BufferedReports()
+    : previous{reportStream}
+{
+    reportStream = &buffer;
+}
+
+BufferedReports::~BufferedReports()
+{
+    reportStream = previous;
+}
+
+string BufferedReports::take()
+{
+    string reports = buffer.str();
+    buffer.str({});
+    return reports;
+}
@@ -2,6 +2,7 @@
 #define REPORTING_HPP
 
 #include <string>
+#include <sstream>
 #include <atomic>
 
 class AstNode;
@@ -30,9 +31,24 @@ void warn(const std::string& msg); //< Reports a real problem with your code.
 void warn(const AstNode& node, const std::string& msg); //< Reports a real problem with your code.
 void error(const std::string& msg); //< Reports a bug in your code.
 void error(const AstNode& node, const std::string& msg); //< Reports a bug in your code.
+void printReports(const std::string& reports); //< Prints reports taken from a BufferedReports, they were already counted.
 [[noreturn]]
 void fatal(const std::string& msg); //< Reports a fatal error. This will exit!
 [[noreturn]]
 void fatal(const AstNode& node, const std::string& msg); //< Reports a fatal error. This will exit!
 
+// While alive, reports from the current thread are kept here instead of being printed.
+// Parallel analyses print them afterwards, so the output doesn't depend on scheduling.
+class BufferedReports {
+public:
+    BufferedReports();
+    BufferedReports(const BufferedReports& other) = delete;
+    ~BufferedReports();
+    std::string take();
+
+private:
+    std::ostringstream buffer;
+    std::ostream* previous;
+};
+
 #endif // REPORTING_HPP
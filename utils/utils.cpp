@@ -1,7 +1,17 @@
 #include "utils.hpp"
 #include <fstream>
 #include <filesystem>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <sched.h>
 #include <v8.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 
 using namespace std;
 namespace fs = std::filesystem;
@@ -33,18 +43,33 @@ static fs::path getCacheDirectory()
 
 bool tryWriteCacheFile(const char *name, const std::vector<uint8_t> &data)
 {
-    auto dir = getCacheDirectory();
-    fs::create_directories(dir);
-    ofstream file(dir / name, ios::binary);
-    if (!file.is_open())
+    auto path = getCacheDirectory() / name;
+    error_code ec;
+    fs::create_directories(path.parent_path(), ec);
+
+    // Write to a temporary file first, so that concurrent readers never see a partially written file
+    auto tmpPath = path;
+    tmpPath += ".tmp" + to_string(getpid()) + "_" + to_string(hash<thread::id>()(this_thread::get_id()));
+    {
+        ofstream file(tmpPath, ios::binary);
+        if (!file.is_open())
+            return false;
+        file.write((const char*)data.data(), static_cast<ssize_t>(data.size()));
+        if (!file)
+            return false;
+    }
+    fs::rename(tmpPath, path, ec);
+    if (ec) {
+        fs::remove(tmpPath, ec);
         return false;
-    file.write((const char*)data.data(), static_cast<ssize_t>(data.size()));
+    }
     return true;
 }
 
 bool tryRemoveCacheFile(const char *name)
 {
-    return fs::remove(getCacheDirectory() / name);
+    error_code ec; // Called from parse workers, which must not throw on an I/O error
+    return fs::remove(getCacheDirectory() / name, ec);
 }
 
 optional<vector<uint8_t>> tryReadCacheFile(const char *name)
@@ -61,6 +86,42 @@ optional<vector<uint8_t>> tryReadCacheFile(const char *name)
     return data;
 }
 
+optional<MappedFile> tryMapCacheFile(const char *name)
+{
+    auto path = getCacheDirectory() / name;
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return nullopt;
+
+    struct stat st;
+    void* mapping = MAP_FAILED;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+        mapping = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // The mapping stays valid after closing
+    if (mapping == MAP_FAILED)
+        return nullopt;
+    return MappedFile((const uint8_t*)mapping, static_cast<size_t>(st.st_size));
+}
+
+MappedFile::MappedFile(const uint8_t *mapping, size_t size)
+    : mapping{mapping}
+    , mappingSize{size}
+{
+}
+
+MappedFile::MappedFile(MappedFile &&other)
+    : mapping{other.mapping}
+    , mappingSize{other.mappingSize}
+{
+    other.mapping = nullptr;
+}
+
+MappedFile::~MappedFile()
+{
+    if (mapping)
+        munmap(const_cast<uint8_t*>(mapping), mappingSize);
+}
+
 std::string readFileStr(const char* path)
 {
     std::string str;
@@ -76,6 +137,84 @@ std::string readFileStr(const char* path)
     return str;
 }
 
+// Returns nullopt if the file is missing or doesn't start with a number (e.g. the "max" of an unlimited cgroup)
+static optional<int64_t> readIntFile(const char* path)
+{
+    ifstream file(path);
+    int64_t value;
+    if (!(file >> value))
+        return nullopt;
+    return value;
+}
+
+// Like readIntFile, but negative numbers are nullopt too. Streams would happily wrap them into huge uints.
+static optional<uint64_t> readUintFile(const char* path)
+{
+    auto value = readIntFile(path);
+    if (!value || *value < 0)
+        return nullopt;
+    return static_cast<uint64_t>(*value);
+}
+
+static optional<double> cgroupCpuQuota()
+{
+    // cgroup v2: "<quota> <period>" or "max <period>"
+    ifstream cpuMax("/sys/fs/cgroup/cpu.max");
+    string quota;
+    uint64_t period;
+    if (cpuMax >> quota >> period) {
+        // Anything that isn't a positive number, "max" included, means no quota
+        char* end;
+        double quotaValue = strtod(quota.c_str(), &end);
+        if (*end || !(quotaValue > 0) || period == 0)
+            return nullopt;
+        return quotaValue / period;
+    }
+
+    // cgroup v1: a quota of -1 means unlimited
+    auto v1Quota = readIntFile("/sys/fs/cgroup/cpu/cpu.cfs_quota_us");
+    auto v1Period = readIntFile("/sys/fs/cgroup/cpu/cpu.cfs_period_us");
+    if (v1Quota && *v1Quota > 0 && v1Period && *v1Period > 0)
+        return static_cast<double>(*v1Quota) / *v1Period;
+    return nullopt;
+}
+
+unsigned availableCpuCount()
+{
+    unsigned count = thread::hardware_concurrency();
+    cpu_set_t cpuSet;
+    if (sched_getaffinity(0, sizeof(cpuSet), &cpuSet) == 0)
+        count = static_cast<unsigned>(CPU_COUNT(&cpuSet));
+    if (auto quota = cgroupCpuQuota())
+        count = static_cast<unsigned>(min<double>(count, ceil(*quota))); // Clamped before the cast, quotas can be huge
+    return max(count, 1U);
+}
+
+uint64_t availableMemoryBytes()
+{
+    uint64_t available = numeric_limits<uint64_t>::max();
+    ifstream meminfo("/proc/meminfo");
+    for (string key; meminfo >> key;) {
+        uint64_t kb;
+        if (key == "MemAvailable:" && meminfo >> kb) {
+            available = kb * 1024;
+            break;
+        }
+        meminfo.ignore(numeric_limits<streamsize>::max(), '\n');
+    }
+
+    // The limit files read "max" when unlimited (v2), or a huge page-aligned number (v1)
+    auto limit = readUintFile("/sys/fs/cgroup/memory.max");
+    auto usage = readUintFile("/sys/fs/cgroup/memory.current");
+    if (!limit) {
+        limit = readUintFile("/sys/fs/cgroup/memory/memory.limit_in_bytes");
+        usage = readUintFile("/sys/fs/cgroup/memory/memory.usage_in_bytes");
+    }
+    if (limit)
+        available = min(available, *limit - min(*limit, usage.value_or(0)));
+    return available;
+}
+
 void findSourceFiles(const fs::path& base, vector<fs::path>& results)
 {
     if(!fs::exists(base) || !fs::is_directory(base))
@@ -11,10 +11,34 @@ class Isolate;
 class TryCatch;
 }
 
+// Read-only view of a file mapped in memory, unmapped on destruction
+class MappedFile
+{
+public:
+    MappedFile(MappedFile&& other);
+    MappedFile(const MappedFile& other) = delete;
+    ~MappedFile();
+    const uint8_t* data() const { return mapping; }
+    size_t size() const { return mappingSize; }
+
+private:
+    MappedFile(const uint8_t* mapping, size_t size);
+    friend std::optional<MappedFile> tryMapCacheFile(const char* name);
+
+private:
+    const uint8_t* mapping;
+    size_t mappingSize;
+};
+
 std::optional<std::vector<uint8_t>> tryReadCacheFile(const char *name);
+std::optional<MappedFile> tryMapCacheFile(const char* name);
 bool tryWriteCacheFile(const char* name, const std::vector<uint8_t>& data);
 bool tryRemoveCacheFile(const char* name);
 std::string readFileStr(const char* path);
+// CPUs we may actually run on, taking the affinity mask and any cgroup CPU quota into account
+unsigned availableCpuCount();
+// Memory we can still allocate, taking any cgroup memory limit into account
+uint64_t availableMemoryBytes();
 void findSourceFiles(const std::filesystem::path& base, std::vector<std::filesystem::path> &results);
 void reportV8Exception(v8::Isolate* isolate, v8::TryCatch* try_catch);
 
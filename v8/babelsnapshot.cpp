@@ -0,0 +1,90 @@
+// Build-time tool: evaluates the Babel bundle in a fresh isolate and writes a V8 startup snapshot of the result.
+// The snapshot is embedded in jsre, so parse workers come up with the babylon global already set up.
+#include "v8/v8.hpp"
+#include <libplatform/libplatform.h>
+#include <fstream>
+#include <iostream>
+
+extern "C" {
+extern const char v8_startup_natives_blob[];
+extern const char v8_startup_natives_blob_end;
+extern const char v8_startup_snapshot_blob[];
+extern const char v8_startup_snapshot_blob_end;
+extern const char babelScriptStart[];
+extern uint32_t babelScriptSize;
+}
+
+using namespace std;
+
+// Runs a small parse so the parser's hot functions are already compiled in the snapshot
+static const char warmupScript[] = R"(
+    babylon.parse("import a from 'a'; export default class A extends a { x = { ...a }; async *f(y: ?number) { for (;;) yield y; } }", {
+        sourceType: "module",
+        plugins: ["objectRestSpread", "classProperties", "exportExtensions", "asyncGenerators", "flow"],
+    });
+)";
+
+static bool runScript(v8::Isolate* isolate, v8::Local<v8::Context> context, const char* source, int sourceSize)
+{
+    v8::TryCatch trycatch(isolate);
+    v8::Local<v8::String> sourceStr = v8::String::NewFromUtf8(isolate, source, v8::NewStringType::kNormal, sourceSize).ToLocalChecked();
+    v8::Local<v8::Script> script;
+    if (v8::Script::Compile(context, sourceStr).ToLocal(&script) && !script->Run(context).IsEmpty())
+        return true;
+
+    v8::String::Utf8Value exception(isolate, trycatch.Exception());
+    cerr << "Error evaluating Babel for the startup snapshot: " << (*exception ? *exception : "<unknown>") << endl;
+    return false;
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc != 2) {
+        cerr << "Usage: " << argv[0] << " <output.bin>" << endl;
+        return EXIT_FAILURE;
+    }
+
+    unique_ptr<v8::Platform> platform = v8::platform::NewDefaultPlatform();
+    v8::V8::SetFlagsFromString(v8Flags, sizeof(v8Flags)-1);
+    v8::V8::InitializePlatform(platform.get());
+    v8::V8::Initialize();
+
+    int v8_startup_natives_blob_size = static_cast<int>(&v8_startup_natives_blob_end - v8_startup_natives_blob);
+    v8::StartupData nativesBlobStartupData{v8_startup_natives_blob, v8_startup_natives_blob_size};
+    v8::V8::SetNativesDataBlob(&nativesBlobStartupData);
+
+    int v8_startup_snapshot_blob_size = static_cast<int>(&v8_startup_snapshot_blob_end - v8_startup_snapshot_blob);
+    v8::StartupData snapshotBlobStartupData{v8_startup_snapshot_blob, v8_startup_snapshot_blob_size};
+
+    v8::StartupData babelSnapshot{nullptr, 0};
+    {
+        v8::SnapshotCreator creator(nullptr, &snapshotBlobStartupData);
+        v8::Isolate* isolate = creator.GetIsolate();
+        {
+            v8::HandleScope handleScope(isolate);
+            v8::Local<v8::Context> context = v8::Context::New(isolate);
+            v8::Context::Scope contextScope(context);
+            if (!runScript(isolate, context, babelScriptStart, static_cast<int>(babelScriptSize))
+                || !runScript(isolate, context, warmupScript, sizeof(warmupScript)-1))
+                return EXIT_FAILURE;
+            creator.SetDefaultContext(context);
+        }
+        babelSnapshot = creator.CreateBlob(v8::SnapshotCreator::FunctionCodeHandling::kKeep);
+    }
+    if (!babelSnapshot.data) {
+        cerr << "Failed to create the Babel startup snapshot" << endl;
+        return EXIT_FAILURE;
+    }
+
+    ofstream output(argv[1], ios::binary);
+    output.write(babelSnapshot.data, babelSnapshot.raw_size);
+    delete[] babelSnapshot.data;
+    if (!output) {
+        cerr << "Failed to write " << argv[1] << endl;
+        return EXIT_FAILURE;
+    }
+
+    v8::V8::Dispose();
+    v8::V8::ShutdownPlatform();
+    return EXIT_SUCCESS;
+}
@@ -6,7 +6,13 @@
 using namespace v8;
 
 IsolateWrapper::IsolateWrapper()
-    : isolate{ Isolate::New(::V8::getInstance().getCreateParams()) }
+    : IsolateWrapper(::V8::getInstance().getCreateParams())
+{
+}
+
+IsolateWrapper::IsolateWrapper(const v8::Isolate::CreateParams& createParams)
+    : isolate{ Isolate::New(createParams) }
+    , locker{ std::make_unique<Locker>(isolate) }
 {
     HandleScope handleScope(isolate);
     Local<Context> localContext = Context::New(isolate);
@@ -20,6 +26,7 @@ IsolateWrapper::~IsolateWrapper()
         HandleScope handleScope(isolate);
         defaultContext.Get(isolate)->Exit();
     }
+    locker.reset();
     isolate->Dispose();
 }
 
@@ -27,3 +34,8 @@ v8::Isolate* IsolateWrapper::get()
 {
     return isolate;
 }
+
+v8::Local<v8::Context> IsolateWrapper::getDefaultContext()
+{
+    return defaultContext.Get(isolate);
+}
@@ -2,18 +2,23 @@
 #define ISOLATEWRAPPER_HPP
 
 #include <v8.h>
+#include <memory>
 
+// The thread creating the isolate keeps it locked, other threads can take a v8::Locker while it is in a v8::Unlocker
 class IsolateWrapper {
 public:
     IsolateWrapper();
+    explicit IsolateWrapper(const v8::Isolate::CreateParams& createParams);
     ~IsolateWrapper();
 
     v8::Isolate* get();
     v8::Isolate* operator*() { return get(); }
+    v8::Local<v8::Context> getDefaultContext(); //< Entered by the thread creating the isolate
 
 private:
     v8::Persistent<v8::Context> defaultContext;
     v8::Isolate* isolate;
+    std::unique_ptr<v8::Locker> locker;
 };
 
 #endif // ISOLATEWRAPPER_HPP
@@ -7,13 +7,14 @@ extern const char v8_startup_natives_blob[];
 extern const char v8_startup_natives_blob_end;
 extern const char v8_startup_snapshot_blob[];
 extern const char v8_startup_snapshot_blob_end;
+extern const char v8_startup_babel_snapshot_blob[];
+extern const char v8_startup_babel_snapshot_blob_end;
 }
 
 V8::V8()
     : platform(v8::platform::NewDefaultPlatform())
 {
-    std::string flags = "--harmony_dynamic_import --harmony_class_fields";
-    v8::V8::SetFlagsFromString(flags.c_str(), flags.length());
+    v8::V8::SetFlagsFromString(v8Flags, sizeof(v8Flags)-1);
     v8::V8::InitializePlatform(platform.get());
     v8::V8::Initialize();
 
@@ -26,6 +27,11 @@ V8::V8()
     v8::V8::SetNativesDataBlob(&nativesBlobStartupData);
 
     create_params.array_buffer_allocator = v8::ArrayBuffer::Allocator::NewDefaultAllocator();
+
+    int v8_startup_babel_snapshot_blob_size = static_cast<int>(&v8_startup_babel_snapshot_blob_end - v8_startup_babel_snapshot_blob);
+    babelSnapshotStartupData = {v8_startup_babel_snapshot_blob, v8_startup_babel_snapshot_blob_size};
+    babel_create_params.array_buffer_allocator = create_params.array_buffer_allocator;
+    babel_create_params.snapshot_blob = &babelSnapshotStartupData;
 }
 
 V8::~V8()
@@ -45,3 +51,8 @@ const v8::Isolate::CreateParams& V8::getCreateParams() const
 {
     return create_params;
 }
+
+const v8::Isolate::CreateParams& V8::getBabelCreateParams() const
+{
+    return babel_create_params;
+}
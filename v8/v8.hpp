@@ -4,12 +4,17 @@
 #include <memory>
 #include <v8.h>
 
+// Snapshots are only valid with the flags they were created with, so the Babel snapshot generator uses these too
+constexpr char v8Flags[] = "--harmony_dynamic_import --harmony_class_fields";
+
 /// This singleton takes care of initializing/cleaning up V8
 class V8
 {
 public:
     static const V8& getInstance();
     const v8::Isolate::CreateParams& getCreateParams() const;
+    /// Isolates created with these params start with Babel already evaluated in their default context
+    const v8::Isolate::CreateParams& getBabelCreateParams() const;
 
 private:
     V8();
@@ -18,6 +23,8 @@ private:
 private:
     std::unique_ptr<v8::Platform> platform;
     v8::Isolate::CreateParams create_params;
+    v8::Isolate::CreateParams babel_create_params;
+    v8::StartupData babelSnapshotStartupData;
 };
 
 #endif // V8_HPP